@@ -0,0 +1,57 @@
+// Balises d'état UDP pour la supervision d'un parc (tools/flotte.py)
+// Chaque appareil diffuse en broadcast sur BALISE_PORT une trame de taille
+// fixe (petit-boutiste), périodiquement et dès qu'un état change ; il
+// répond aussi aux sondes de découverte (un octet BALISE_SONDE, en
+// broadcast ou unicast) par une balise adressée à l'émetteur.
+//
+//  octet  champ          type     unité
+//   0     type           uint8    BALISE_TYPE
+//   1     format         uint8    BALISE_FORMAT
+//   2     id             uint32   identifiant (MAC, voir partageId())
+//   6     sequence       uint16   incrémenté à chaque balise
+//   8     version        3×uint8  majeur, mineur, correctif
+//  11     temp           int16    mesure retenue, 1/100 °C
+//  13     cible          int16    consigne, 1/100 °C
+//  15     etat           uint8    bits TELEMETRIE_* (include/telemetrie.h)
+//  16     rssi           int8     dBm
+//  17     disponibilite  uint32   secondes depuis le démarrage
+//  21     periode        uint16   secondes entre deux balises périodiques
+//  23     crc            uint16   CRC-16/CCITT-FALSE sur les octets 0..22
+// Aucune dépendance Arduino.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "controle.h"
+
+const uint8_t BALISE_TYPE = 2;
+const uint8_t BALISE_SONDE = 3;
+const uint8_t BALISE_FORMAT = 1;
+const size_t BALISE_TAILLE = 25;
+const uint16_t BALISE_PORT = 4210;
+const uint16_t BALISE_PERIODE_DEFAUT_S = 30;
+const uint32_t BALISE_CHANGEMENT_MIN_MS = 1000;  // balises sur changement espacées d'au moins
+const centi_t BALISE_ECART_TEMP = 20;            // 0,2 °C : changement de mesure signalé
+
+struct Balise {
+  uint32_t id;
+  uint16_t sequence;
+  uint8_t version[3];
+  centi_t temp;
+  centi_t cible;
+  uint8_t etat;
+  int8_t rssi;
+  uint32_t disponibilite;
+  uint16_t periode;
+};
+
+// "0.2.1" -> {0, 2, 1} ; champs absents à 0
+void versionBalise(const char *texte, uint8_t version[3]);
+
+// État qui mérite une balise immédiate : relais, forçage, défaut, WiFi,
+// consigne ou mesure (écart BALISE_ECART_TEMP)
+bool baliseChange(const Balise &avant, const Balise &maintenant);
+
+// Trame dans sortie[BALISE_TAILLE] ; retourne BALISE_TAILLE
+size_t encodeBalise(const Balise &b, uint8_t *sortie);
@@ -0,0 +1,79 @@
+// Boutons pilotés par interruption
+// Les fronts GPIO sont horodatés et filtrés (anti-rebond) dans l'ISR puis
+// déposés dans une file d'événements. La boucle consomme la file une fois
+// par itération et peut dormir entre deux événements.
+
+#pragma once
+
+#include <Arduino.h>
+
+// Paramètres d'auto-repeat
+const unsigned long delay1 = 500;   // après 500ms -> repeat lent
+const unsigned long delay2 = 2500;   // après 2500ms -> repeat rapide
+const unsigned long rate1  = 500;    // vitesse lente : 500ms
+const unsigned long rate2  = 50;    // vitesse rapide : 100ms
+
+// variable long press
+const unsigned long LONG_PRESS_MS = 2000;
+
+// Anti-rebond : fronts ignorés pendant ce délai après un front accepté
+const unsigned long DEBOUNCE_MS = 25;
+
+// Types d'événements déposés dans la file
+enum ButtonEventType : uint8_t {
+  BtnPress,
+  BtnRelease,
+  BtnRepeat,
+  BtnLongPress
+};
+
+struct ButtonEvent {
+  uint8_t btn;           // index du bouton
+  ButtonEventType type;
+  uint32_t time;         // millis() au moment du front (contexte ISR)
+};
+
+// Un bouton : état partagé avec l'ISR + événements de l'itération courante
+struct Bouton {
+  uint8_t pin;
+  uint8_t index;
+
+  // Écrit par l'ISR
+  volatile uint8_t niveau;         // dernier niveau accepté (HIGH = relâché)
+  volatile uint32_t dernierFront;  // moment du dernier front accepté
+
+  // Suivi de l'appui (contexte boucle)
+  bool enfonce;
+  bool longFait;                   // long appui déjà signalé pour cet appui
+  uint32_t pressedSince, lastRepeat;
+
+  // Événements reçus pendant l'itération courante
+  bool appui, relache, repete, longAppui;
+
+  // Même interface que Bounce2 pour les écrans
+  bool fell() const     { return appui; }
+  bool rose() const     { return relache; }
+  int read() const      { return enfonce ? LOW : HIGH; }
+  bool repeated() const { return repete; }
+  bool longPress() const { return longAppui; }
+};
+
+extern Bouton btnHaut, btnBas, btnGauche, btnDroite;
+
+// Configuration des GPIO, de la file et des interruptions
+void beginBoutons(int pinHaut, int pinBas, int pinGauche, int pinDroite);
+
+// Génère repeat/long press puis vide la file dans les boutons
+// À appeler une fois par itération de la boucle
+void updateBoutons();
+
+// true si un bouton a bougé pendant l'itération ou reste enfoncé
+bool activiteBoutons();
+
+// Délai (ms) jusqu'à la prochaine échéance repeat/long press, borné par maxMs
+unsigned long prochaineEcheanceBoutons(unsigned long maxMs);
+
+// Bloque jusqu'au prochain événement bouton ou au plus timeoutMs
+// Retourne true si un événement est en attente ; sans beginBoutons()
+// (profil sans boutons), attend simplement timeoutMs
+bool attenteBoutons(unsigned long timeoutMs);
@@ -0,0 +1,64 @@
+// Gestionnaire du bus I2C partagé (écran OLED, RTC DS3231)
+// Le bus tourne en fast mode (400 kHz : maximum du SH1106/SSD1306 et du
+// DS3231 ; le fast mode plus n'est supporté par aucun des deux) avec un
+// délai maximal par transaction. Chaque transaction passe par
+// TransactionBus : verrou du bus, chronométrage et comptage par
+// périphérique ; tout envoi d'image passe par busEnvoieEcran(), une
+// transaction par page (~3 ms). Toutes les transactions sont faites par la
+// tâche de loop() : une lecture du RTC vient donc entre deux images, jamais
+// au milieu, parce qu'il n'y a qu'une tâche et non grâce au verrou. Le
+// verrou ne sert qu'à un futur appelant d'une autre tâche, qui attendrait
+// alors la fin de la page en cours. Après une transaction trop longue
+// ou si SDA reste basse bus au repos (esclave bloqué au milieu d'un
+// octet), le bus est libéré : jusqu'à 9 impulsions sur SCL puis un STOP,
+// et le contrôleur est réinitialisé.
+
+#pragma once
+
+#include <Arduino.h>
+#include "profil.h"
+
+enum PeripheriqueBus : uint8_t {
+  BusEcran,
+  BusRtc,
+  NbPeripheriquesBus
+};
+
+const uint32_t BUS_FREQUENCE = 400000;
+const uint16_t BUS_DELAI_MS = 20;          // délai du contrôleur par transaction
+const uint16_t BUS_OCTETS_RTC = 8;         // lecture de l'heure : registre + 7 octets
+
+struct StatsBus {
+  uint32_t transactions;
+  uint32_t octets;
+  uint32_t erreurs;        // transactions trop longues ou bus bloqué après
+  uint64_t totalUs;
+  uint32_t maxUs;
+  uint32_t attenteMaxUs;   // attente du verrou (nulle tant qu'une seule tâche)
+};
+
+// Libère le bus si besoin puis démarre le contrôleur
+void beginBus(int pinSda, int pinScl);
+
+// Transaction sur le bus pour la durée de vie de l'objet
+class TransactionBus {
+public:
+  TransactionBus(PeripheriqueBus p, uint16_t octets);
+  ~TransactionBus();
+private:
+  PeripheriqueBus periph;
+  uint16_t nb;
+  uint32_t debutUs;
+};
+
+// Envoi de l'image de l'écran, une transaction par page
+void busEnvoieEcran(Profil::Ecran &ecran);
+
+// Impulsions SCL et STOP ; true si SDA est libérée
+bool busDebloque();
+
+const StatsBus &busStats(PeripheriqueBus p);
+uint32_t busDeblocages();
+
+// Statistiques sur le port série (commande "bus")
+void exportBus();
@@ -0,0 +1,52 @@
+// Résolution adaptative du DS18B20
+// Loin de la consigne ou juste après le démarrage, la mesure passe en
+// 10 bits (188 ms de conversion, 0.25 °C) : l'affichage et la télémétrie
+// suivent la montée en température. Le relais y est de toute façon saturé
+// (chauffe pleine ou arrêt), la régulation n'en dépend pas. Près de la
+// consigne, là où le relais bascule, la mesure est en 12 bits (750 ms,
+// 0.0625 °C). Des seuils d'entrée/sortie distincts évitent d'osciller
+// entre les deux résolutions.
+// Aucune dépendance Arduino : la même politique tourne dans le firmware et
+// dans la simulation tools/sim_capteur.cpp.
+
+#pragma once
+
+#include <stdint.h>
+#include "controle.h"
+
+// Durée de conversion DS18B20 selon la résolution (9..12 bits)
+inline uint16_t conversionMs(uint8_t bits) {
+  return (uint16_t)(94u << (bits - 9));   // 94, 188, 375, 750 ms
+}
+
+// Période d'échantillonnage : conversion + marge de lecture
+inline uint16_t periodeMs(uint8_t bits) {
+  return conversionMs(bits) + 12;
+}
+
+// Mise à zéro des bits non définis en basse résolution (raw en 1/128 °C),
+// puis recentrage sur le milieu du pas : sans cela une mesure 10 bits lit
+// en moyenne 0.1 °C trop bas par rapport au 12 bits et le tapis surchauffe
+inline int32_t masqueRaw(int32_t raw, uint8_t bits) {
+  int32_t pas = (int32_t)1 << (3 + 12 - bits);
+  return (raw & ~(pas - 1)) + (pas - 8) / 2;
+}
+
+// Seuils de la politique (centièmes de degré)
+const centi_t ECART_10_ENTREE = 150;   // passe en 10 bits au-delà de 1.5 °C...
+const centi_t ECART_10_SORTIE = 100;   // ...et y reste jusqu'à 1.0 °C
+const uint16_t ECHANTILLONS_DEMARRAGE = 20;  // premières mesures en 10 bits
+
+struct PolitiqueResolution {
+  uint8_t bits;
+  uint16_t nbEchantillons;
+  uint16_t nbChangements;    // nombre de changements de résolution
+
+  void reset(uint8_t bitsInitiaux) {
+    bits = bitsInitiaux;
+    nbEchantillons = nbChangements = 0;
+  }
+
+  // Nouvel échantillon : retourne la résolution à utiliser pour la suite
+  uint8_t echantillon(centi_t temp, centi_t cible);
+};
@@ -0,0 +1,53 @@
+// Comptabilité de chauffe
+// Temps relais fermé cumulé par heure (24 dernières heures) et par jour
+// (31 derniers jours), converti en Wh avec la puissance du tapis et en
+// taux de charge. Mise à jour incrémentale à chaque itération : pas de
+// parcours d'historique, sauf pour remettre à zéro les cases d'heures ou
+// de jours sautés (borné à la taille des tableaux).
+// L'ensemble est une structure simple (POD) sauvegardée telle quelle en
+// Preferences à chaque changement d'heure, soit au plus 24 écritures par
+// jour. Aucune dépendance Arduino.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+const int CONSO_HEURES = 24;
+const int CONSO_JOURS = 31;
+const uint16_t CONSO_WATTS_DEFAUT = 25;
+const uint16_t CONSO_WATTS_MAX = 2000;
+
+struct Consommation {
+  uint16_t watts;                  // puissance du tapis relais fermé
+  uint32_t heure;                  // heure courante (unixtime local / 3600), 0 = non datée
+  uint32_t resteMs;                // fraction de seconde pas encore comptée
+  uint16_t heures[CONSO_HEURES];   // secondes relais fermé, case heure % 24
+  uint32_t jours[CONSO_JOURS];     // secondes relais fermé, case jour % 31
+  uint32_t totalSecondes;          // depuis la mise en service
+
+  void reset(uint16_t puissance);
+
+  // Compte dureeMs écoulées dans l'état relais, à l'heure locale unixtime ;
+  // retourne true au changement d'heure (moment de sauvegarder)
+  bool avance(uint32_t unixtime, bool relais, uint32_t dureeMs);
+
+  // Secondes relais fermé il y a ilYa heures / jours (0 = en cours)
+  uint16_t secondesHeure(int ilYa) const;
+  uint32_t secondesJour(int ilYa) const;
+
+  // Énergie en Wh pour une durée relais fermé
+  uint32_t wattheures(uint32_t secondes) const {
+    return (uint32_t)(((uint64_t)secondes * watts + 1800) / 3600);
+  }
+};
+
+// Taux de charge en pour mille
+inline uint16_t pourmilleCharge(uint32_t secondesOn, uint32_t periode) {
+  if (periode == 0) return 0;
+  uint32_t p = (uint32_t)((uint64_t)secondesOn * 1000 / periode);
+  return p > 1000 ? 1000 : (uint16_t)p;
+}
+
+// "1.234" kWh à partir de Wh
+void formatKwh(char *buf, size_t taille, uint32_t wh);
@@ -0,0 +1,62 @@
+// Calculs de régulation en virgule fixe (centièmes de degré)
+// L'ESP32-C3 n'a pas de FPU : toutes les températures sont des int16_t
+// en 1/100 °C, de l'acquisition jusqu'à l'affichage.
+// Aucune dépendance Arduino : compilable tel quel sur PC.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Température en centièmes de degré (2550 = 25.50 °C)
+typedef int16_t centi_t;
+
+// Valeur affichée quand le capteur ne répond pas (66.6 °C)
+const centi_t TEMP_CAPTEUR_ABSENT = 6660;
+
+// Conversion brute DS18B20 (1/128 °C) -> centièmes arrondis
+centi_t rawToCenti(int32_t raw);
+
+// Interpolation en S (1 - cos) / 2 par table, entre deux consignes
+centi_t smoothStep(centi_t startTemp, centi_t endTemp, int startMinute, int endMinute, int nowMinute);
+
+// Consigne programmée pour la minute de la journée minuteNow
+centi_t tempCibleProgramme(int minuteNow, int minuteDay, centi_t tempDay,
+                           int minuteNight, centi_t tempNight, int fadeDuration);
+
+// Décision du relais : hystérésis sous la consigne et durées minimales de
+// marche et d'arrêt. Le bruit de mesure et la quantification (0.0625 °C en
+// 12 bits) ne font plus battre le relais mécanique près de la consigne ;
+// les durées minimales restent courtes devant la constante de temps du
+// tapis pour ne pas élargir la bande de régulation (tools/sim_capteur.cpp).
+const centi_t HYSTERESIS_BAS = 10;          // chauffe sous consigne - 0.1 °C...
+const centi_t HYSTERESIS_HAUT = 0;          // ...jusqu'à la consigne
+const uint32_t RELAIS_MARCHE_MIN_MS = 10000;
+const uint32_t RELAIS_ARRET_MIN_MS = 20000;
+
+struct Thermostat {
+  bool demande;
+  bool premiere;       // aucune décision encore : pas de durée minimale
+  uint32_t depuisMs;   // dernier basculement de la demande
+
+  void reset() {
+    demande = false;
+    premiere = true;
+    depuisMs = 0;
+  }
+
+  bool decide(centi_t tempAct, centi_t tempCible, uint32_t ms) {
+    bool voulu = demande ? tempAct < tempCible + HYSTERESIS_HAUT
+                         : tempAct < tempCible - HYSTERESIS_BAS;
+    uint32_t minimum = demande ? RELAIS_MARCHE_MIN_MS : RELAIS_ARRET_MIN_MS;
+    if (voulu != demande && (premiere || ms - depuisMs >= minimum)) {
+      demande = voulu;
+      depuisMs = ms;
+    }
+    premiere = false;
+    return demande;
+  }
+};
+
+// Formatage "25.5" / "-3.2" (arrondi au dixième) sans printf flottant
+void formatTemp(char *buf, size_t taille, centi_t temp);
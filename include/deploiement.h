@@ -0,0 +1,64 @@
+// Déploiement progressif des mises à jour
+// Le manifeste (release/version.json) garde ses pointeurs "latest" et
+// "stable" ; une section facultative "rollout" restreint, version par
+// version, les appareils qui la prennent :
+//   "cohorts": { "labo": ["1a2b3c4d", "0badcafe"] },
+//   "rollout": {
+//     "0.2.2": { "percent": 10, "cohorts": ["labo"], "min_version": "0.2.0",
+//                "halted": false }
+//   },
+//   "report": "http://192.168.1.10:8266/rapport"
+// Sans entrée "rollout" pour la version, tout le parc la prend (ancien
+// format). Sinon un appareil la prend s'il n'est pas arrêté ("halted"),
+// si sa version atteint "min_version" et s'il est dans une des cohortes
+// citées ou dans la tranche : hachage de son identifiant (partageId()) et
+// de la version, en dix-millièmes, sous "percent". Le tirage est fixe pour
+// un appareil et une version (monter le pourcentage ne fait qu'ajouter des
+// appareils) et change d'une version à l'autre (les premiers servis ne
+// sont pas toujours les mêmes).
+// Chaque appareil qui tente la mise à jour rapporte son résultat par POST
+// JSON à "report" s'il est publié : échec de l'installation aussitôt,
+// succès après DEPLOIEMENT_VALIDATION_MS de marche sur la nouvelle image,
+// retour à l'ancienne image si le démarrage n'a pas abouti. L'opérateur
+// (tools/deploiement.py) arrête le déploiement au vu des échecs.
+// Aucune dépendance Arduino.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+const uint16_t DEPLOIEMENT_TRANCHES = 10000;              // dix-millièmes du parc
+const unsigned long DEPLOIEMENT_VALIDATION_MS = 600000;   // marche avant rapport de succès
+const unsigned long DEPLOIEMENT_RAPPORT_REESSAI_MS = 60000;
+const uint8_t DEPLOIEMENT_RAPPORT_ESSAIS = 5;
+const uint16_t DEPLOIEMENT_RAPPORT_TIMEOUT_MS = 3000;
+
+enum DecisionDeploiement : uint8_t {
+  DeploiementOui,
+  DeploiementHorsTranche,    // pas encore son tour
+  DeploiementArrete,         // "halted"
+  DeploiementVersionMin      // version installée sous "min_version"
+};
+
+// Entrée "rollout" d'une version, lue dans le manifeste
+struct RegleDeploiement {
+  uint16_t tranches;         // "percent" en dix-millièmes (10000 = tout le parc)
+  bool arrete;
+  bool cohorte;              // l'appareil est dans une cohorte citée
+  const char *versionMin;    // nullptr ou "" : pas de contrainte
+};
+
+// Comparaison numérique "0.2.10" > "0.2.9" ; un champ absent vaut 0
+int compareVersions(const char *a, const char *b);
+
+// Position 0..DEPLOIEMENT_TRANCHES-1 de l'appareil pour cette version
+uint16_t trancheDeploiement(uint32_t id, const char *version);
+
+// "percent" du manifeste en dix-millièmes, borné à 0..100 %
+uint16_t tranchesPourcentage(float pourcentage);
+
+DecisionDeploiement decideDeploiement(uint32_t id, const char *actuelle, const char *cible,
+                                      const RegleDeploiement &r);
+
+const char *texteDecision(DecisionDeploiement d);
@@ -0,0 +1,65 @@
+// Modèle de comptabilité énergétique
+// Temps passé éveillé par sous-système et courant moyen estimé.
+// Aucune dépendance Arduino : le même code s'évalue sur PC (g++) en lui
+// injectant des durées, ou tourne tel quel dans le firmware.
+
+#pragma once
+
+#include <stdint.h>
+
+enum SousSysteme : uint8_t {
+  SsCpu,       // CPU actif (hors attente / light sleep)
+  SsEcran,     // OLED allumé
+  SsWifi,      // WiFi associé (modem-sleep entre les DTIM)
+  SsCapteur,   // conversion DS18B20 en cours
+  NbSousSystemes
+};
+
+// Courants estimés (µA) éveillé / en veille pour chaque sous-système
+struct ProfilCourant {
+  uint32_t actifUA;
+  uint32_t veilleUA;
+};
+
+// Valeurs typiques ESP32-C3 / SH1106 / DS18B20, à ajuster selon les mesures
+const ProfilCourant profilsCourant[NbSousSystemes] = {
+  {22000,  130},   // CPU 160 MHz / light sleep
+  {12000,   10},   // OLED plein contenu / power save
+  {20000,    0},   // WiFi modem-sleep moyen / coupé
+  { 1000,    1}    // DS18B20 conversion / repos
+};
+
+struct ModeleEnergie {
+  uint32_t totalMs;
+  uint32_t actifMs[NbSousSystemes];
+
+  void reset() {
+    totalMs = 0;
+    for (int i = 0; i < NbSousSystemes; i++) actifMs[i] = 0;
+  }
+
+  // Fait avancer l'horloge du modèle (une fois par itération)
+  void avance(uint32_t dureeMs) { totalMs += dureeMs; }
+
+  // Ajoute du temps éveillé à un sous-système
+  void compte(SousSysteme s, uint32_t dureeMs) { actifMs[s] += dureeMs; }
+
+  // Pourcentage de temps éveillé, en dixièmes de %
+  uint16_t pourmilleActif(SousSysteme s) const {
+    if (totalMs == 0) return 0;
+    uint32_t actif = actifMs[s] < totalMs ? actifMs[s] : totalMs;
+    return (uint16_t)((uint64_t)actif * 1000 / totalMs);
+  }
+
+  // Courant moyen estimé (µA) sur la fenêtre
+  uint32_t courantMoyenUA() const {
+    if (totalMs == 0) return 0;
+    uint64_t charge = 0;  // µA.ms
+    for (int i = 0; i < NbSousSystemes; i++) {
+      uint32_t actif = actifMs[i] < totalMs ? actifMs[i] : totalMs;
+      charge += (uint64_t)actif * profilsCourant[i].actifUA;
+      charge += (uint64_t)(totalMs - actif) * profilsCourant[i].veilleUA;
+    }
+    return (uint32_t)(charge / totalMs);
+  }
+};
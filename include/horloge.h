@@ -0,0 +1,47 @@
+// Horloge logicielle disciplinée par le DS3231
+// L'heure est lue une fois sur le RTC au démarrage puis extrapolée avec le
+// timer 64 bits de l'ESP32 : horlogeNow() ne fait aucune transaction I2C.
+// Chaque front de seconde du RTC (sortie SQW 1 Hz si câblée, sinon relevé
+// périodique du changement de seconde) recale la phase et mesure la dérive
+// du quartz de l'ESP32, compensée en ppm. Quand le WiFi est là, le NTP
+// corrige le RTC lui-même.
+
+#pragma once
+
+#include <Arduino.h>
+#include <RTClib.h>
+
+// Recalage sur le RTC (relevé d'un front de seconde)
+const unsigned long HORLOGE_RESYNC_MS = 600000;   // toutes les 10 min
+// Contrôle du RTC par NTP
+const unsigned long HORLOGE_NTP_MS = 3600000;     // toutes les heures
+// Précision exigée de la dérive avant de la publier (horlogeNow(), reprise)
+const int32_t HORLOGE_DERIVE_PRECISION_PPM = 10;
+// Écart RTC / NTP (s) au-delà duquel le RTC est corrigé
+const long HORLOGE_NTP_ECART_MAX = 2;
+// Fuseau horaire du RTC (heure locale) pour le NTP
+#define HORLOGE_TZ "CET-1CEST,M3.5.0,M10.5.0/3"
+
+// Lit le RTC et cale l'horloge sur un front de seconde (bloque au plus ~1 s)
+// pinSqw : entrée reliée à la sortie SQW du DS3231, -1 si non câblée
+void beginHorloge(RTC_DS3231 &rtc, int pinSqw);
+
+// Reprise à chaud : une seule lecture du RTC (phase à la seconde près) et
+// dérive déjà mesurée ; la phase est rattrapée sans bloquer par
+// updateHorloge() dans la seconde qui suit
+void beginHorlogeRapide(RTC_DS3231 &rtc, int pinSqw, int32_t ppm);
+
+// Lance la synchronisation NTP (à appeler une fois le WiFi connecté)
+void beginNtp();
+
+// Heure courante extrapolée, sans accès I2C
+DateTime horlogeNow();
+
+// Recalage RTC, chasse de front et correction NTP ; une fois par itération
+void updateHorloge();
+
+// Réglage manuel (menu Date) : écrit le RTC et recale l'horloge
+void regleHorloge(const DateTime &dt);
+
+// Dérive mesurée du timer ESP32 par rapport au RTC (ppm, >0 = ESP32 lent)
+int32_t horlogeDerivePpm();
@@ -0,0 +1,47 @@
+// Sprites XBM précalculés (dessin par drawXBMP)
+// Généré par tools/gen_icones.py : ne pas modifier à la main
+
+#pragma once
+
+#include "profil.h"
+
+// Icône WiFi : point + 0 à 3 arcs, origine décalée du centre du point
+// (identique à l'ancien dessin tant que le point est en x >= 8, y >= 10)
+const int WIFI_ICON_W = 16;
+const int WIFI_ICON_H = 12;
+const int WIFI_ICON_DX = -8;
+const int WIFI_ICON_DY = -10;
+
+static const unsigned char wifiIcon0[] U8X8_PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0xc0, 0x03, 0x80, 0x01
+};
+
+static const unsigned char wifiIcon1[] U8X8_PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0xe0, 0x07, 0x30, 0x0c, 0x00, 0x00, 0x80, 0x01, 0xc0, 0x03, 0x80, 0x01
+};
+
+static const unsigned char wifiIcon2[] U8X8_PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x0f, 0x18, 0x18, 0x0c, 0x30,
+  0xe0, 0x07, 0x30, 0x0c, 0x00, 0x00, 0x80, 0x01, 0xc0, 0x03, 0x80, 0x01
+};
+
+static const unsigned char wifiIcon3[] U8X8_PROGMEM = {
+  0xf8, 0x1f, 0x0c, 0x30, 0x03, 0xc0, 0xf1, 0x8f, 0x18, 0x18, 0x0c, 0x30,
+  0xe0, 0x07, 0x30, 0x0c, 0x00, 0x00, 0x80, 0x01, 0xc0, 0x03, 0x80, 0x01
+};
+
+static const unsigned char *const wifiIcons[] = { wifiIcon0, wifiIcon1, wifiIcon2, wifiIcon3 };
+
+// Flèches de sélection (7x4)
+const int FLECHE_W = 7;
+const int FLECHE_H = 4;
+
+static const unsigned char flecheHaut[] U8X8_PROGMEM = {
+  0x08, 0x1c, 0x3e, 0x7f
+};
+
+static const unsigned char flecheBas[] U8X8_PROGMEM = {
+  0x7f, 0x3e, 0x1c, 0x08
+};
@@ -0,0 +1,93 @@
+// Provisionnement WiFi par le port série, protocole Improv Serial
+// (https://www.improv-wifi.com/serial/) : SSID et mot de passe en un seul
+// message, tentative de connexion, résultat et adresse de l'appareil en
+// retour (tools/provisionne.py, ou tout outil Improv).
+//
+//  octet  champ      valeur
+//   0     en-tête    "IMPROV"
+//   6     version    IMPROV_VERSION
+//   7     type       ImprovType
+//   8     longueur   n
+//   9     données    n octets
+//  9+n    somme      somme des octets 0..8+n, modulo 256
+// Les outils ajoutent un saut de ligne après la somme ; il est ignoré.
+// Les paquets partagent le port série avec les commandes texte : tant
+// qu'aucun en-tête complet n'est reconnu, les octets restent du texte.
+// Aucune dépendance Arduino.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+const uint8_t IMPROV_VERSION = 1;
+const size_t IMPROV_PAQUET_MAX = 9 + 255 + 2;      // en-tête, données, somme, saut de ligne
+const unsigned long IMPROV_CONNEXION_MS = 20000;   // délai de la tentative de connexion
+
+enum ImprovType : uint8_t {
+  ImprovEtat = 1,
+  ImprovErreur = 2,
+  ImprovCommande = 3,
+  ImprovResultat = 4
+};
+
+enum ImprovEtatAppareil : uint8_t {
+  ImprovPret = 2,          // accès physique au port série : pas d'autorisation à demander
+  ImprovConnexion = 3,
+  ImprovConnecte = 4
+};
+
+enum ImprovCodeErreur : uint8_t {
+  ImprovSansErreur = 0,
+  ImprovPaquetInvalide = 1,
+  ImprovCommandeInconnue = 2,
+  ImprovEchecConnexion = 3,
+  ImprovErreurInconnue = 0xFF
+};
+
+enum ImprovRpc : uint8_t {
+  ImprovRpcWifi = 1,       // SSID et mot de passe
+  ImprovRpcEtat = 2,       // état courant (et adresse si connecté)
+  ImprovRpcInfo = 3,       // firmware, version, puce, nom
+  ImprovRpcScan = 4        // réseaux visibles, un résultat par réseau puis un vide
+};
+
+enum LectureImprov : uint8_t {
+  ImprovTexte,             // octet hors paquet : au texte
+  ImprovEnCours,           // octet d'un paquet en cours (en-tête compris)
+  ImprovPaquet,            // paquet complet et valide dans type/longueur/donnees
+  ImprovInvalide           // somme ou version fausse : paquet abandonné
+};
+
+// Lecture octet par octet
+struct LecteurImprov {
+  uint16_t etape;          // octets du paquet reçus
+  uint8_t somme;
+  uint8_t type;
+  uint8_t longueur;
+  uint8_t donnees[255];
+
+  void reset() { etape = 0; }
+  LectureImprov lit(uint8_t octet);
+  // En-tête complet reconnu : les octets suivants ne sont pas du texte
+  bool dansPaquet() const { return etape >= 7; }
+};
+
+// Commande RPC décodée (chaînes terminées par un zéro)
+struct CommandeImprov {
+  uint8_t rpc;
+  char ssid[33];
+  char motDePasse[65];
+};
+
+// false si les longueurs ne sont pas cohérentes
+bool decodeCommande(const uint8_t *donnees, uint8_t longueur, CommandeImprov &c);
+
+// Paquet complet avec saut de ligne dans sortie[IMPROV_PAQUET_MAX] ;
+// retourne sa taille
+size_t encodeImprov(uint8_t *sortie, ImprovType type, const uint8_t *donnees, uint8_t longueur);
+
+// Données d'un résultat RPC : commande, longueur, puis n chaînes préfixées
+// par leur longueur (tronquées à ce qui tient en 255 octets) ; retourne
+// leur taille
+size_t donneesResultat(uint8_t *sortie, uint8_t rpc, const char *const *chaines, int n);
@@ -0,0 +1,83 @@
+// Partage des images firmware sur le réseau local
+// Chaque appareil annonce en mDNS (_tapisfw._tcp) la version qu'il exécute
+// et le MD5 de son image, vérifiée au téléchargement (Update.setMD5) puis
+// relue en flash : il peut la servir en HTTP simple à ses pairs. Un cache
+// local (tools/cache_firmware.py) s'annonce de la même façon.
+// Avant de télécharger une version, un appareil cherche un pair qui
+// l'exécute avec le MD5 du manifeste ; sinon il annonce qu'il l'attend et,
+// passé le délai d'élection, seul l'identifiant le plus petit parmi les
+// appareils en attente la télécharge depuis l'origine (annonce "dl") : les
+// autres patientent jusqu'à ce qu'il ait redémarré et la serve (l'annonce
+// "dl" reste prise en compte PARTAGE_RELAIS_MS après sa disparition, le
+// temps du redémarrage). Un pair occupé ou en échec renvoie à l'attente,
+// pas à l'origine ; un pair dont l'image ne correspond pas au manifeste est
+// exclu. Le trafic vers l'origine reste donc d'un téléchargement par
+// version, quelle que soit la taille du parc ; après PARTAGE_ATTENTE_MAX_MS
+// sans pair, chacun se rabat sur l'origine. L'image d'un pair est toujours
+// vérifiée contre le manifeste avant Update.end().
+// Aucune dépendance Arduino : évaluée par tools/sim_partage.cpp.
+
+#pragma once
+
+#include <stdint.h>
+
+const int PAIRS_MAX = 8;
+const uint16_t PARTAGE_PORT = 8080;
+const uint32_t PARTAGE_ELECTION_MS = 6000;       // annonce "en attente" visible de tous
+const uint32_t PARTAGE_REESSAI_MS = 15000;       // nouvelle recherche pendant l'attente
+const uint32_t PARTAGE_RELAIS_MS = 120000;       // fin du "dl" -> image servie après redémarrage
+const uint32_t PARTAGE_ATTENTE_MAX_MS = 300000;  // puis origine sans condition
+
+enum EtatPair : uint8_t {
+  PairInactif,
+  PairAttente,          // attend versionEtat
+  PairTelechargement    // télécharge versionEtat depuis l'origine
+};
+
+struct Pair {
+  uint32_t ip;          // IPv4, ordre réseau
+  uint16_t port;
+  uint32_t id;          // identifiant unique (MAC)
+  bool cache;           // service de cache plutôt qu'appareil
+  char version[16];     // image servie
+  char md5[33];
+  EtatPair etat;
+  char versionEtat[16];
+};
+
+enum DecisionSource : uint8_t {
+  SourcePairs,          // essayer ordre[0..nb-1], sinon nouvelle recherche
+  SourceAttente,        // nouvelle recherche dans attenteMs
+  SourceOrigine         // télécharger depuis l'origine (annonce "dl")
+};
+
+struct Plan {
+  DecisionSource decision;
+  uint8_t nb;
+  uint8_t ordre[PAIRS_MAX];
+  uint32_t attenteMs;
+};
+
+// Mise à jour en cours sur cet appareil
+struct Election {
+  uint32_t debutMs;            // première annonce "en attente"
+  uint32_t dlVuMs;             // dernière annonce "dl" d'un autre appareil
+  bool dlVu;
+  uint8_t nbExclus;
+  uint32_t exclus[PAIRS_MAX];  // pairs dont l'image a échoué à la vérification
+};
+
+void commenceElection(Election &e, uint32_t maintenant);
+
+// Pair écarté jusqu'à la fin de la mise à jour
+void exclutPair(Election &e, uint32_t id);
+
+// Ajoute une réponse mDNS à la liste bornée transmise à planifie() : les
+// pairs servant la version (PAIRS_MAX - 2 au plus), le plus petit
+// identifiant en attente et un appareil qui la télécharge. L'élection reste
+// juste quelle que soit la taille du parc.
+void recense(Pair *pairs, int &n, const Pair &p, const char *version);
+
+// Décision après une recherche
+Plan planifie(Election &e, const Pair *pairs, int n, const char *version, const char *md5,
+              uint32_t id, uint32_t maintenant);
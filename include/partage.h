@@ -0,0 +1,39 @@
+// Partage de l'image firmware sur le réseau local (voir include/pairs.h)
+// Annonce mDNS _tapisfw._tcp (TXT v, md5, id, role, etat) et serveur HTTP
+// minimal de l'image en cours d'exécution, relue dans sa partition. Le
+// service se fait par morceaux depuis loop(), dans un budget de temps par
+// itération : la régulation n'est jamais bloquée par un pair qui télécharge.
+// La recherche des pairs est asynchrone.
+// mDNS est démarré par ArduinoOTA.begin() : beginPartage() vient après.
+
+#pragma once
+
+#include <Arduino.h>
+#include "pairs.h"
+
+const unsigned long PARTAGE_DELAI_MS = 30000;     // annonce (calcul du MD5) après le démarrage
+const unsigned long PARTAGE_REQUETE_MS = 2000;    // requête HTTP complète sous 2 s
+const unsigned long PARTAGE_BUDGET_MS = 10;       // envoi par itération de loop()
+const uint32_t PARTAGE_RECHERCHE_MS = 3000;       // durée d'une recherche mDNS
+const size_t PARTAGE_REPONSES_MAX = 64;           // réponses mDNS, réduites par recense()
+
+// immediat : redémarrage après un téléchargement depuis l'origine, des pairs
+// attendent l'image ; annonce dès la connexion WiFi
+void beginPartage(const char *version, bool immediat);
+
+// Annonce différée, service de l'image par morceaux
+void updatePartage();
+
+// Un pair est en train de télécharger : loop() ne doit pas attendre
+bool partageActif();
+
+// Recherche asynchrone des pairs ; partageResultats() retourne true quand
+// elle est terminée, avec les n pairs utiles pour cette version
+void partageRecherche();
+bool partageResultats(const char *version, Pair *pairs, int &n);
+
+// État annoncé pendant une mise à jour (PairInactif : aucune)
+void partageEtat(EtatPair etat, const char *version);
+
+// Identifiant de l'appareil pour l'élection
+uint32_t partageId();
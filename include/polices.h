@@ -0,0 +1,24 @@
+// Polices U8g2 du firmware
+// Avec -D POLICES_SUBSET (ajouté par tools/subset_polices.py au build), les
+// noms u8g2_font_* désignent les sous-ensembles générés dans
+// $BUILD_DIR/polices au lieu des polices complètes de la bibliothèque.
+// Sans écran (-D TARGET_RELAIS), ce sont des pointeurs nuls : aucune police
+// n'est embarquée. Inclure après profil.h.
+
+#pragma once
+
+#if defined(POLICES_SUBSET)
+#include "polices_subset.h"
+#endif
+
+#if defined(TARGET_RELAIS)
+static const uint8_t *const u8g2_font_fub11_tr = nullptr;
+static const uint8_t *const u8g2_font_fub25_tr = nullptr;
+static const uint8_t *const u8g2_font_ncenB08_tf = nullptr;
+static const uint8_t *const u8g2_font_ncenB08_tr = nullptr;
+static const uint8_t *const u8g2_font_open_iconic_check_1x_t = nullptr;
+static const uint8_t *const u8g2_font_open_iconic_embedded_2x_t = nullptr;
+static const uint8_t *const u8g2_font_open_iconic_thing_1x_t = nullptr;
+static const uint8_t *const u8g2_font_t0_12_tf = nullptr;
+static const uint8_t *const u8g2_font_tiny5_tf = nullptr;
+#endif
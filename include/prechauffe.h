@@ -0,0 +1,83 @@
+// Préchauffe prédictive
+// Le tapis suit la consigne avec retard : lancée à l'heure programmée, la
+// courbe en S atteint son plateau à l'heure + fadeDuration mais la mesure
+// n'y arrive que bien après. Le modèle apprend en ligne :
+//  - la vitesse de chauffe (relais fermé) et de refroidissement (relais
+//    ouvert), mesurées sur les longues périodes où le relais ne bascule pas ;
+//  - le retard restant entre le plateau programmé et le plateau mesuré.
+// La rampe est allongée pour que sa pente maximale reste à la portée du
+// tapis, et avancée du retard appris, de sorte que la mesure atteigne le
+// plateau à l'heure programmée + fadeDuration.
+// Sans apprentissage (vitesses inconnues, retard nul) la consigne est
+// identique à tempCibleProgramme().
+// Aucune dépendance Arduino.
+
+#pragma once
+
+#include <stdint.h>
+#include "controle.h"
+
+// Apprentissage des vitesses
+const uint32_t PRECHAUFFE_MORT_MS = 120000;      // début de période ignoré (temps mort)
+const uint32_t PRECHAUFFE_FENETRE_MS = 300000;   // pente mesurée sur 5 min
+// Rampe
+const int PRECHAUFFE_DUREE_MAX = 360;            // rampe la plus longue (min)
+const int PRECHAUFFE_RETARD_MAX = 120;           // avance/retard supplémentaire max (min)
+const int PRECHAUFFE_CORRECTION_MAX = 30;        // correction du retard par transition (min)
+// Suivi des transitions
+const centi_t PRECHAUFFE_TOLERANCE = 20;         // plateau atteint à 0.2 °C près
+const centi_t PRECHAUFFE_ECART_MIN = 50;         // transitions plus petites non suivies
+const int PRECHAUFFE_ABANDON = 180;              // plateau toujours pas atteint après 3 h
+
+const int16_t ECART_INCONNU = 0x7FFF;
+
+enum Transition : int8_t {
+  TransitionAucune = -1,
+  TransitionJour = 0,    // nuit -> jour (chauffe)
+  TransitionNuit = 1     // jour -> nuit (refroidissement)
+};
+
+// Programme jour/nuit tel que réglé dans le menu Prog Temp
+struct Programme {
+  int minuteDay;
+  centi_t tempDay;
+  int minuteNight;
+  centi_t tempNight;
+  int fadeDuration;
+};
+
+struct Prechauffe {
+  // Paramètres appris (persistés)
+  int16_t vitesseChauffe;   // centièmes/heure relais fermé, 0 = inconnue
+  int16_t vitesseRefroid;   // centièmes/heure relais ouvert, 0 = inconnue
+  int16_t retard[2];        // avance ajoutée par transition (min, négative = rampe retardée)
+
+  // Rapport : écart entre l'arrivée mesurée au plateau et l'arrivée de la
+  // consigne programmée, à la dernière transition (min, négatif = en avance)
+  int16_t dernierEcart[2];
+
+  void reset();
+
+  // Échantillon de mesure avec l'état du relais : apprentissage des vitesses
+  void echantillon(centi_t temp, bool relais, uint32_t ms);
+
+  // Consigne prédictive pour la minute de la journée minuteNow
+  centi_t consigne(int minuteNow, const Programme &p) const;
+
+  // Suivi de la transition en cours ; retourne la transition dont l'écart
+  // vient d'être mesuré (retard mis à jour), TransitionAucune sinon
+  Transition suivi(int minuteNow, centi_t temp, const Programme &p);
+
+  // Début et durée de la rampe d'une transition (minutes de la journée)
+  void rampe(Transition t, const Programme &p, int &debut, int &duree) const;
+
+  // État de l'apprentissage et du suivi
+  bool relaisPrec;
+  bool refValide;
+  uint32_t segmentMs;
+  uint32_t refMs;
+  centi_t refTemp;
+
+  Transition enCours;
+  Transition derniereSuivie;
+};
@@ -0,0 +1,136 @@
+// Profils de carte : écran, broches, boutons, relais
+// Chaque variante matérielle est un jeu de traits fixés à la compilation :
+// pilote et géométrie de l'écran, broches, nombre de boutons et polarité
+// du relais. Le profil est choisi par build_flags et désigné par Profil :
+//   (défaut)          ProfilXiao   SH1106 128x64, 4 boutons
+//   -D TARGET_WOKWI   ProfilWokwi  SSD1306 128x64, broches du diagram.json
+//   -D TARGET_RELAIS  ProfilRelais sans écran ni boutons
+// Profil::Ecran est une classe concrète (pas de méthode virtuelle) : les
+// appels à l'écran restent directs. Le code réservé à l'écran ou aux
+// boutons est gardé par if (Profil::ECRAN) / if (Profil::BOUTONS), des
+// constantes : la branche morte disparaît à la compilation, et avec elle
+// les écrans, sprites et polices qu'elle référence.
+// Le profil relais n'inclut pas U8g2 : EcranNul a les mêmes méthodes, vides,
+// et les polices sont des pointeurs nuls (voir include/polices.h). L'unité
+// est pilotée par le réseau (tableau de bord, télémétrie) et mise à jour
+// par ArduinoOTA ; tools/taille_profils.py compare la taille des profils.
+
+#pragma once
+
+#include <Arduino.h>
+
+// Broches du XIAO ESP32-C3 du montage (matériel et unité relais)
+struct BrochesXiao {
+  static constexpr int PIN_SDA        = 3;
+  static constexpr int PIN_SCL        = 4;
+  static constexpr int PIN_BTN_BAS    = 9;
+  static constexpr int PIN_BTN_GAUCHE = 10;
+  static constexpr int PIN_BTN_HAUT   = 20;
+  static constexpr int PIN_BTN_DROITE = 21;
+  static constexpr int PIN_RELAY      = 5;
+  static constexpr int PIN_ONEWIRE    = 2;   // DS18B20
+  static constexpr int PIN_RTC_SQW    = -1;  // sortie SQW 1 Hz du DS3231, -1 si non câblée
+};
+
+#if defined(TARGET_RELAIS)
+
+// Écran absent : mêmes méthodes que U8G2, sans effet
+class EcranNul {
+public:
+  bool begin() { return true; }
+  void setBusClock(uint32_t) {}
+  void setPowerSave(uint8_t) {}
+  void clearBuffer() {}
+  void sendBuffer() {}
+  void updateDisplayArea(uint8_t, uint8_t, uint8_t, uint8_t) {}
+  uint8_t getBufferTileWidth() { return 0; }
+  uint8_t getBufferTileHeight() { return 0; }
+  void setFont(const uint8_t *) {}
+  void setDrawColor(uint8_t) {}
+  void setBitmapMode(uint8_t) {}
+  uint16_t drawStr(int, int, const char *) { return 0; }
+  uint16_t drawGlyph(int, int, uint16_t) { return 0; }
+  uint16_t getStrWidth(const char *) { return 0; }
+  void drawBox(int, int, int, int) {}
+  void drawHLine(int, int, int) {}
+  void drawVLine(int, int, int) {}
+  void drawPixel(int, int) {}
+  void drawXBMP(int, int, int, int, const uint8_t *) {}
+};
+
+#ifndef U8X8_PROGMEM
+#define U8X8_PROGMEM PROGMEM
+#endif
+
+// Unité relais : pas d'écran ni de boutons ; consigne, programme et date
+// se règlent par POST /commande sur le tableau de bord ou par le port série
+// (appliqueReglage() dans main.cpp)
+struct ProfilRelais : BrochesXiao {
+  typedef EcranNul Ecran;
+  static constexpr bool ECRAN = false;
+  static constexpr int LARGEUR = 0;
+  static constexpr int HAUTEUR = 0;
+  static constexpr int BOUTONS = 0;
+  static constexpr bool RELAIS_ACTIF_HAUT = true;
+};
+
+typedef ProfilRelais Profil;
+
+#else
+
+#include <U8g2lib.h>
+
+// Constructeurs sans argument : l'objet écran se déclare "Profil::Ecran u8g2;"
+struct EcranSH1106 : U8G2_SH1106_128X64_NONAME_F_HW_I2C {
+  EcranSH1106() : U8G2_SH1106_128X64_NONAME_F_HW_I2C(U8G2_R0, /* reset=*/ U8X8_PIN_NONE) {}
+};
+
+struct EcranSSD1306 : U8G2_SSD1306_128X64_NONAME_F_HW_I2C {
+  EcranSSD1306() : U8G2_SSD1306_128X64_NONAME_F_HW_I2C(U8G2_R0, /* reset=*/ U8X8_PIN_NONE) {}
+};
+
+// Matériel : clone SH1106 et broches du montage
+struct ProfilXiao : BrochesXiao {
+  typedef EcranSH1106 Ecran;
+  static constexpr bool ECRAN = true;
+  static constexpr int LARGEUR = 128;
+  static constexpr int HAUTEUR = 64;
+  static constexpr int BOUTONS = 4;
+  static constexpr bool RELAIS_ACTIF_HAUT = true;
+};
+
+// Wokwi : SSD1306, broches à adapter si besoin au diagram.json
+struct ProfilWokwi {
+  typedef EcranSSD1306 Ecran;
+  static constexpr bool ECRAN = true;
+  static constexpr int LARGEUR = 128;
+  static constexpr int HAUTEUR = 64;
+  static constexpr int BOUTONS = 4;
+  static constexpr bool RELAIS_ACTIF_HAUT = true;
+  static constexpr int PIN_SDA        = D10;
+  static constexpr int PIN_SCL        = D9;
+  static constexpr int PIN_BTN_BAS    = D0;
+  static constexpr int PIN_BTN_GAUCHE = D1;
+  static constexpr int PIN_BTN_HAUT   = D2;
+  static constexpr int PIN_BTN_DROITE = D3;
+  static constexpr int PIN_RELAY      = D7;
+  static constexpr int PIN_ONEWIRE    = D8;  // DS18B20
+  static constexpr int PIN_RTC_SQW    = -1;
+};
+
+#if defined(TARGET_WOKWI)
+typedef ProfilWokwi Profil;
+#else
+typedef ProfilXiao Profil;
+#endif
+
+#endif
+
+// Les écrans sont dessinés pour 128x64 et pilotés par les 4 boutons
+static_assert(!Profil::ECRAN || (Profil::LARGEUR == 128 && Profil::HAUTEUR == 64),
+              "geometrie d'ecran non prevue par les ecrans");
+static_assert(Profil::BOUTONS == 0 || Profil::BOUTONS == 4, "0 ou 4 boutons");
+static_assert(Profil::BOUTONS == 4 || !Profil::ECRAN, "un ecran sans boutons n'est pas navigable");
+
+const int LARGEUR_ECRAN = Profil::LARGEUR;
+const int HAUTEUR_ECRAN = Profil::HAUTEUR;
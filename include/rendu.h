@@ -0,0 +1,53 @@
+// Rendu sur événement de l'écran
+// Chaque écran résume ce qu'il affiche dans une Vue (empreinte FNV-1a des
+// valeurs visibles : heure à la seconde, températures au dixième, icônes,
+// curseur...). loop() ne redessine et n'envoie l'image que si l'empreinte
+// a changé depuis la dernière image, au plus une fois par
+// RENDU_INTERVALLE_MIN_MS, et au moins une fois par
+// RENDU_RAFRAICHISSEMENT_MS (0 : jamais sans changement). Les images
+// rendues et sautées et le temps de rendu sont comptés pour le rapport
+// périodique.
+// Aucune dépendance Arduino.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+const uint32_t RENDU_INTERVALLE_MIN_MS = 40;       // 25 images/s au plus
+const uint32_t RENDU_RAFRAICHISSEMENT_MS = 10000;  // image complète de secours
+
+struct Vue {
+  uint32_t empreinte = 2166136261u;
+
+  void ajoute(const void *donnees, size_t n);
+  void ajouteTexte(const char *texte);
+  template <typename T> void ajoute(const T &valeur) { ajoute(&valeur, sizeof(valeur)); }
+};
+
+struct Rendu {
+  uint32_t empreinte;       // vue de la dernière image
+  uint32_t dernierMs;
+  bool invalide;            // image à refaire sans condition (réveil de l'écran)
+  uint32_t versions;        // changements de vue constatés
+  // Compteurs du rapport
+  uint32_t images;
+  uint32_t sautees;
+  uint64_t renduUs;         // temps passé à dessiner et envoyer les images
+
+  void reset();
+  void invalideTout() { invalide = true; }
+
+  // true si l'image doit être refaite maintenant ; sinon compte une image
+  // sautée
+  bool aRendre(const Vue &v, uint32_t maintenant);
+  void rendue(uint32_t dureeUs) { images++; renduUs += dureeUs; }
+
+  // Délai avant l'image différée par la limite de cadence (0 : aucune)
+  uint32_t echeance(const Vue &v, uint32_t maintenant) const;
+
+  // Temps de rendu moyen et temps CPU évité par les images sautées
+  uint32_t moyenneUs() const { return images ? (uint32_t)(renduUs / images) : 0; }
+  uint32_t economiseMs() const { return (uint32_t)((uint64_t)sautees * moyenneUs() / 1000); }
+  void remetCompteurs() { images = 0; sautees = 0; renduUs = 0; }
+};
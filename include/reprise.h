@@ -0,0 +1,85 @@
+// Reprise à chaud après redémarrage
+// Bloc d'état conservé en mémoire RTC non initialisée (RTC_NOINIT_ATTR) :
+// il survit à ESP.restart() (mise à jour OTA), aux paniques et aux
+// watchdogs, pas à une coupure d'alimentation. Il contient l'état de la
+// régulation (dernière mesure, consigne et forçage manuel, relais,
+// politique de résolution, suivi de préchauffe, comptabilité depuis la
+// dernière sauvegarde horaire), la dérive de l'horloge logicielle et des
+// compteurs de redémarrage par cause. Un CRC le protège d'une écriture
+// interrompue ou d'une mémoire non initialisée ; une empreinte de sa
+// disposition (tailles et positions des champs, structures incluses
+// comprises) écarte le bloc d'un firmware dont la disposition diffère, même
+// à taille égale. REPRISE_VERSION reste à incrémenter quand le sens d'un
+// champ change sans que sa disposition bouge.
+// Au démarrage, une cause éligible et un bloc valide permettent à setup()
+// de reprendre la régulation sans attendre le WiFi ni le front de seconde
+// du RTC. Après REPRISE_CRASHS_MAX paniques/watchdogs d'affilée, l'état
+// restauré est suspect : démarrage à froid.
+// Aucune dépendance Arduino.
+
+#pragma once
+
+#include <stdint.h>
+#include "controle.h"
+#include "capteur.h"
+#include "prechauffe.h"
+#include "conso.h"
+
+const uint32_t REPRISE_MAGIC = 0x52505354;      // "RPST"
+const uint16_t REPRISE_VERSION = 2;
+const uint8_t REPRISE_CRASHS_MAX = 3;
+const uint32_t REPRISE_STABLE_MS = 600000;      // crashs oubliés après 10 min de marche
+
+enum CauseReset : uint8_t {
+  CauseAlimentation,   // mise sous tension, bouton reset
+  CauseLogiciel,       // ESP.restart(), fin de mise à jour
+  CausePanique,
+  CauseWatchdog,       // watchdog d'interruption, de tâche ou matériel
+  CauseBrownout,
+  CauseAutre,
+  NbCausesReset
+};
+
+struct EtatReprise {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t taille;
+  uint32_t disposition;       // empreinte de la disposition du bloc
+
+  // Compteurs depuis la dernière mise sous tension
+  uint16_t resets[NbCausesReset];
+  uint8_t crashsConsecutifs;
+  uint8_t derniereCause;
+  uint16_t dureeChaudMs;      // dernier démarrage -> régulation, à chaud
+  uint16_t dureeFroidMs;      // idem à froid
+
+  // État de la régulation, valable si controle
+  bool controle;
+  bool manuel;
+  bool relais;
+  centi_t tempAct;
+  centi_t tempCible;
+  int16_t tempRaw;
+  uint32_t msSauve;           // millis() à la sauvegarde
+  uint32_t unixSauve;         // heure locale à la sauvegarde
+  int32_t derivePpm;
+  PolitiqueResolution resolution;
+  Prechauffe prechauffe;
+  Consommation conso;
+
+  uint16_t crc;
+
+  bool valide() const;
+  void scelle();
+
+  // Bilan du démarrage (cause déjà classée) : remet le bloc à zéro s'il
+  // est invalide, compte la cause ; retourne true si la reprise à chaud
+  // est possible
+  bool demarrage(CauseReset cause);
+
+  // Recale une date millis() de l'ancienne exécution sur la nouvelle,
+  // ecouleS secondes s'étant écoulées depuis la sauvegarde
+  uint32_t recale(uint32_t ancienMs, uint32_t maintenantMs, uint32_t ecouleS) const {
+    return ancienMs - msSauve + maintenantMs - ecouleS * 1000;
+  }
+};
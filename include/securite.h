@@ -0,0 +1,61 @@
+// Règles de sécurité du relais
+// Indépendantes de la régulation : le relais n'est fermé que si la
+// régulation le demande ET qu'aucune règle ne s'y oppose.
+//  - mesure périmée : aucune mesure valide depuis SECURITE_FRAICHEUR_MS
+//    (boucle bloquée, capteur débranché) ;
+//  - surchauffe : coupure absolue au-delà de SECURITE_TEMP_MAX, verrouillée
+//    jusqu'à redescendre de SECURITE_HYSTERESIS ;
+//  - marche continue maximale : après SECURITE_MARCHE_MAX_MS relais fermé
+//    sans interruption (sonde décollée du tapis), repos forcé.
+// Aucune dépendance Arduino : évaluée par tools/sim_superviseur.cpp.
+
+#pragma once
+
+#include <stdint.h>
+#include "controle.h"
+
+enum DefautSecurite : uint8_t {
+  DefautAucun,
+  DefautMesurePerimee,
+  DefautSurchauffe,
+  DefautMarcheMax,
+  NbDefauts
+};
+
+const uint32_t SECURITE_FRAICHEUR_MS = 5000;
+const centi_t SECURITE_TEMP_MAX = 5500;        // au-dessus de la consigne max (50 °C)
+const centi_t SECURITE_HYSTERESIS = 500;
+const uint32_t SECURITE_MARCHE_MAX_MS = 3UL * 3600 * 1000;
+const uint32_t SECURITE_REPOS_MS = 10UL * 60 * 1000;
+
+struct Securite {
+  // Entrées
+  bool demande;          // décision de la régulation
+  centi_t temp;          // dernière mesure valide
+  uint32_t mesureMs;
+  bool mesureRecue;
+
+  // Sortie et état
+  bool relais;
+  uint32_t relaisDepuisMs;   // dernier changement d'état du relais
+  bool surchauffe;
+  bool repos;
+  uint32_t reposDepuisMs;
+  DefautSecurite defaut;
+
+  void reset() {
+    demande = mesureRecue = relais = surchauffe = repos = false;
+    temp = 0;
+    mesureMs = relaisDepuisMs = reposDepuisMs = 0;
+    defaut = DefautAucun;
+  }
+
+  void mesure(centi_t t, uint32_t ms) {
+    temp = t;
+    mesureMs = ms;
+    mesureRecue = true;
+  }
+
+  // Applique les règles à l'instant ms ; retourne l'état du relais
+  bool decide(uint32_t ms);
+};
@@ -0,0 +1,28 @@
+// Superviseur de sécurité
+// Tâche FreeRTOS de priorité supérieure à loop(), seule à piloter le relais.
+// La boucle ne fait que transmettre sa demande et ses mesures ; si elle se
+// bloque (scan WiFi, mise à jour, connexion), le superviseur coupe le relais
+// au plus SECURITE_FRAICHEUR_MS + SUPERVISEUR_PERIODE_MS après la dernière
+// mesure. La tâche est inscrite au watchdog matériel des tâches : si elle
+// cesse elle-même de tourner, l'ESP32 redémarre et le relais retombe.
+
+#pragma once
+
+#include <Arduino.h>
+#include "securite.h"
+
+const uint32_t SUPERVISEUR_PERIODE_MS = 500;
+const uint32_t SUPERVISEUR_WDT_S = 5;
+
+// Crée la tâche ; le relais reste ouvert jusqu'à la première mesure
+void beginSuperviseur(int pinRelais);
+
+// Demande de la régulation, appliquée immédiatement si les règles le permettent
+void superviseurDemande(bool chauffe);
+
+// Nouvelle mesure valide
+void superviseurMesure(centi_t temp);
+
+// État réel du relais et règle active
+bool superviseurRelais();
+DefautSecurite superviseurDefaut();
@@ -0,0 +1,64 @@
+// Tableau de bord web
+// Page unique (web/tableau.html) compressée gzip à la génération
+// (tools/gen_tableau.py -> include/tableau_page.h), servie telle quelle
+// depuis la flash avec Content-Encoding: gzip, ETag et Cache-Control : une
+// visite suivante ne coûte qu'un 304. L'état est poussé par Server-Sent
+// Events sur /evenements, un flux par client : premier événement complet,
+// puis les seuls champs modifiés, au plus un événement par
+// TABLEAU_INTERVALLE_MS. /etat renvoie l'état complet en JSON.
+// Coût borné : TABLEAU_CLIENTS_MAX connexions au plus (au-delà, ou sous
+// TABLEAU_TAS_MIN de tas libre, réponse 503), un client qui ne lit plus est
+// déconnecté. Tas pris par chaque flux et temps de service mesurés,
+// rapportés par exportTableau() (commande série "tableau").
+// POST /commande prend en corps une ligne de réglage (consigne, programme,
+// date : voir appliqueReglage() dans main.cpp), seule voie de réglage d'une
+// unité sans écran :
+//   curl --data "consigne 21.5" http://<adresse>/commande
+// Réponse 204 si le réglage est appliqué, 400 sinon.
+// Le serveur est servi depuis loop(), sans tâche ni bibliothèque.
+
+#pragma once
+
+#include <Arduino.h>
+#include "controle.h"
+
+const uint16_t TABLEAU_PORT = 80;
+const int TABLEAU_CLIENTS_MAX = 3;                 // connexions simultanées, flux compris
+const uint32_t TABLEAU_TAS_MIN = 40000;            // tas libre minimal pour accepter
+const unsigned long TABLEAU_REQUETE_MS = 2000;     // en-têtes complets sous 2 s
+const unsigned long TABLEAU_INTERVALLE_MS = 1000;  // événements espacés d'au moins
+const unsigned long TABLEAU_VEILLE_MS = 15000;     // commentaire de maintien sans événement
+const unsigned long TABLEAU_CACHE_S = 3600;        // page fraîche sans revalidation
+const size_t TABLEAU_COMMANDE_MAX = 64;            // corps d'un POST /commande
+
+// Ce que montre le tableau, à la résolution affichée (dixièmes de °C)
+struct EtatTableau {
+  int16_t tempAct;
+  int16_t tempCible;
+  bool relais;
+  bool manuel;
+  uint8_t defaut;
+};
+
+// Dixièmes de °C arrondis comme formatTemp()
+int16_t dixiemesTemp(centi_t temp);
+
+// Objet JSON des champs de e qui diffèrent de avant (tous si avant est
+// nul, avec la version) ; retourne sa longueur, 0 si rien n'a changé ou si
+// taille ne suffit pas
+size_t jsonTableau(char *buf, size_t taille, const EtatTableau &e, const EtatTableau *avant,
+                   const char *version);
+
+// Réglage reçu par POST /commande ; false s'il est refusé
+typedef bool (*CommandeTableau)(const char *commande);
+
+void beginTableau(const char *version, CommandeTableau commande);
+
+// Acceptation, requêtes et événements ; à appeler à chaque itération
+void updateTableau(const EtatTableau &e);
+
+// Une requête est en cours de lecture : loop() ne doit pas attendre
+bool tableauActif();
+
+// Clients, requêtes, octets, tas par flux, temps de service
+void exportTableau();
@@ -0,0 +1,80 @@
+// Page du tableau de bord (web/tableau.html), compressée gzip
+// Généré par tools/gen_tableau.py : ne pas modifier à la main
+// 2170 octets, 1085 compressés
+
+#pragma once
+
+#include <Arduino.h>
+
+const char TABLEAU_PAGE_ETAG[] = "\"f5c866c00b9a\"";
+const size_t TABLEAU_PAGE_TAILLE = 1085;
+static const uint8_t TABLEAU_PAGE_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x56, 0xdb, 0x6e, 0xdb, 0x46,
+  0x10, 0x7d, 0xe7, 0x57, 0x4c, 0x69, 0x34, 0xa0, 0x00, 0x5d, 0x6d, 0x37, 0x10, 0x48, 0x49, 0x45,
+  0xeb, 0xc4, 0x40, 0x0a, 0x34, 0x05, 0xea, 0xb4, 0x2f, 0x86, 0x1f, 0xd6, 0xe4, 0x50, 0xde, 0x78,
+  0x2f, 0xc4, 0xee, 0x92, 0x96, 0xaa, 0x08, 0xe8, 0xd7, 0xb4, 0x70, 0x9e, 0xfa, 0x0d, 0xd5, 0x9f,
+  0xf4, 0x4b, 0x3a, 0xbb, 0xa4, 0x65, 0xc7, 0x6e, 0x02, 0xd7, 0x0f, 0xa4, 0x38, 0x3b, 0x73, 0xf6,
+  0xcc, 0xd9, 0x99, 0x59, 0xcf, 0xbe, 0x2a, 0x74, 0xee, 0xd6, 0x15, 0xc2, 0x95, 0x93, 0x62, 0x11,
+  0xcd, 0xfc, 0x0b, 0x04, 0x53, 0xcb, 0x79, 0x5c, 0x9a, 0x98, 0x0c, 0x12, 0x1d, 0x83, 0xfc, 0x8a,
+  0x19, 0x8b, 0x6e, 0x1e, 0xd7, 0xae, 0x1c, 0x4c, 0xf7, 0x66, 0xc5, 0x24, 0xce, 0xe3, 0x86, 0xe3,
+  0x4d, 0xa5, 0x8d, 0x8b, 0x21, 0xd7, 0xca, 0xa1, 0x22, 0xb7, 0x1b, 0x5e, 0xb8, 0xab, 0x79, 0x81,
+  0x0d, 0xcf, 0x71, 0x10, 0x3e, 0xfa, 0x5c, 0x71, 0xc7, 0x99, 0x18, 0xd8, 0x9c, 0x09, 0x9c, 0x4f,
+  0x3c, 0x86, 0xe3, 0x4e, 0xe0, 0xe2, 0x1d, 0xab, 0xb8, 0xf5, 0x3b, 0xd4, 0x65, 0xc9, 0x94, 0x9b,
+  0x8d, 0x5a, 0x73, 0x34, 0xb3, 0x6e, 0xed, 0xdf, 0x97, 0xba, 0x58, 0x6f, 0x4a, 0x42, 0x4e, 0x27,
+  0x2f, 0xab, 0x15, 0xd8, 0xb5, 0x75, 0x28, 0x07, 0x35, 0xef, 0x5b, 0xa6, 0xec, 0xc0, 0xa2, 0xe1,
+  0x65, 0x26, 0x99, 0x59, 0x72, 0x95, 0x8e, 0xb3, 0x4b, 0x96, 0x5f, 0x2f, 0x8d, 0xae, 0x55, 0x91,
+  0x1e, 0x4c, 0x26, 0x93, 0x2c, 0xd7, 0x42, 0x9b, 0xf4, 0x00, 0x11, 0xb3, 0x82, 0xdb, 0x4a, 0xb0,
+  0x75, 0x5a, 0x0a, 0x5c, 0x65, 0xef, 0x6b, 0xeb, 0x78, 0xb9, 0x1e, 0x74, 0x8c, 0xd3, 0x9c, 0x1e,
+  0x68, 0xb6, 0x91, 0x64, 0x5c, 0x6d, 0x2a, 0x56, 0x14, 0x5c, 0x2d, 0xd3, 0xc9, 0xf0, 0x1b, 0x94,
+  0x84, 0xbd, 0x6a, 0x53, 0x48, 0x0f, 0x0f, 0xe9, 0xb3, 0xfd, 0x39, 0x19, 0x8f, 0xbf, 0xde, 0x46,
+  0x07, 0xc4, 0xa4, 0xfa, 0x2e, 0x77, 0x81, 0xde, 0xc0, 0xf2, 0xdf, 0x30, 0x3d, 0x26, 0x97, 0xf0,
+  0x75, 0x83, 0x7c, 0x79, 0xe5, 0xd2, 0x97, 0xe3, 0xf1, 0x36, 0x1a, 0x8a, 0xcd, 0x17, 0x77, 0xb7,
+  0x15, 0x23, 0x9d, 0x2e, 0xd1, 0xdd, 0x20, 0xaa, 0xec, 0x6e, 0xfb, 0x21, 0x61, 0x01, 0xa5, 0xa4,
+  0x4d, 0x81, 0x66, 0x70, 0xa9, 0x9d, 0xd3, 0x32, 0x9d, 0x78, 0x09, 0xb4, 0xe0, 0x05, 0x1c, 0x1c,
+  0x1d, 0x1d, 0x11, 0xb4, 0x56, 0x9b, 0x2e, 0xc9, 0x72, 0x3a, 0xde, 0x0e, 0x0b, 0x2c, 0xf7, 0xdf,
+  0xc7, 0xc7, 0xdb, 0x03, 0xc1, 0x51, 0x3d, 0xa0, 0x37, 0x9c, 0x12, 0xbf, 0x6e, 0x7d, 0x3a, 0x9d,
+  0x6e, 0xa3, 0xd9, 0xa8, 0x93, 0x79, 0xe6, 0x53, 0xa7, 0x57, 0xc1, 0x9b, 0xc5, 0x8c, 0x08, 0x29,
+  0xe0, 0xc5, 0x3c, 0xee, 0x12, 0x8c, 0x17, 0x83, 0x01, 0x79, 0x92, 0x75, 0x01, 0x7f, 0xff, 0x75,
+  0x32, 0x1b, 0x79, 0xaf, 0xe0, 0x0b, 0xb9, 0x60, 0xd6, 0xce, 0x63, 0x11, 0xb7, 0x51, 0x8b, 0x13,
+  0xad, 0x2c, 0x5f, 0x2a, 0xec, 0xdc, 0x67, 0xf7, 0xcf, 0x3d, 0xe0, 0x09, 0xbf, 0x14, 0xf8, 0x04,
+  0xb2, 0x75, 0xfc, 0x12, 0x72, 0x28, 0x91, 0x4f, 0x80, 0x03, 0xa4, 0x41, 0xc1, 0xb8, 0x7d, 0x80,
+  0xf7, 0x25, 0x90, 0x1f, 0x75, 0xf1, 0x14, 0x41, 0x32, 0x55, 0xa3, 0x78, 0x26, 0xc2, 0xd9, 0xee,
+  0x36, 0xaf, 0x0d, 0x77, 0xbb, 0xdb, 0x27, 0x38, 0x24, 0x3e, 0xab, 0xdd, 0x33, 0x71, 0x7e, 0x45,
+  0x63, 0xb9, 0x56, 0x4f, 0x40, 0x9a, 0xd6, 0xfe, 0x1f, 0x28, 0x55, 0x58, 0xf7, 0x27, 0x1a, 0x2f,
+  0xa8, 0x74, 0x14, 0xae, 0xc8, 0xef, 0x9f, 0xdf, 0xff, 0x98, 0x8d, 0x2a, 0x5a, 0x1d, 0x75, 0x07,
+  0x68, 0x73, 0xc3, 0x2b, 0xb7, 0x88, 0x46, 0x23, 0xf8, 0x45, 0x41, 0x29, 0xea, 0x15, 0x8c, 0xb0,
+  0x41, 0x85, 0x92, 0x4a, 0xcd, 0x42, 0x0a, 0x95, 0x41, 0xc9, 0xd1, 0x80, 0x44, 0x6b, 0xd9, 0x12,
+  0xa9, 0x6b, 0x65, 0x25, 0xd0, 0xf5, 0xa1, 0xaa, 0xa9, 0x11, 0x05, 0x5a, 0xb0, 0x58, 0x8b, 0xd0,
+  0x92, 0xb2, 0xb2, 0x20, 0x75, 0xc1, 0x4b, 0xbe, 0xbb, 0xb5, 0x51, 0xc3, 0x0c, 0xbc, 0x82, 0x39,
+  0x9c, 0xc7, 0xfa, 0x3a, 0xee, 0x43, 0x4c, 0x00, 0xb5, 0x41, 0xa8, 0x76, 0xb7, 0x86, 0xcb, 0xdd,
+  0x2d, 0x7a, 0x1b, 0x59, 0xda, 0x56, 0x0e, 0x5f, 0xd4, 0x97, 0xf9, 0x15, 0x86, 0xb9, 0xc0, 0x49,
+  0x62, 0xa0, 0x5e, 0x8a, 0x2f, 0xb2, 0x00, 0x74, 0x4a, 0x40, 0x9b, 0x08, 0xa0, 0xab, 0xb0, 0x14,
+  0xca, 0x5a, 0xe5, 0x8e, 0x12, 0x82, 0xa4, 0xe9, 0xc1, 0x06, 0x0c, 0xba, 0xda, 0x28, 0x68, 0x86,
+  0x4e, 0x9f, 0xf2, 0x15, 0x16, 0xc9, 0xa4, 0x97, 0xc1, 0xb6, 0xdf, 0x45, 0x84, 0x12, 0xfa, 0x1f,
+  0x31, 0x6d, 0x8d, 0x7c, 0x12, 0xd0, 0x07, 0xf4, 0x31, 0x38, 0x0c, 0x07, 0xf3, 0x96, 0x46, 0x19,
+  0x31, 0x6a, 0xe0, 0x5b, 0x88, 0x49, 0x7c, 0x92, 0x29, 0x8e, 0xb3, 0x3d, 0xa0, 0xb7, 0xb6, 0xb9,
+  0x84, 0x15, 0x66, 0xcc, 0xee, 0xa3, 0x8b, 0x3b, 0xec, 0xb6, 0x7a, 0x3e, 0x4b, 0xc6, 0xc7, 0x96,
+  0xda, 0xec, 0xfe, 0xf4, 0x5a, 0x77, 0x95, 0xe6, 0x41, 0x2a, 0xa3, 0x97, 0x86, 0x49, 0x89, 0x77,
+  0x38, 0x6d, 0xf5, 0x3c, 0x93, 0x23, 0x39, 0x3f, 0x22, 0xf9, 0xea, 0xbc, 0xb9, 0x80, 0x0f, 0x1f,
+  0xa0, 0xe9, 0xe0, 0xba, 0x3a, 0x4a, 0xe1, 0xcc, 0x19, 0x1a, 0x27, 0xd1, 0x36, 0x8b, 0xf6, 0xc8,
+  0x92, 0xbd, 0x4f, 0x74, 0x2f, 0xe8, 0x4f, 0xd4, 0x68, 0x23, 0x3a, 0x90, 0x6b, 0xe0, 0x0a, 0x3a,
+  0x23, 0x45, 0x93, 0xc5, 0x6f, 0x46, 0xd7, 0x43, 0xed, 0x0b, 0x67, 0xb8, 0x44, 0xf7, 0x5a, 0x84,
+  0x1a, 0xfa, 0x7e, 0xfd, 0xa6, 0x48, 0xae, 0x7b, 0x59, 0xf0, 0xe3, 0x25, 0x24, 0x08, 0x2f, 0x5e,
+  0xc0, 0xe9, 0xf9, 0xf5, 0x45, 0x8f, 0x98, 0x3a, 0x5c, 0xb9, 0x93, 0x76, 0xae, 0x51, 0xb8, 0xb7,
+  0x26, 0x9a, 0x1e, 0x3e, 0x13, 0x1f, 0xb1, 0x8d, 0xb6, 0xf7, 0x34, 0x7c, 0x29, 0x27, 0xce, 0x67,
+  0xf8, 0xb9, 0x6d, 0xda, 0x6a, 0xef, 0x3d, 0x42, 0x75, 0x94, 0xe2, 0x3d, 0x8a, 0xae, 0x1b, 0x83,
+  0x49, 0x4b, 0xdc, 0xd3, 0xb6, 0xe4, 0xa1, 0xf0, 0x06, 0x5e, 0x53, 0xd1, 0xbb, 0x33, 0x4d, 0x05,
+  0x89, 0x49, 0xfc, 0xa0, 0x05, 0xe2, 0x40, 0xc4, 0xd2, 0xe4, 0xd4, 0x15, 0x2a, 0x72, 0xbe, 0x17,
+  0xdc, 0x53, 0x09, 0xa4, 0x62, 0x5a, 0x28, 0xb8, 0x41, 0x1a, 0x7d, 0xbe, 0x84, 0xee, 0x02, 0xee,
+  0x5a, 0xe6, 0x61, 0x8c, 0xf4, 0x41, 0x5e, 0xd0, 0x1f, 0xce, 0x7e, 0x7a, 0x3b, 0xac, 0xfc, 0x45,
+  0x99, 0xc8, 0x61, 0xc1, 0x1c, 0xeb, 0x3d, 0x0c, 0x45, 0x63, 0x48, 0xe9, 0x47, 0x9b, 0x05, 0x09,
+  0xa9, 0x51, 0x7f, 0xc6, 0xb2, 0xb6, 0x90, 0xe4, 0x7e, 0x6f, 0xea, 0x51, 0x56, 0xfb, 0x4e, 0xe1,
+  0xb2, 0x26, 0xec, 0x94, 0x3a, 0x92, 0x2e, 0xda, 0x86, 0x2f, 0x99, 0xc3, 0xda, 0x50, 0x66, 0x60,
+  0xa8, 0xd7, 0x88, 0x07, 0xa7, 0xd6, 0x63, 0x96, 0xca, 0x06, 0x44, 0xcd, 0x07, 0x72, 0xf7, 0x51,
+  0xe2, 0xfe, 0x48, 0xec, 0xd0, 0x20, 0x2b, 0xd6, 0x67, 0x8e, 0x82, 0x60, 0x3e, 0x87, 0xc3, 0xfb,
+  0xcc, 0xb8, 0xf2, 0x77, 0x91, 0x56, 0xbe, 0x83, 0xfa, 0xa0, 0x48, 0x3d, 0x14, 0x10, 0xf0, 0xa0,
+  0xa0, 0x1b, 0x15, 0x26, 0x63, 0xf0, 0x12, 0xd1, 0x10, 0x70, 0xef, 0xb8, 0x44, 0x5d, 0xbb, 0x24,
+  0x28, 0xdc, 0xa7, 0x15, 0xfa, 0xf3, 0x39, 0x85, 0x6d, 0x50, 0x58, 0xec, 0x20, 0x49, 0xa7, 0x07,
+  0xe3, 0xa8, 0xd5, 0x97, 0x12, 0xdf, 0x46, 0xdd, 0xd1, 0x64, 0xfe, 0x9a, 0xe9, 0xc6, 0xd2, 0x6c,
+  0xd4, 0xfe, 0xa7, 0xf1, 0x2f, 0x89, 0xbe, 0x5e, 0xd8, 0x7a, 0x08, 0x00, 0x00
+};
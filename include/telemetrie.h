@@ -0,0 +1,57 @@
+// Télémétrie binaire sur le port série
+// Trame de 20 octets (petit-boutiste), protégée par un CRC-16/CCITT-FALSE,
+// encodée en COBS et terminée par un octet nul : les lignes de log texte
+// peuvent partager le port, le décodeur (tools/decode_telemetrie.py) les
+// écarte au CRC.
+//
+//  octet  champ        type     unité
+//   0     type         uint8    TELEMETRIE_TYPE
+//   1     ms           uint32   millis()
+//   5     raw          int16    brut DS18B20, 1/128 °C
+//   7     temp         int16    mesure retenue, 1/100 °C
+//   9     cible        int16    consigne, 1/100 °C
+//  11     etat         uint8    bits TELEMETRIE_* ci-dessous
+//  12     rssi         int8     dBm (0 = non connecté)
+//  13     resolution   uint8    bits de conversion du DS18B20
+//  14     boucleUs     uint32   durée active de l'itération précédente
+//  18     crc          uint16   sur les octets 0..17
+// Aucune dépendance Arduino.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "controle.h"
+
+const uint8_t TELEMETRIE_TYPE = 1;
+const size_t TELEMETRIE_TAILLE = 20;
+// COBS : un octet de surcoût pour moins de 254 octets, plus le délimiteur
+const size_t TELEMETRIE_TRAME_MAX = TELEMETRIE_TAILLE + 2;
+
+// Bits de l'octet etat
+const uint8_t TELEMETRIE_RELAIS = 0x01;       // état réel du relais
+const uint8_t TELEMETRIE_DEMANDE = 0x02;      // demande de la régulation
+const uint8_t TELEMETRIE_MANUEL = 0x04;       // consigne forcée
+const uint8_t TELEMETRIE_ECRAN = 0x08;        // écran allumé
+const uint8_t TELEMETRIE_DEFAUT_DECALAGE = 4; // bits 4..6 : DefautSecurite
+const uint8_t TELEMETRIE_WIFI = 0x80;         // WiFi associé
+
+struct MesureTelemetrie {
+  uint32_t ms;
+  int16_t raw;
+  centi_t temp;
+  centi_t cible;
+  uint8_t etat;
+  int8_t rssi;
+  uint8_t resolution;
+  uint32_t boucleUs;
+};
+
+uint16_t crc16Ccitt(const uint8_t *donnees, size_t n);
+
+// Encodage COBS de n octets (n < 254) ; retourne la taille écrite (n + 1)
+size_t cobsEncode(const uint8_t *src, size_t n, uint8_t *dst);
+
+// Trame complète (COBS + délimiteur) dans sortie[TELEMETRIE_TRAME_MAX] ;
+// retourne sa taille
+size_t encodeTelemetrie(const MesureTelemetrie &m, uint8_t *sortie);
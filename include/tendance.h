@@ -0,0 +1,119 @@
+// Statistiques glissantes et courbe de tendance
+// Minimum, maximum, moyenne de la température mesurée et taux de marche du
+// relais sur la dernière heure et les dernières 24 h, plus une courbe de
+// 24 h sur la largeur de l'écran (mesure et consigne).
+// Tout est tenu à jour à chaque mesure, en temps constant (amorti) et en
+// mémoire fixe, sans reparcourir l'historique :
+//  - les mesures sont agrégées par cases (1 min pour l'heure, 5 min pour
+//    les 24 h) : somme, minimum, maximum, nombre, mesures relais fermé ;
+//  - somme et comptes de la fenêtre sont cumulés : la case qui entre est
+//    ajoutée, celle qui sort retranchée ;
+//  - minimum et maximum glissants par file monotone d'indices de cases :
+//    une case n'y reste que tant qu'aucune case plus récente ne la domine,
+//    la tête est l'extrême de la fenêtre ;
+//  - la courbe garde par colonne (675 s, 128 colonnes = 24 h) les extrêmes
+//    de la mesure et de la consigne : une pointe brève reste visible.
+// La fenêtre couvre N cases closes plus la case en cours (1 h à 1 min
+// près, 24 h à 5 min près). Le taux de marche compte les mesures relais
+// fermé, la cadence des mesures étant régulière.
+// Environ 8 Ko en RAM, rien en Preferences : l'historique repart à zéro au
+// redémarrage. Aucune dépendance Arduino (tools/sim_tendance.cpp).
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "controle.h"
+
+const uint16_t TENDANCE_CASE_HEURE_S = 60;
+const uint16_t TENDANCE_CASES_HEURE = 60;
+const uint16_t TENDANCE_CASE_JOUR_S = 300;
+const uint16_t TENDANCE_CASES_JOUR = 288;
+const int TENDANCE_COLONNES = 128;                  // largeur de l'écran
+const uint16_t TENDANCE_COLONNE_S = 86400 / TENDANCE_COLONNES;
+
+struct StatsTendance {
+  uint32_t mesures;           // 0 : pas de mesure, valeurs à ignorer
+  centi_t min, max, moy;
+  uint16_t pourmilleRelais;
+};
+
+// Mesures d'une case
+struct CaseTendance {
+  int32_t somme;
+  centi_t min, max;
+  uint16_t mesures;
+  uint16_t relais;            // mesures relais fermé
+
+  void vide();
+  void ajoute(centi_t temp, bool relaisFerme);
+};
+
+// File d'indices de cases à valeurs monotones (tampon circulaire)
+template <uint16_t N>
+struct FileMonotone {
+  uint32_t indices[N];
+  uint16_t tete, taille;
+
+  void reset() { tete = 0; taille = 0; }
+  bool vide() const { return taille == 0; }
+  uint32_t premier() const { return indices[tete]; }
+  uint32_t dernier() const { return indices[(tete + taille - 1) % N]; }
+  void retirePremier() { tete = (tete + 1) % N; taille--; }
+  void retireDernier() { taille--; }
+  void ajoute(uint32_t i) { indices[(tete + taille) % N] = i; taille++; }
+};
+
+// Fenêtre glissante de N cases de dureeCase secondes
+template <uint16_t N>
+struct Fenetre {
+  uint16_t dureeCase;
+  bool datee;                 // une mesure reçue depuis reset()
+  uint32_t index;             // case en cours (temps / dureeCase)
+  CaseTendance courante;
+  CaseTendance cases[N];      // cases closes, case i en i % N
+  FileMonotone<N> minima;     // minimums croissants
+  FileMonotone<N> maxima;     // maximums décroissants
+  int64_t somme;              // cumul des cases closes de la fenêtre
+  uint32_t mesures, relais;
+
+  void reset(uint16_t duree);
+  // Mesure au temps (secondes, croissant) ; un temps qui recule reste dans
+  // la case en cours, un saut de plus de N cases vide la fenêtre
+  void ajoute(uint32_t temps, centi_t temp, bool relaisFerme);
+  StatsTendance stats() const;
+
+  // Clôt la case en cours et passe à la suivante
+  void ferme();
+};
+
+// Colonne de la courbe ; actMin > actMax : pas de mesure
+struct ColonneTendance {
+  centi_t actMin, actMax;
+  centi_t cibleMin, cibleMax;
+
+  void vide();
+};
+
+struct Courbe {
+  bool datee;
+  uint32_t index;             // colonne en cours (temps / TENDANCE_COLONNE_S)
+  ColonneTendance colonnes[TENDANCE_COLONNES];   // colonne i en i % TENDANCE_COLONNES
+  uint32_t modifications;     // change avec ce que montre la courbe
+
+  void reset();
+  void ajoute(uint32_t temps, centi_t temp, centi_t cible);
+  // x = 0 : la plus ancienne, TENDANCE_COLONNES - 1 : la colonne en cours
+  const ColonneTendance &colonne(int x) const {
+    return colonnes[(index + 1 + x) % TENDANCE_COLONNES];
+  }
+};
+
+struct Tendance {
+  Fenetre<TENDANCE_CASES_HEURE> heure;
+  Fenetre<TENDANCE_CASES_JOUR> jour;
+  Courbe courbe;
+
+  void reset();
+  void ajoute(uint32_t temps, centi_t temp, centi_t cible, bool relaisFerme);
+};
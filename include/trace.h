@@ -0,0 +1,93 @@
+// Traceur des étapes de loop()
+// Chaque étape instrumentée par TRACE(id) enregistre un intervalle (début
+// en cycles CPU, durée, étape) dans un tampon circulaire en RAM. Chaque
+// itération commence par une ancre qui relie le compteur de cycles au
+// timer µs, pour traverser les périodes de light sleep. Quand la partie
+// active d'une itération dépasse TRACE_SEUIL_MS, le tampon se fige et
+// garde les itérations qui ont précédé le gel ; la commande série "trace"
+// l'exporte au format Chrome trace-event (chrome://tracing, Perfetto)
+// puis le réarme.
+// Compilé seulement avec build_flags = -D TRACE_BOUCLE ; sinon TRACE()
+// ne génère rien. Compilé mais figé, une étape coûte un test de drapeau.
+
+#pragma once
+
+#include <Arduino.h>
+
+enum TraceEtape : uint8_t {
+  TraceIteration,   // ancre de début d'itération (pas un intervalle)
+  TraceOta,
+  TraceWifi,
+  TraceHorloge,
+  TraceCapteur,
+  TraceRelais,
+  TraceBoutons,
+  TraceMenu,
+  TraceRendu,
+  TraceEnvoi,
+  TraceTableau,
+  TraceTravail,     // partie active de l'itération (hors attente)
+  NbTraceEtapes
+};
+
+const int TRACE_TAILLE = 512;                 // puissance de 2
+const unsigned long TRACE_SEUIL_MS = 200;
+
+#if defined(TRACE_BOUCLE)
+
+struct TraceEvenement {
+  uint32_t debut;    // cycles (ancre : cycles au début de l'itération)
+  uint32_t duree;    // cycles (ancre : timer en µs, 32 bits bas)
+  uint8_t etape;
+};
+
+extern TraceEvenement traceTampon[TRACE_TAILLE];
+extern uint32_t traceTete;
+extern volatile bool traceActif;
+
+inline void traceEnregistre(uint8_t etape, uint32_t debut, uint32_t duree) {
+  TraceEvenement &e = traceTampon[traceTete & (TRACE_TAILLE - 1)];
+  e.debut = debut;
+  e.duree = duree;
+  e.etape = etape;
+  traceTete++;
+}
+
+// Intervalle borné par la portée de l'objet
+struct TraceIntervalle {
+  bool actif;
+  uint8_t etape;
+  uint32_t debut;
+
+  explicit TraceIntervalle(uint8_t e) : actif(traceActif), etape(e) {
+    if (actif) debut = ESP.getCycleCount();
+  }
+  ~TraceIntervalle() {
+    if (actif) traceEnregistre(etape, debut, ESP.getCycleCount() - debut);
+  }
+};
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE(etape) TraceIntervalle TRACE_CONCAT(traceIntervalle, __LINE__)(etape)
+
+// Active le traceur (fréquence CPU verrouillée au max pendant la capture)
+void beginTrace();
+
+// Début d'itération : ancre cycles / µs
+void traceIteration();
+
+// Fin de la partie active : gèle le tampon si elle dépasse TRACE_SEUIL_MS
+void traceFinTravail();
+
+// Export JSON trace-event sur le port série, puis réarmement
+void exportTrace();
+
+#else
+
+#define TRACE(etape) do {} while (0)
+inline void beginTrace() {}
+inline void traceIteration() {}
+inline void traceFinTravail() {}
+
+#endif
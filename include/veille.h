@@ -0,0 +1,17 @@
+// Gestion de la consommation : fréquence dynamique, modem-sleep WiFi
+// et light sleep entre deux échéances de contrôle.
+
+#pragma once
+
+#include <Arduino.h>
+
+// Configure le gestionnaire d'énergie de l'IDF (DFS, light sleep auto
+// quand le tickless idle est disponible)
+void beginVeille();
+
+// Modem-sleep WiFi : à appeler une fois WiFi.begin() lancé
+void activeModemSleep();
+
+// Light sleep explicite jusqu'à dureeMs ou un appui bouton
+// (à réserver aux périodes sans WiFi associé : la liaison n'est pas maintenue)
+void dormirLeger(unsigned long dureeMs, const int *pins, int nbPins);
@@ -0,0 +1,53 @@
+#include "balise.h"
+
+#include <stdlib.h>
+#include "telemetrie.h"
+
+// Bits de l'état qui déclenchent une balise (pas l'écran ni la demande,
+// qui bascule avec le relais)
+static const uint8_t ETAT_SIGNALE = TELEMETRIE_RELAIS | TELEMETRIE_MANUEL | TELEMETRIE_WIFI |
+                                    (uint8_t)(7 << TELEMETRIE_DEFAUT_DECALAGE);
+
+void versionBalise(const char *texte, uint8_t version[3]) {
+  for (int i = 0; i < 3; i++) {
+    version[i] = 0;
+    if (*texte == '\0') continue;
+    char *fin;
+    version[i] = (uint8_t)strtoul(texte, &fin, 10);
+    texte = *fin == '.' ? fin + 1 : fin;
+  }
+}
+
+bool baliseChange(const Balise &avant, const Balise &maintenant) {
+  if ((avant.etat ^ maintenant.etat) & ETAT_SIGNALE) return true;
+  if (avant.cible != maintenant.cible) return true;
+  return abs(avant.temp - maintenant.temp) >= BALISE_ECART_TEMP;
+}
+
+static void ecrit16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void ecrit32(uint8_t *p, uint32_t v) {
+  ecrit16(p, (uint16_t)v);
+  ecrit16(p + 2, (uint16_t)(v >> 16));
+}
+
+size_t encodeBalise(const Balise &b, uint8_t *sortie) {
+  sortie[0] = BALISE_TYPE;
+  sortie[1] = BALISE_FORMAT;
+  ecrit32(sortie + 2, b.id);
+  ecrit16(sortie + 6, b.sequence);
+  sortie[8] = b.version[0];
+  sortie[9] = b.version[1];
+  sortie[10] = b.version[2];
+  ecrit16(sortie + 11, (uint16_t)b.temp);
+  ecrit16(sortie + 13, (uint16_t)b.cible);
+  sortie[15] = b.etat;
+  sortie[16] = (uint8_t)b.rssi;
+  ecrit32(sortie + 17, b.disponibilite);
+  ecrit16(sortie + 21, b.periode);
+  ecrit16(sortie + 23, crc16Ccitt(sortie, BALISE_TAILLE - 2));
+  return BALISE_TAILLE;
+}
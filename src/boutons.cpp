@@ -0,0 +1,179 @@
+#include "boutons.h"
+
+Bouton btnHaut, btnBas, btnGauche, btnDroite;
+
+static Bouton *const boutons[] = { &btnHaut, &btnBas, &btnGauche, &btnDroite };
+static const int nbBoutons = sizeof(boutons) / sizeof(boutons[0]);
+
+// File d'événements ISR -> boucle
+static QueueHandle_t fileBoutons = nullptr;
+static const int tailleFile = 32;
+
+// Protège niveau/dernierFront entre l'ISR et le rattrapage dans la boucle
+static portMUX_TYPE muxBoutons = portMUX_INITIALIZER_UNLOCKED;
+
+// Front GPIO : anti-rebond par verrouillage puis dépôt dans la file
+static void IRAM_ATTR isrBouton(void *arg) {
+  Bouton *b = (Bouton *)arg;
+  uint32_t now = millis();
+  BaseType_t reveil = pdFALSE;
+
+  portENTER_CRITICAL_ISR(&muxBoutons);
+  uint8_t niveau = digitalRead(b->pin);
+  bool accepte = (now - b->dernierFront >= DEBOUNCE_MS) && niveau != b->niveau;
+  if (accepte) {
+    b->niveau = niveau;
+    b->dernierFront = now;
+  }
+  portEXIT_CRITICAL_ISR(&muxBoutons);
+
+  if (accepte) {
+    ButtonEvent ev = { b->index, niveau == LOW ? BtnPress : BtnRelease, now };
+    xQueueSendFromISR(fileBoutons, &ev, &reveil);
+  }
+  if (reveil) portYIELD_FROM_ISR();
+}
+
+void beginBoutons(int pinHaut, int pinBas, int pinGauche, int pinDroite) {
+  const int pins[] = { pinHaut, pinBas, pinGauche, pinDroite };
+  fileBoutons = xQueueCreate(tailleFile, sizeof(ButtonEvent));
+  for (int i = 0; i < nbBoutons; i++) {
+    Bouton *b = boutons[i];
+    b->pin = pins[i];
+    b->index = i;
+    pinMode(b->pin, INPUT_PULLUP);
+    b->niveau = digitalRead(b->pin);
+    b->dernierFront = millis();
+    b->enfonce = (b->niveau == LOW);
+    attachInterruptArg(b->pin, isrBouton, b, CHANGE);
+  }
+}
+
+// Un front perdu pendant le verrouillage laisse un niveau différent de l'état
+// accepté : on le rattrape une fois la fenêtre d'anti-rebond écoulée
+static void rattrapeFronts(uint32_t now) {
+  for (int i = 0; i < nbBoutons; i++) {
+    Bouton *b = boutons[i];
+    bool rattrape = false;
+    uint8_t niveau;
+
+    portENTER_CRITICAL(&muxBoutons);
+    niveau = digitalRead(b->pin);
+    if (now - b->dernierFront >= DEBOUNCE_MS && niveau != b->niveau) {
+      b->niveau = niveau;
+      b->dernierFront = now;
+      rattrape = true;
+    }
+    portEXIT_CRITICAL(&muxBoutons);
+
+    if (rattrape) {
+      ButtonEvent ev = { b->index, niveau == LOW ? BtnPress : BtnRelease, now };
+      xQueueSend(fileBoutons, &ev, 0);
+    }
+  }
+}
+
+// Auto-repeat et long appui des boutons maintenus (délais delay1/delay2/rate1/rate2)
+static void genereRepetitions(uint32_t now) {
+  for (int i = 0; i < nbBoutons; i++) {
+    Bouton *b = boutons[i];
+    if (!b->enfonce) continue;
+
+    unsigned long held = now - b->pressedSince;
+    unsigned long interval = 0;
+    if (held > delay2) {
+      interval = rate2;    // très rapide
+    } else if (held > delay1) {
+      interval = rate1;    // rapide
+    }
+    if (interval > 0 && now - b->lastRepeat >= interval) {
+      b->lastRepeat = now;
+      ButtonEvent ev = { b->index, BtnRepeat, now };
+      xQueueSend(fileBoutons, &ev, 0);
+    }
+
+    if (!b->longFait && held >= LONG_PRESS_MS) {
+      b->longFait = true;
+      ButtonEvent ev = { b->index, BtnLongPress, now };
+      xQueueSend(fileBoutons, &ev, 0);
+    }
+  }
+}
+
+void updateBoutons() {
+  uint32_t now = millis();
+
+  for (int i = 0; i < nbBoutons; i++) {
+    Bouton *b = boutons[i];
+    b->appui = b->relache = b->repete = b->longAppui = false;
+  }
+
+  rattrapeFronts(now);
+  genereRepetitions(now);
+
+  ButtonEvent ev;
+  while (xQueueReceive(fileBoutons, &ev, 0) == pdTRUE) {
+    Bouton *b = boutons[ev.btn];
+    switch (ev.type) {
+      case BtnPress:
+        b->appui = true;
+        b->enfonce = true;
+        b->longFait = false;
+        b->pressedSince = ev.time;
+        b->lastRepeat = ev.time;
+        break;
+      case BtnRelease:
+        b->relache = true;
+        b->enfonce = false;
+        break;
+      case BtnRepeat:
+        if (b->enfonce) b->repete = true;
+        break;
+      case BtnLongPress:
+        if (b->enfonce) b->longAppui = true;
+        break;
+    }
+  }
+}
+
+bool activiteBoutons() {
+  for (int i = 0; i < nbBoutons; i++) {
+    Bouton *b = boutons[i];
+    if (b->appui || b->relache || b->enfonce) return true;
+  }
+  return false;
+}
+
+unsigned long prochaineEcheanceBoutons(unsigned long maxMs) {
+  uint32_t now = millis();
+  long attente = maxMs;
+
+  for (int i = 0; i < nbBoutons; i++) {
+    Bouton *b = boutons[i];
+    if (!b->enfonce) continue;
+    long held = now - b->pressedSince;
+    long echeance;
+    if (held > (long)delay2) {
+      echeance = (long)(b->lastRepeat + rate2 - now);
+    } else if (held > (long)delay1) {
+      echeance = (long)(b->lastRepeat + rate1 - now);
+    } else {
+      echeance = delay1 + 1 - held;
+    }
+    if (!b->longFait) {
+      echeance = min(echeance, (long)LONG_PRESS_MS - held);
+    }
+    attente = min(attente, echeance);
+  }
+  // Échéance déjà dépassée : pas d'attente
+  return attente > 0 ? attente : 0;
+}
+
+bool attenteBoutons(unsigned long timeoutMs) {
+  if (!fileBoutons) {
+    vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+    return false;
+  }
+  ButtonEvent ev;
+  return xQueuePeek(fileBoutons, &ev, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
@@ -0,0 +1,113 @@
+#include "bus.h"
+
+#include <Wire.h>
+
+static int pinSdaBus = -1;
+static int pinSclBus = -1;
+static SemaphoreHandle_t verrouBus = nullptr;
+static StatsBus stats[NbPeripheriquesBus];
+static uint32_t deblocages = 0;
+
+static const char *const nomsPeripheriques[NbPeripheriquesBus] = {"ecran", "rtc"};
+
+static void demarreControleur() {
+  Wire.begin(pinSdaBus, pinSclBus, BUS_FREQUENCE);
+  Wire.setTimeOut(BUS_DELAI_MS);
+}
+
+void beginBus(int pinSda, int pinScl) {
+  pinSdaBus = pinSda;
+  pinSclBus = pinScl;
+  verrouBus = xSemaphoreCreateMutex();
+  // Un esclave peut être resté au milieu d'un octet pendant un reset
+  pinMode(pinSda, INPUT_PULLUP);
+  if (digitalRead(pinSda) == LOW) {
+    busDebloque();
+  } else {
+    demarreControleur();
+  }
+}
+
+bool busDebloque() {
+  Wire.end();
+  pinMode(pinSdaBus, INPUT_PULLUP);
+  pinMode(pinSclBus, OUTPUT_OPEN_DRAIN);
+  digitalWrite(pinSclBus, HIGH);
+  delayMicroseconds(5);
+  // L'esclave termine l'octet en cours : SDA remonte au plus après 9 coups
+  for (int i = 0; i < 9 && digitalRead(pinSdaBus) == LOW; i++) {
+    digitalWrite(pinSclBus, LOW);
+    delayMicroseconds(5);
+    digitalWrite(pinSclBus, HIGH);
+    delayMicroseconds(5);
+  }
+  // STOP : SDA monte pendant que SCL est haute
+  pinMode(pinSdaBus, OUTPUT_OPEN_DRAIN);
+  digitalWrite(pinSdaBus, LOW);
+  delayMicroseconds(5);
+  digitalWrite(pinSdaBus, HIGH);
+  delayMicroseconds(5);
+  pinMode(pinSdaBus, INPUT_PULLUP);
+  bool libre = digitalRead(pinSdaBus) == HIGH;
+
+  demarreControleur();
+  deblocages++;
+  Serial.printf("Bus I2C: deblocage %s\n", libre ? "reussi" : "sans effet (SDA basse)");
+  return libre;
+}
+
+TransactionBus::TransactionBus(PeripheriqueBus p, uint16_t octets) : periph(p), nb(octets) {
+  uint32_t demande = micros();
+  if (verrouBus) xSemaphoreTake(verrouBus, portMAX_DELAY);
+  debutUs = micros();
+  uint32_t attente = debutUs - demande;
+  if (attente > stats[p].attenteMaxUs) stats[p].attenteMaxUs = attente;
+}
+
+TransactionBus::~TransactionBus() {
+  uint32_t duree = micros() - debutUs;
+  StatsBus &s = stats[periph];
+  s.transactions++;
+  s.octets += nb;
+  s.totalUs += duree;
+  if (duree > s.maxUs) s.maxUs = duree;
+
+  // Bus au repos : SDA doit être haute
+  if (duree >= BUS_DELAI_MS * 1000UL || digitalRead(pinSdaBus) == LOW) {
+    s.erreurs++;
+    busDebloque();
+  }
+  if (verrouBus) xSemaphoreGive(verrouBus);
+}
+
+void busEnvoieEcran(Profil::Ecran &ecran) {
+  uint8_t largeur = ecran.getBufferTileWidth();
+  uint8_t pages = ecran.getBufferTileHeight();
+  for (uint8_t p = 0; p < pages; p++) {
+    // Page : positionnement (3 commandes) + largeur × 8 octets
+    TransactionBus t(BusEcran, largeur * 8 + 4);
+    ecran.updateDisplayArea(0, p, largeur, 1);
+  }
+}
+
+const StatsBus &busStats(PeripheriqueBus p) {
+  return stats[p];
+}
+
+uint32_t busDeblocages() {
+  return deblocages;
+}
+
+void exportBus() {
+  Serial.printf("Bus I2C %lu Hz, %lu deblocages\n", (unsigned long)BUS_FREQUENCE,
+                (unsigned long)deblocages);
+  Serial.println("peripherique,transactions,octets,moyenne_us,max_us,attente_max_us,erreurs");
+  for (int i = 0; i < NbPeripheriquesBus; i++) {
+    const StatsBus &s = stats[i];
+    Serial.printf("%s,%lu,%lu,%lu,%lu,%lu,%lu\n", nomsPeripheriques[i],
+                  (unsigned long)s.transactions, (unsigned long)s.octets,
+                  (unsigned long)(s.transactions ? s.totalUs / s.transactions : 0),
+                  (unsigned long)s.maxUs, (unsigned long)s.attenteMaxUs,
+                  (unsigned long)s.erreurs);
+  }
+}
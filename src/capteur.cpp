@@ -0,0 +1,27 @@
+#include "capteur.h"
+
+static int32_t absolu(int32_t v) {
+  return v < 0 ? -v : v;
+}
+
+uint8_t PolitiqueResolution::echantillon(centi_t temp, centi_t cible) {
+  if (nbEchantillons < 0xFFFF) nbEchantillons++;
+
+  int32_t ecart = absolu((int32_t)cible - temp);
+  uint8_t voulu;
+
+  if (nbEchantillons <= ECHANTILLONS_DEMARRAGE) {
+    voulu = 10;
+  } else if (bits == 10) {
+    // Sortie du 10 bits seulement une fois nettement rapproché
+    voulu = ecart < ECART_10_SORTIE ? 12 : 10;
+  } else {
+    voulu = ecart >= ECART_10_ENTREE ? 10 : 12;
+  }
+
+  if (voulu != bits) {
+    bits = voulu;
+    nbChangements++;
+  }
+  return bits;
+}
@@ -0,0 +1,57 @@
+#include "conso.h"
+
+#include <stdio.h>
+
+void Consommation::reset(uint16_t puissance) {
+  watts = puissance;
+  heure = 0;
+  resteMs = 0;
+  for (int i = 0; i < CONSO_HEURES; i++) heures[i] = 0;
+  for (int i = 0; i < CONSO_JOURS; i++) jours[i] = 0;
+  totalSecondes = 0;
+}
+
+bool Consommation::avance(uint32_t unixtime, bool relais, uint32_t dureeMs) {
+  uint32_t h = unixtime / 3600;
+  bool change = heure != 0 && h != heure;
+
+  if (heure == 0) {
+    heure = h;
+  } else if (h > heure) {
+    // Cases des heures et jours écoulés depuis la dernière mise à jour
+    uint32_t sautH = h - heure < (uint32_t)CONSO_HEURES ? h - heure : CONSO_HEURES;
+    for (uint32_t k = 1; k <= sautH; k++) heures[(h - sautH + k) % CONSO_HEURES] = 0;
+    uint32_t j = heure / 24, jNouveau = h / 24;
+    uint32_t sautJ = jNouveau - j < (uint32_t)CONSO_JOURS ? jNouveau - j : CONSO_JOURS;
+    for (uint32_t k = 1; k <= sautJ; k++) jours[(jNouveau - sautJ + k) % CONSO_JOURS] = 0;
+    heure = h;
+  } else if (h < heure) {
+    // Horloge reculée (réglage manuel) : on continue dans la case courante
+    heure = h;
+  }
+
+  if (relais) {
+    resteMs += dureeMs;
+    uint32_t s = resteMs / 1000;
+    resteMs %= 1000;
+    uint16_t &caseH = heures[heure % CONSO_HEURES];
+    caseH = caseH + s > 3600 ? 3600 : caseH + s;
+    jours[(heure / 24) % CONSO_JOURS] += s;
+    totalSecondes += s;
+  }
+  return change;
+}
+
+uint16_t Consommation::secondesHeure(int ilYa) const {
+  if (heure == 0 || ilYa < 0 || ilYa >= CONSO_HEURES) return 0;
+  return heures[(heure - ilYa) % CONSO_HEURES];
+}
+
+uint32_t Consommation::secondesJour(int ilYa) const {
+  if (heure == 0 || ilYa < 0 || ilYa >= CONSO_JOURS) return 0;
+  return jours[(heure / 24 - ilYa) % CONSO_JOURS];
+}
+
+void formatKwh(char *buf, size_t taille, uint32_t wh) {
+  snprintf(buf, taille, "%lu.%03lu", (unsigned long)(wh / 1000), (unsigned long)(wh % 1000));
+}
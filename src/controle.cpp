@@ -0,0 +1,72 @@
+#include "controle.h"
+
+#include <stdio.h>
+
+// (1 - cos(pi * i / 32)) / 2 sur 0..65535, i = 0..32
+static const uint16_t tableS[33] = {
+  0, 158, 630, 1411, 2494, 3869, 5522, 7438, 9597, 11980, 14563, 17321,
+  20228, 23256, 26375, 29556, 32767, 35979, 39160, 42279, 45307, 48214,
+  50972, 53555, 55938, 58097, 60013, 61666, 63041, 64124, 64905, 65377, 65535
+};
+
+centi_t rawToCenti(int32_t raw) {
+  // raw * 100 / 128 arrondi au plus proche, y compris en négatif
+  int32_t v = raw * 100;
+  return (centi_t)(v >= 0 ? (v + 64) >> 7 : -((-v + 64) >> 7));
+}
+
+// Fonction interpolation en S (table + interpolation linéaire)
+centi_t smoothStep(centi_t startTemp, centi_t endTemp, int startMinute, int endMinute, int nowMinute) {
+  // Cas avant/après la période
+  if (nowMinute < startMinute) return endTemp;
+  if (nowMinute > endMinute)   return endTemp;
+  if (endMinute == startMinute) return endTemp;
+
+  // Position dans la période en 1/256 de case de table
+  int32_t pos = (int32_t)(nowMinute - startMinute) * 32 * 256 / (endMinute - startMinute);
+  int idx = pos >> 8;
+  int32_t frac = pos & 0xFF;
+  int32_t s = tableS[idx];
+  if (idx < 32) s += ((int32_t)(tableS[idx + 1] - tableS[idx]) * frac) >> 8;
+
+  return (centi_t)(startTemp + (((int32_t)(endTemp - startTemp) * s + 32768) >> 16));
+}
+
+// Calcul de la température cible
+centi_t tempCibleProgramme(int minuteNow, int minuteDay, centi_t tempDay,
+                           int minuteNight, centi_t tempNight, int fadeDuration) {
+  // Cas normal (jour sans minuit)
+  if (minuteDay < minuteNight) {
+    if (minuteNow >= minuteDay && minuteNow < minuteNight) {
+      // On est en jour -> interpoler depuis la nuit
+      return smoothStep(tempNight, tempDay,
+                        minuteDay, minuteDay + fadeDuration, minuteNow);
+    } else {
+      // On est en nuit -> interpoler depuis le jour
+      return smoothStep(tempDay, tempNight,
+                        minuteNight, minuteNight + fadeDuration, minuteNow);
+    }
+  } else {
+    // Cas qui traverse minuit
+    if (minuteNow >= minuteDay || minuteNow < minuteNight) {
+      // Jour
+      return smoothStep(tempNight, tempDay,
+                        minuteDay, (minuteDay + fadeDuration) % (24*60), minuteNow);
+    } else {
+      // Nuit
+      return smoothStep(tempDay, tempNight,
+                        minuteNight, (minuteNight + fadeDuration) % (24*60), minuteNow);
+    }
+  }
+}
+
+void formatTemp(char *buf, size_t taille, centi_t temp) {
+  int32_t t = temp;
+  const char *signe = "";
+  if (t < 0) {
+    signe = "-";
+    t = -t;
+  }
+  int32_t dixiemes = (t + 5) / 10;
+  snprintf(buf, taille, "%s%ld.%ld", signe, (long)(dixiemes / 10), (long)(dixiemes % 10));
+}
@@ -0,0 +1,63 @@
+#include "deploiement.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int compareVersions(const char *a, const char *b) {
+  while (*a || *b) {
+    char *finA, *finB;
+    unsigned long x = strtoul(a, &finA, 10);
+    unsigned long y = strtoul(b, &finB, 10);
+    if (x != y) return x < y ? -1 : 1;
+    a = *finA == '.' ? finA + 1 : finA;
+    b = *finB == '.' ? finB + 1 : finB;
+    // Suffixe non numérique ("0.3-rc1") : ignoré
+    if (a == finA && *a) a = "";
+    if (b == finB && *b) b = "";
+  }
+  return 0;
+}
+
+uint16_t trancheDeploiement(uint32_t id, const char *version) {
+  // FNV-1a de "<id en hexadécimal>:<version>", puis mélange final de
+  // MurmurHash3 pour que le modulo ne dépende pas que des bits faibles
+  char texte[48];
+  snprintf(texte, sizeof(texte), "%08lx:%s", (unsigned long)id, version);
+  uint32_t h = 2166136261u;
+  for (const char *p = texte; *p; p++) {
+    h ^= (uint8_t)*p;
+    h *= 16777619u;
+  }
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return (uint16_t)(h % DEPLOIEMENT_TRANCHES);
+}
+
+uint16_t tranchesPourcentage(float pourcentage) {
+  if (!(pourcentage > 0)) return 0;
+  if (pourcentage >= 100) return DEPLOIEMENT_TRANCHES;
+  return (uint16_t)(pourcentage * (DEPLOIEMENT_TRANCHES / 100) + 0.5f);
+}
+
+DecisionDeploiement decideDeploiement(uint32_t id, const char *actuelle, const char *cible,
+                                      const RegleDeploiement &r) {
+  if (r.arrete) return DeploiementArrete;
+  if (r.versionMin && *r.versionMin && compareVersions(actuelle, r.versionMin) < 0) {
+    return DeploiementVersionMin;
+  }
+  if (r.cohorte) return DeploiementOui;
+  return trancheDeploiement(id, cible) < r.tranches ? DeploiementOui : DeploiementHorsTranche;
+}
+
+const char *texteDecision(DecisionDeploiement d) {
+  switch (d) {
+    case DeploiementOui:         return "eligible";
+    case DeploiementHorsTranche: return "hors tranche";
+    case DeploiementArrete:      return "deploiement arrete";
+    case DeploiementVersionMin:  return "version trop ancienne";
+  }
+  return "?";
+}
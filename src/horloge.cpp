@@ -0,0 +1,211 @@
+#include "horloge.h"
+#include "bus.h"
+
+#include <WiFi.h>
+#include <esp_sntp.h>
+#include <esp_timer.h>
+
+static RTC_DS3231 *rtcHorloge = nullptr;
+
+// Premier front (référence de la mesure de dérive) et incertitude sur son
+// instant (µs, demi-largeur de l'intervalle qui le contient)
+static uint32_t seedUnix = 0;
+static int64_t seedMicros = 0;
+static int64_t seedIncertitude = 0;
+
+// Dernier front : origine de l'extrapolation
+static uint32_t baseUnix = 0;
+static int64_t baseMicros = 0;
+static int32_t derivePpm = 0;
+
+// Sortie SQW : front horodaté dans l'ISR
+static volatile int64_t sqwMicros = 0;
+static volatile uint32_t sqwFronts = 0;
+static uint32_t sqwFrontsLus = 0;
+static bool sqwCablee = false;
+
+// Chasse au changement de seconde (sans SQW)
+static bool chasse = false;
+static uint8_t chasseSeconde = 0;
+static int64_t chasseAvant = 0;
+static unsigned long dernierResync = 0;
+
+// NTP
+static volatile bool ntpRecu = false;
+static unsigned long dernierNtp = 0;
+static bool ntpLance = false;
+
+static void IRAM_ATTR isrSqw() {
+  sqwMicros = esp_timer_get_time();
+  sqwFronts++;
+}
+
+static void ntpSynchro(struct timeval *) {
+  ntpRecu = true;
+}
+
+// Lecture de l'heure du RTC par le gestionnaire de bus ; instant : début
+// de la lecture, une fois le bus obtenu
+static DateTime litRtc(int64_t *instant = nullptr) {
+  TransactionBus t(BusRtc, BUS_OCTETS_RTC);
+  if (instant) *instant = esp_timer_get_time();
+  return rtcHorloge->now();
+}
+
+// Un front de seconde du RTC : unixRtc a commencé à l'instant micros, à
+// incertitude µs près
+static void front(uint32_t unixRtc, int64_t micros, int64_t incertitude) {
+  if (seedMicros == 0) {
+    seedUnix = unixRtc;
+    seedMicros = micros;
+    seedIncertitude = incertitude;
+  } else {
+    int64_t local = micros - seedMicros;
+    int64_t rtc = (int64_t)(unixRtc - seedUnix) * 1000000LL;
+    // Sans SQW, un front n'est connu qu'à une itération de boucle près
+    // (jusqu'à ~0.4 s écran éteint) : la dérive n'est publiée qu'une fois
+    // la base assez longue pour que les incertitudes des deux fronts
+    // tiennent sous HORLOGE_DERIVE_PRECISION_PPM (dix à vingt heures
+    // dans ce cas, quelques secondes avec SQW)
+    if (local > 0 && (seedIncertitude + incertitude) * 1000000LL <=
+                         (int64_t)HORLOGE_DERIVE_PRECISION_PPM * local) {
+      derivePpm = (int32_t)((rtc - local) * 1000000LL / local);
+    }
+  }
+  baseUnix = unixRtc;
+  baseMicros = micros;
+}
+
+// Réinitialise la mesure de dérive (RTC réglé à la main ou par NTP)
+static void reseed(uint32_t unixRtc, int64_t micros, int64_t incertitude) {
+  seedMicros = 0;
+  front(unixRtc, micros, incertitude);
+}
+
+void beginHorloge(RTC_DS3231 &rtc, int pinSqw) {
+  rtcHorloge = &rtc;
+  sqwCablee = pinSqw >= 0;
+
+  if (sqwCablee) {
+    rtc.writeSqwPinMode(DS3231_SquareWave1Hz);
+    pinMode(pinSqw, INPUT_PULLUP);
+    attachInterrupt(pinSqw, isrSqw, FALLING); // front descendant = incrément des secondes
+  }
+
+  // Attente du changement de seconde pour caler la phase
+  int64_t avant, instant;
+  DateTime debut = litRtc(&avant);
+  DateTime t = debut;
+  instant = avant;
+  unsigned long limite = millis() + 1100;
+  while (t.second() == debut.second() && (long)(millis() - limite) < 0) {
+    delay(2);
+    avant = instant;
+    t = litRtc(&instant);
+  }
+  reseed(t.unixtime(), avant + (instant - avant) / 2, (instant - avant) / 2);
+  sqwFrontsLus = sqwFronts;
+  dernierResync = millis();
+}
+
+void beginHorlogeRapide(RTC_DS3231 &rtc, int pinSqw, int32_t ppm) {
+  rtcHorloge = &rtc;
+  sqwCablee = pinSqw >= 0;
+
+  if (sqwCablee) {
+    rtc.writeSqwPinMode(DS3231_SquareWave1Hz);
+    pinMode(pinSqw, INPUT_PULLUP);
+    attachInterrupt(pinSqw, isrSqw, FALLING);
+  }
+
+  // Origine approchée ; pas de référence de dérive tant que la phase
+  // n'est pas connue (le premier front vrai la pose)
+  baseUnix = litRtc().unixtime();
+  baseMicros = esp_timer_get_time();
+  seedMicros = 0;
+  derivePpm = ppm;
+  sqwFrontsLus = sqwFronts;
+  dernierResync = millis() - HORLOGE_RESYNC_MS;
+}
+
+void beginNtp() {
+  if (ntpLance) return;
+  ntpLance = true;
+  sntp_set_time_sync_notification_cb(ntpSynchro);
+  configTzTime(HORLOGE_TZ, "pool.ntp.org", "time.google.com");
+}
+
+DateTime horlogeNow() {
+  int64_t ecoule = esp_timer_get_time() - baseMicros;
+  ecoule += ecoule * derivePpm / 1000000LL;
+  return DateTime(baseUnix + (uint32_t)(ecoule / 1000000LL));
+}
+
+// Compare le RTC à l'heure NTP et le corrige si besoin
+static void controleNtp() {
+  struct tm tmNtp;
+  if (!getLocalTime(&tmNtp, 0)) return;
+  DateTime ntp(tmNtp.tm_year + 1900, tmNtp.tm_mon + 1, tmNtp.tm_mday,
+               tmNtp.tm_hour, tmNtp.tm_min, tmNtp.tm_sec);
+  long ecart = (long)(ntp.unixtime() - horlogeNow().unixtime());
+  if (ecart >= HORLOGE_NTP_ECART_MAX || ecart <= -HORLOGE_NTP_ECART_MAX) {
+    Serial.printf("Horloge: RTC corrigé par NTP (%ld s)\n", ecart);
+    regleHorloge(ntp);
+  }
+}
+
+void updateHorloge() {
+  if (rtcHorloge == nullptr) return;
+  unsigned long now = millis();
+
+  if (sqwCablee) {
+    // Front SQW : la seconde RTC vient de changer, lecture juste après
+    if (sqwFronts != sqwFrontsLus && now - dernierResync >= HORLOGE_RESYNC_MS) {
+      sqwFrontsLus = sqwFronts;
+      int64_t t = sqwMicros;
+      front(litRtc().unixtime(), t, 0);
+      dernierResync = now;
+    }
+  } else if (chasse) {
+    // Relevé du RTC jusqu'au changement de seconde
+    int64_t t;
+    DateTime rtc = litRtc(&t);
+    if (rtc.second() != chasseSeconde) {
+      // Le front est entre les deux dernières lectures : on prend le milieu
+      front(rtc.unixtime(), chasseAvant + (t - chasseAvant) / 2, (t - chasseAvant) / 2);
+      chasse = false;
+      dernierResync = now;
+    } else {
+      chasseAvant = t;
+    }
+  } else if (now - dernierResync >= HORLOGE_RESYNC_MS) {
+    chasseSeconde = litRtc(&chasseAvant).second();
+    chasse = true;
+  }
+
+  // Correction du RTC par NTP à la première synchro puis toutes les heures
+  if (WiFi.status() == WL_CONNECTED && !ntpLance) beginNtp();
+  if (ntpRecu && (dernierNtp == 0 || now - dernierNtp >= HORLOGE_NTP_MS)) {
+    dernierNtp = now;
+    controleNtp();
+  }
+}
+
+void regleHorloge(const DateTime &dt) {
+  if (rtcHorloge == nullptr) return;
+  int64_t avant, apres;
+  {
+    TransactionBus t(BusRtc, BUS_OCTETS_RTC);
+    avant = esp_timer_get_time();
+    rtcHorloge->adjust(dt);
+    apres = esp_timer_get_time();
+  }
+  // Le RTC repart au début de la seconde réglée, pendant l'écriture
+  reseed(dt.unixtime(), avant + (apres - avant) / 2, (apres - avant) / 2);
+  chasse = false;
+  dernierResync = millis();
+}
+
+int32_t horlogeDerivePpm() {
+  return derivePpm;
+}
@@ -0,0 +1,94 @@
+#include "improv.h"
+
+#include <string.h>
+
+static const char ENTETE[] = "IMPROV";
+
+LectureImprov LecteurImprov::lit(uint8_t octet) {
+  if (etape < 6) {
+    if (octet == (uint8_t)ENTETE[etape]) {
+      somme = etape == 0 ? octet : (uint8_t)(somme + octet);
+      etape++;
+      return ImprovEnCours;
+    }
+    // En-tête rompu : l'octet peut en commencer un autre
+    etape = 0;
+    if (octet == (uint8_t)ENTETE[0]) {
+      somme = octet;
+      etape = 1;
+      return ImprovEnCours;
+    }
+    return ImprovTexte;
+  }
+  if (etape == 6) {
+    if (octet != IMPROV_VERSION) {
+      etape = 0;
+      return ImprovInvalide;
+    }
+  } else if (etape == 7) {
+    type = octet;
+  } else if (etape == 8) {
+    longueur = octet;
+  } else if ((size_t)etape - 9 < longueur) {
+    donnees[etape - 9] = octet;
+  } else {
+    // Somme de contrôle
+    bool valide = octet == somme;
+    etape = 0;
+    return valide ? ImprovPaquet : ImprovInvalide;
+  }
+  somme = (uint8_t)(somme + octet);
+  etape++;
+  return ImprovEnCours;
+}
+
+// Chaîne préfixée par sa longueur, copiée dans dst[taille] ; false si elle
+// dépasse les données ou la taille
+static bool litChaine(const uint8_t *&p, const uint8_t *fin, char *dst, size_t taille) {
+  if (p >= fin) return false;
+  size_t n = *p++;
+  if (n > (size_t)(fin - p) || n >= taille) return false;
+  memcpy(dst, p, n);
+  dst[n] = '\0';
+  p += n;
+  return true;
+}
+
+bool decodeCommande(const uint8_t *donnees, uint8_t longueur, CommandeImprov &c) {
+  if (longueur < 2 || donnees[1] != longueur - 2) return false;
+  c.rpc = donnees[0];
+  c.ssid[0] = '\0';
+  c.motDePasse[0] = '\0';
+  if (c.rpc != ImprovRpcWifi) return true;
+  const uint8_t *p = donnees + 2, *fin = donnees + longueur;
+  return litChaine(p, fin, c.ssid, sizeof(c.ssid)) && c.ssid[0] != '\0' &&
+         litChaine(p, fin, c.motDePasse, sizeof(c.motDePasse)) && p == fin;
+}
+
+size_t encodeImprov(uint8_t *sortie, ImprovType type, const uint8_t *donnees, uint8_t longueur) {
+  memcpy(sortie, ENTETE, 6);
+  sortie[6] = IMPROV_VERSION;
+  sortie[7] = type;
+  sortie[8] = longueur;
+  memcpy(sortie + 9, donnees, longueur);
+  uint8_t somme = 0;
+  for (size_t i = 0; i < 9u + longueur; i++) somme = (uint8_t)(somme + sortie[i]);
+  sortie[9 + longueur] = somme;
+  sortie[10 + longueur] = '\n';
+  return 11 + longueur;
+}
+
+size_t donneesResultat(uint8_t *sortie, uint8_t rpc, const char *const *chaines, int n) {
+  size_t t = 2;
+  for (int i = 0; i < n; i++) {
+    if (t >= 255) break;
+    size_t l = strlen(chaines[i]);
+    if (l > 255 - t - 1) l = 255 - t - 1;
+    sortie[t++] = (uint8_t)l;
+    memcpy(sortie + t, chaines[i], l);
+    t += l;
+  }
+  sortie[0] = rpc;
+  sortie[1] = (uint8_t)(t - 2);
+  return t;
+}
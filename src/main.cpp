@@ -1,6 +1,4 @@
-#include <U8g2lib.h>
 #include <Wire.h>
-#include <Bounce2.h>
 #include <DallasTemperature.h>
 #include <ArduinoOTA.h>
 #include <RTClib.h>
@@ -8,16 +6,41 @@
 #include <Preferences.h>
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
+#include <WiFiUdp.h>
 #include <HTTPClient.h>
 #include <HTTPUpdate.h>
 #include <ArduinoJson.h>
 #include "pins.h"
+#include "boutons.h"
+#include "veille.h"
+#include "energie.h"
+#include "controle.h"
+#include "icones.h"
+#include "polices.h"
+#include "horloge.h"
+#include "capteur.h"
+#include "prechauffe.h"
+#include "conso.h"
+#include "superviseur.h"
+#include "trace.h"
+#include "telemetrie.h"
+#include "reprise.h"
+#include "pairs.h"
+#include "partage.h"
+#include "balise.h"
+#include "rendu.h"
+#include "bus.h"
+#include "tableau.h"
+#include "improv.h"
+#include "tendance.h"
+#include "deploiement.h"
+#include <mbedtls/sha256.h>
+#include <esp_system.h>
+#include <esp_ota_ops.h>
 #include <regex>
 
-//Broches + Screen centralisées dans include/pins.h
-// Utilisation du constructeur SH1106 pour ton clone
-//U8G2_SH1106_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, /* reset=*/ U8X8_PIN_NONE);
-//U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, /* reset=*/ U8X8_PIN_NONE);
+//Broches + Screen centralisées dans le profil de la carte (include/profil.h)
+Profil::Ecran u8g2;
 
 // Save
 Preferences prefs;
@@ -29,38 +52,85 @@ RTC_DS3231 rtc;
 OneWire oneWire(PIN_ONEWIRE);
 DallasTemperature ds(&oneWire);
 
-// Broches des boutons (depuis include/pins.h)
-#define BTN_BAS     PIN_BTN_BAS
-#define BTN_GAUCHE  PIN_BTN_GAUCHE
-#define BTN_HAUT    PIN_BTN_HAUT
-#define BTN_DROITE  PIN_BTN_DROITE
-
-// Bounce2 pour chaque bouton
-Bounce btnHaut   = Bounce();
-Bounce btnBas    = Bounce();
-Bounce btnGauche = Bounce();
-Bounce btnDroite = Bounce();
-
-// Variables de suivi pour les boutons
-static unsigned long hautPressedSince = 0, hautLastRepeat = 0;
-static unsigned long basPressedSince  = 0, basLastRepeat  = 0;
-
-// Paramètres d'auto-repeat
-const unsigned long delay1 = 500;   // après 500ms -> repeat lent
-const unsigned long delay2 = 2500;   // après 2500ms -> repeat rapide
-const unsigned long rate1  = 500;    // vitesse lente : 500ms
-const unsigned long rate2  = 50;    // vitesse rapide : 100ms
-
-// variable long press
-unsigned long droitePressedAt = 0;
-const unsigned long LONG_PRESS_MS = 2000;
+// Boutons (voir include/boutons.h), broches depuis include/pins.h
+// Saisie texte : appui court sur droite armé dans l'écran courant
+bool droiteArme = false;
 
 // Affichage non bloquant du message "Saved !"
 unsigned long saveMsgUntil = 0;                 // moment où on cesse l'affichage
 const unsigned long saveMsgDuration = 2000;     // durée d'affichage en ms
 
+// Attente max de la boucle quand aucun bouton n'est actif
+const unsigned long loopIdleMax = 50;
+
 // Parametre de Prise de température
-const unsigned long tempDelay = 1000; // toutes les 1s
+// Résolution adaptative (voir include/capteur.h) : la période suit la
+// durée de conversion de la résolution active
+PolitiqueResolution resolution;
+unsigned long lastTempRequest = 0;
+bool conversionEnCours = false;
+
+// Mise en veille de l'écran après inactivité (réveil par n'importe quel bouton)
+const unsigned long ecranTimeout = 60000;
+bool ecranAllume = Profil::ECRAN;
+unsigned long derniereActivite = 0;
+
+// Light sleep seulement si l'attente vaut le coût d'entrée/sortie
+const unsigned long minLightSleep = 20;
+
+// Comptabilité énergétique, rapportée sur le port série
+ModeleEnergie energie;
+const unsigned long energieRapportDelay = 600000; // toutes les 10 min
+// Rendu de l'écran sur changement (voir include/rendu.h), rapporté avec l'énergie
+Rendu rendu;
+
+// Comptabilité de chauffe (voir include/conso.h), sauvegardée à chaque heure
+Consommation conso;
+
+// Statistiques glissantes et courbe de 24 h (voir include/tendance.h),
+// alimentées à chaque mesure
+Tendance tendance;
+
+// Port série : débit réglable (commande baud <n>, appliqué au démarrage)
+#ifndef SERIE_BAUD
+#define SERIE_BAUD 460800
+#endif
+
+// Télémétrie binaire (voir include/telemetrie.h), période en ms, 0 = coupée
+uint32_t telemetriePeriode = 0;
+unsigned long derniereTelemetrie = 0;
+// Balises UDP (voir include/balise.h), période en s, 0 = seulement les
+// réponses aux sondes
+uint16_t balisePeriode = BALISE_PERIODE_DEFAUT_S;
+WiFiUDP udpBalise;
+bool baliseOuverte = false;
+Balise derniereBalise = {};
+unsigned long derniereBaliseMs = 0;
+uint16_t baliseSequence = 0;
+int16_t tempRaw = 0;            // dernière mesure brute DS18B20 (1/128 °C)
+uint32_t boucleUs = 0;          // durée active de la dernière itération
+
+// Reprise à chaud (voir include/reprise.h) : bloc en mémoire RTC, mis à
+// jour à chaque mesure ; durée démarrage -> première régulation mesurée
+RTC_NOINIT_ATTR EtatReprise reprise;
+bool repriseChaude = false;
+bool controleRepris = false;
+void sauveReprise(DateTime now, bool relais);
+
+// Commande reçue sur le port série (conso, watts <n>, trace, telemetrie <ms>, baud <n>, reprise, balise <s>, bus, tableau, tendance)
+// ou réglage (consigne, programme, date), aussi reçu du tableau de bord
+char commandeSerie[48];
+size_t commandeLongueur = 0;
+bool appliqueReglage(const char *commande);
+
+// Provisionnement WiFi par le port série (voir include/improv.h) : paquets
+// Improv reconnus au milieu des commandes texte, connexion d'essai suivie
+// dans la boucle, identifiants sauvegardés seulement si elle aboutit
+LecteurImprov improv;
+bool improvConnexion = false;   // tentative en cours
+unsigned long improvDebut = 0;
+String improvSSID, improvPass;
+bool improvScan = false;        // scan asynchrone en cours
 
 // Variables d'état du menu
 enum ScreenState {
@@ -69,10 +139,12 @@ enum ScreenState {
   Date,
   Temp,
   Wifi,
-  Version
+  Version,
+  Stats,
+  TendanceEcran
 };
 ScreenState menuState = Accueil;
-// 0=Accueil, 1=Date, 2=Temp, 3=Wifi, 4=Version
+// 0=Accueil, 1=Date, 2=Temp, 3=Wifi, 4=Version, 5=Stats, 6=Tendance
 int menuIndex = 0;
 
 // Variables d'état du menu wifi
@@ -89,19 +161,36 @@ String wifiSSID = "Wokwi-GUEST";
 String wifiPass = "";
 String wifiSSIDTemp, wifiPassTemp;
 int charIndex = 0;          // index du caractère courant pour saisie pass
-const char charSet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789._-*$&@";
+// Tout l'ASCII imprimable : un mot de passe saisi au clavier doit pouvoir
+// l'être aussi aux boutons
+const char charSet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789._-*$&@ !#%+,/:;=?'\"()<>[\\]^`{|}~";
 
 // Variables d'état du menu version
 enum VersionSubState {
   VersionMain,
   VersionCheck,
   VersionUpdate,
-  VersionUpgrade
+  VersionUpgrade,
+  VersionPairs       // recherche d'un pair qui sert la version
 };
 VersionSubState versionState = VersionMain;
 bool stableVersion = true; // stable version or not
 String latestVersion = "";
 String latestmd5 = "";
+String latestSha256 = "";
+// Déploiement progressif (voir include/deploiement.h) : adresse des
+// rapports publiée par le manifeste, résultat de la dernière mise à jour
+// en attente d'envoi (namespace "deploie")
+String rapportURL = "";
+bool rapportEnAttente = false;
+bool rapportRetour = false;     // l'image démarrée n'est pas celle installée
+uint8_t rapportEssais = 0;
+unsigned long rapportProchain = 0;
+// Mise à jour en cours : recherche des pairs (voir include/pairs.h)
+Election election;
+unsigned long partageProchaine = 0;
+bool partageEnCours = false;
+bool partageImmediat = false;   // redémarrage après téléchargement depuis l'origine
 String currentVersion = "0.1";
 const char* manifestURL = "https://raw.githubusercontent.com/djfab59/ESP32-C3-Tapis-Chauffant/refs/heads/master/release/";
 
@@ -110,18 +199,20 @@ int day = 30, month = 12, year = 2025;
 int hour = 23, minute = 59;
 
 // Variables température
-float tempAct = 25.5;  // Température actuelle
-float tempCible = 25.0; // Température à atteindre
+// Températures en centièmes de degré (voir include/controle.h)
+centi_t tempAct = 2550;  // Température actuelle
+centi_t tempCible = 2500; // Température à atteindre
+DeviceAddress sondeAdresse; // adresse du DS18B20 pour la lecture brute
 
 // Variable Prog Temp
 int progHourDay = 9;
 int progMinuteDay = 30;
-float progTempDay = 25.5;
+centi_t progTempDay = 2550;
 int progHourNight = 19;
 int progMinuteNight = 0;
-float progTempNight = 20.5;
+centi_t progTempNight = 2050;
 int progHourDayTemp, progMinuteDayTemp, progHourNightTemp, progMinuteNightTemp;
-float progTempDayTemp, progTempNightTemp;
+int progTempDayTemp, progTempNightTemp; // en centièmes pendant l'édition
 
 // Variable forcage manuel de la température
 bool manualTemp = false;
@@ -129,8 +220,50 @@ bool manualTemp = false;
 // Durée de transition (2h = 120 minutes)
 const int fadeDuration = 120;
 
+// Préchauffe prédictive (voir include/prechauffe.h), paramètres appris
+// sauvegardés à chaque transition mesurée, soit au plus deux fois par jour
+Prechauffe prechauffe;
+// Décision du relais (hystérésis et durées minimales, voir include/controle.h)
+Thermostat thermostat;
+
+// Valeurs affichées sur l'écran d'accueil
+char dateStr[30];
+long rssi = 0;
+
+// Lecture d'une consigne en centièmes ; reprend l'ancienne clé float si besoin
+centi_t chargeTemp(const char *cle, const char *cleFloat, centi_t defaut) {
+  if (prefs.isKey(cle)) return prefs.getShort(cle, defaut);
+  if (prefs.isKey(cleFloat)) return (centi_t)lroundf(prefs.getFloat(cleFloat) * 100);
+  return defaut;
+}
+
+#if defined(BENCH_CONTROLE)
+void benchControle();
+#endif
+
+// Cause du dernier redémarrage
+CauseReset causeReset() {
+  switch (esp_reset_reason()) {
+    case ESP_RST_POWERON:
+    case ESP_RST_EXT:      return CauseAlimentation;
+    case ESP_RST_SW:       return CauseLogiciel;
+    case ESP_RST_PANIC:    return CausePanique;
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:      return CauseWatchdog;
+    case ESP_RST_BROWNOUT: return CauseBrownout;
+    default:               return CauseAutre;
+  }
+}
+
+const char *nomsCause[NbCausesReset] = {"alimentation", "logiciel", "panique", "watchdog", "brownout", "autre"};
+
 void setup() {
-  Serial.begin(9600);
+  repriseChaude = reprise.demarrage(causeReset());
+
+  prefs.begin("config", true);
+  Serial.begin(prefs.getUInt("baud", SERIE_BAUD));
+  prefs.end();
   Serial.print("Setup!");
 
   // Initialisation des préférences
@@ -139,97 +272,189 @@ void setup() {
   // Récupère les valeurs stockées, sinon met la valeur par défaut
   progHourDay   = prefs.getInt("hourDay",   progHourDay);
   progMinuteDay = prefs.getInt("minDay",    progMinuteDay);
-  progTempDay   = prefs.getFloat("tempDay", progTempDay);
+  progTempDay   = chargeTemp("tempDayC", "tempDay", progTempDay);
   progHourNight   = prefs.getInt("hourNight",   progHourNight);
   progMinuteNight = prefs.getInt("minNight",    progMinuteNight);
-  progTempNight   = prefs.getFloat("tempNight", progTempNight);
+  progTempNight   = chargeTemp("tempNightC", "tempNight", progTempNight);
   stableVersion = prefs.getBool("sversion", stableVersion);
+  telemetriePeriode = prefs.getUInt("telemetrie", telemetriePeriode);
+  balisePeriode = prefs.getUShort("balise", balisePeriode);
   currentVersion = prefs.getString("version", currentVersion);
+  partageImmediat = prefs.getBool("partageTot", false);
   // Ferme les préférences
   prefs.end();
+
+  // Résultat de la dernière mise à jour, rapporté une fois en marche
+  prefs.begin("deploie", true);
+  rapportEnAttente = prefs.isKey("vers");
+  uint32_t partitionInstallee = prefs.getUInt("partition", 0);
+  String versionPrecedente = prefs.getString("depuis", "");
+  prefs.end();
+  if (rapportEnAttente) {
+    const esp_partition_t *demarree = esp_ota_get_running_partition();
+    rapportRetour = demarree && demarree->address != partitionInstallee;
+    if (rapportRetour) {
+      // Retour à l'ancienne image : sa version redevient la version courante
+      Serial.printf("Retour a la version %s\n", versionPrecedente.c_str());
+      currentVersion = versionPrecedente;
+      prefs.begin("config", false);
+      prefs.putString("version", currentVersion);
+      prefs.end();
+    }
+  }
   prefs.begin("wifi", true);
   // Récupère les valeurs stockées, sinon met la valeur par défaut
   wifiSSID = prefs.getString("wifiSSID", wifiSSID);
   wifiPass = prefs.getString("wifiPass", wifiPass);
   // Ferme les préférences
   prefs.end();
+  prechauffe.reset();
+  thermostat.reset();
+  prefs.begin("prechauffe", true);
+  prechauffe.vitesseChauffe = prefs.getShort("vChauffe", 0);
+  prechauffe.vitesseRefroid = prefs.getShort("vRefroid", 0);
+  prechauffe.retard[TransitionJour] = prefs.getShort("retardJour", 0);
+  prechauffe.retard[TransitionNuit] = prefs.getShort("retardNuit", 0);
+  prefs.end();
+  prefs.begin("conso", true);
+  if (prefs.getBytesLength("etat") == sizeof(conso)) {
+    prefs.getBytes("etat", &conso, sizeof(conso));
+  } else {
+    conso.reset(CONSO_WATTS_DEFAUT);
+  }
+  prefs.end();
+  tendance.reset();
+
+  // Reprise à chaud : état de la régulation plus récent que les préférences
+  // (forçage manuel, comptabilité depuis la dernière heure, suivi en cours)
+  if (repriseChaude) {
+    Serial.printf("Reprise a chaud (%s), consigne %d%s\n", nomsCause[reprise.derniereCause],
+                  reprise.tempCible, reprise.manuel ? " manuelle" : "");
+    manualTemp = reprise.manuel;
+    tempCible = reprise.tempCible;
+    tempAct = reprise.tempAct;
+    tempRaw = reprise.tempRaw;
+    prechauffe = reprise.prechauffe;
+    conso = reprise.conso;
+    resolution = reprise.resolution;
+  } else {
+    resolution.reset(10);
+  }
 
   // Initialisation du capteur de température
   ds.begin();
-  ds.setResolution(12); // 11 bits → 375 ms → 0.125 °C , 12 bits → 750 ms → 0.0625 °C
+  ds.setAutoSaveScratchPad(false); // changements de résolution fréquents : pas d'écriture EEPROM
+  ds.setResolution(resolution.bits); // démarrage en 10 bits → 188 ms → 0.25 °C, jusqu'à 12 bits → 750 ms → 0.0625 °C
   ds.setWaitForConversion(false);  // pas d’attente bloquante
+  ds.getAddress(sondeAdresse, 0);
 
-  // Initialisation de l'écran
-  Wire.begin(PIN_SDA, PIN_SCL);
+  // Initialisation du bus I2C (voir include/bus.h) et de l'écran
+  beginBus(PIN_SDA, PIN_SCL);
+  u8g2.setBusClock(BUS_FREQUENCE);  // u8g2 règle l'horloge à chaque envoi
   u8g2.begin();
+  u8g2.setBitmapMode(1); // sprites transparents : seuls les bits à 1 sont dessinés
 
-  // Initialisation des boutons
-  pinMode(BTN_HAUT,   INPUT_PULLUP);
-  pinMode(BTN_BAS,    INPUT_PULLUP);
-  pinMode(BTN_GAUCHE, INPUT_PULLUP);
-  pinMode(BTN_DROITE, INPUT_PULLUP);
-
-  // Initialisation des objets Bounce
-  btnHaut.attach(BTN_HAUT);     btnHaut.interval(25);
-  btnBas.attach(BTN_BAS);       btnBas.interval(25);
-  btnGauche.attach(BTN_GAUCHE); btnGauche.interval(25);
-  btnDroite.attach(BTN_DROITE); btnDroite.interval(25);
-
-  // Initialisation du relais
-  pinMode(PIN_RELAY, OUTPUT);
-  // Éteint le relais
-  digitalWrite(PIN_RELAY, LOW);
-
-  // Initialisation du Wifi
-  u8g2.clearBuffer();
-  u8g2.setFont(u8g2_font_ncenB08_tr);
-  u8g2.drawStr(0, 8, "Wifi connecting...");
+  // Initialisation des boutons (interruptions + file d'événements)
+  if (Profil::BOUTONS) beginBoutons(PIN_BTN_HAUT, PIN_BTN_BAS, PIN_BTN_GAUCHE, PIN_BTN_DROITE);
+
+  // Fréquence dynamique / light sleep automatique
+  beginVeille();
+
+  // Initialisation du relais : piloté par le superviseur de sécurité,
+  // éteint jusqu'à la première mesure (voir include/superviseur.h)
+  beginSuperviseur(PIN_RELAY);
+
+  // Initialisation du Wifi ; à chaud la connexion se fait en tâche de fond
+  // (handleWiFiReconnect dans la boucle)
   WiFi.begin(wifiSSID, wifiPass);
-  unsigned long startAttemptTime = millis();
-  int x = 0;
-  // Attendre au max 10 secondes
-  while (WiFi.status() != WL_CONNECTED && millis() - startAttemptTime < 10000) {
-    delay(500);
-    u8g2.drawStr(x, 16, ".");
-    u8g2.sendBuffer();
-    x = x + 6;
-  }
-  u8g2.clearBuffer();
-  u8g2.setFont(u8g2_font_ncenB08_tr);
-  if (WiFi.status() == WL_CONNECTED) {
-    u8g2.drawStr(0, 24, "Wifi connected!!!");
-  } else {
-    u8g2.drawStr(0, 24, "Wifi failed (timeout)");
+  activeModemSleep();
+  if (!repriseChaude) {
+    u8g2.clearBuffer();
+    u8g2.setFont(u8g2_font_ncenB08_tr);
+    u8g2.drawStr(0, 8, "Wifi connecting...");
+    unsigned long startAttemptTime = millis();
+    int x = 0;
+    // Attendre au max 10 secondes
+    while (WiFi.status() != WL_CONNECTED && millis() - startAttemptTime < 10000) {
+      delay(500);
+      u8g2.drawStr(x, 16, ".");
+      busEnvoieEcran(u8g2);
+      x = x + 6;
+    }
+    u8g2.clearBuffer();
+    u8g2.setFont(u8g2_font_ncenB08_tr);
+    if (WiFi.status() == WL_CONNECTED) {
+      u8g2.drawStr(0, 24, "Wifi connected!!!");
+    } else {
+      u8g2.drawStr(0, 24, "Wifi failed (timeout)");
+    }
+    busEnvoieEcran(u8g2);
+    delay(1000);
   }
-  u8g2.sendBuffer();
-  delay(1000);
 
   // Initialisation du RTC
   if (!rtc.begin()) {
     u8g2.clearBuffer();
     u8g2.setFont(u8g2_font_ncenB08_tr);
     u8g2.drawStr(0, 24, "RTC introuvable !");
-    u8g2.sendBuffer();
+    busEnvoieEcran(u8g2);
     delay(1000);
     while (1);
   }
+  // Horloge logicielle calée sur le RTC (plus de lecture I2C dans la boucle)
+  if (repriseChaude) {
+    beginHorlogeRapide(rtc, PIN_RTC_SQW, reprise.derivePpm);
+    // Dates millis() de l'exécution précédente ramenées sur celle-ci
+    uint32_t maintenant = millis();
+    uint32_t ecoule = horlogeNow().unixtime() - reprise.unixSauve;
+    if (ecoule > 3600) ecoule = 0;   // RTC réglé entre-temps : pas de recalage
+    prechauffe.segmentMs = reprise.recale(prechauffe.segmentMs, maintenant, ecoule);
+    prechauffe.refMs = reprise.recale(prechauffe.refMs, maintenant, ecoule);
+  } else {
+    beginHorloge(rtc, PIN_RTC_SQW);
+  }
   if (rtc.lostPower()) {
     u8g2.clearBuffer();
     u8g2.setFont(u8g2_font_ncenB08_tr);
     u8g2.drawStr(0, 24, "Le RTC a perdu l'heure.");
-    u8g2.drawStr(0, 40, "Réglage nécessaire !!!");
-    u8g2.sendBuffer();
-    delay(1000);
-    // Crée un objet DateTime avec l'heure de compilation
-    DateTime compileTime(F(__DATE__), F(__TIME__));
-    // Ajoute 50 secondes
-    DateTime adjusted = compileTime + TimeSpan(0, 0, 0, 20);
-    // Applique au RTC
-    rtc.adjust(adjusted);
+    if (WiFi.status() == WL_CONNECTED) {
+      // Réglage par NTP (attente max 5 s)
+      u8g2.drawStr(0, 40, "Reglage NTP...");
+      busEnvoieEcran(u8g2);
+      beginNtp();
+      struct tm tmNtp;
+      if (getLocalTime(&tmNtp, 5000)) {
+        regleHorloge(DateTime(tmNtp.tm_year + 1900, tmNtp.tm_mon + 1, tmNtp.tm_mday,
+                              tmNtp.tm_hour, tmNtp.tm_min, tmNtp.tm_sec));
+      }
+    } else {
+      // Sans réseau : réglage via le menu Date, ou NTP dès que le WiFi revient
+      u8g2.drawStr(0, 40, "Reglage necessaire !!!");
+      busEnvoieEcran(u8g2);
+      delay(1000);
+    }
   }
 
-  // Initialisation de l'OTA
+  // Initialisation de l'OTA (démarre aussi mDNS) et partage de l'image
   ArduinoOTA.begin();
+  beginPartage(currentVersion.c_str(), partageImmediat);
+  beginTableau(currentVersion.c_str(), appliqueReglage);
+  if (partageImmediat) {
+    prefs.begin("config", false);
+    prefs.remove("partageTot");
+    prefs.end();
+  }
+
+  energie.reset();
+  rendu.reset();
+  derniereActivite = millis();
+
+#if defined(BENCH_CONTROLE)
+  benchControle();
+#endif
+
+  // Traceur des étapes de la boucle (build_flags = -D TRACE_BOUCLE)
+  beginTrace();
 }
 
 // Fonction dessin flèche haut/bas
@@ -252,160 +477,89 @@ void drawArrow (int x, int y, int fontSize, int nbCharacter) {
   	y_margeHaut = -18;
   	y_margeBas = 3;
   }
-  // Flèche haut
-  for (int dx=-3; dx<=3; dx++) {
-    u8g2.drawPixel(x+dx, y+y_margeHaut);
-  }
-  for (int dx=-2; dx<=2; dx++) {
-    u8g2.drawPixel(x+dx, y+y_margeHaut-1);
-  }
-  for (int dx=-1; dx<=1; dx++) {
-    u8g2.drawPixel(x+dx, y+y_margeHaut-2);
-  }
-  u8g2.drawPixel(x, y+y_margeHaut-3);
+  // Flèches haut et bas (sprites include/icones.h)
+  u8g2.drawXBMP(x-3, y+y_margeHaut-3, FLECHE_W, FLECHE_H, flecheHaut);
+  u8g2.drawXBMP(x-3, y+y_margeBas, FLECHE_W, FLECHE_H, flecheBas);
+}
 
-  // Flèche bas
-  for (int dx=-3; dx<=3; dx++) {
-    u8g2.drawPixel(x+dx, y+y_margeBas);
-  }
-  for (int dx=-2; dx<=2; dx++) {
-    u8g2.drawPixel(x+dx, y+y_margeBas+1);
-  }
-  for (int dx=-1; dx<=1; dx++) {
-    u8g2.drawPixel(x+dx, y+y_margeBas+2);
-  }
-  u8g2.drawPixel(x, y+y_margeBas+3);
+// Programme jour/nuit courant
+Programme programme() {
+  Programme p;
+  p.minuteDay    = progHourDay   * 60 + progMinuteDay;
+  p.tempDay      = progTempDay;
+  p.minuteNight  = progHourNight * 60 + progMinuteNight;
+  p.tempNight    = progTempNight;
+  p.fadeDuration = fadeDuration;
+  return p;
 }
 
-// Fonction affichage menu
-void drawMenu() {
-  const char* items[] = {"Date", "Prog Temp", "Wifi", "Version"};
-  int marge = 16;
+// Calcul de la température cible (rampe avancée par la préchauffe
+// prédictive, interpolation dans include/controle.h)
+centi_t getTempCible(DateTime now) {
+  int minuteNow = now.hour() * 60 + now.minute();
+  return prechauffe.consigne(minuteNow, programme());
+}
 
-  for (int i = 0; i < 4; i++) {
-    int y = marge + i * marge; // position verticale
+// Apprentissage sur une nouvelle mesure ; à chaque plateau atteint,
+// rapport de l'écart programmé / atteint et sauvegarde du modèle
+void updatePrechauffe(DateTime now, bool relais) {
+  prechauffe.echantillon(tempAct, relais, millis());
+  if (manualTemp) return;
+  Transition t = prechauffe.suivi(now.hour() * 60 + now.minute(), tempAct, programme());
+  if (t == TransitionAucune) return;
+
+  Serial.printf("Prechauffe: plateau %s atteint avec %+d min d'ecart, avance %+d min, "
+                "chauffe %d c/h, refroidissement %d c/h\n",
+                t == TransitionJour ? "jour" : "nuit", prechauffe.dernierEcart[t],
+                prechauffe.retard[t], prechauffe.vitesseChauffe, prechauffe.vitesseRefroid);
+  prefs.begin("prechauffe", false);
+  prefs.putShort("vChauffe", prechauffe.vitesseChauffe);
+  prefs.putShort("vRefroid", prechauffe.vitesseRefroid);
+  prefs.putShort("retardJour", prechauffe.retard[TransitionJour]);
+  prefs.putShort("retardNuit", prechauffe.retard[TransitionNuit]);
+  prefs.end();
+}
 
-    if (i + 1 == menuIndex) {
-      // rectangle de sélection
-      u8g2.drawBox(0, y - marge, 128, marge); // -14 pour décaler le haut
-      u8g2.setDrawColor(0); // texte noir
-    } else {
-      u8g2.setDrawColor(1); // texte blanc
-    }
-    // dessiner le texte
-    u8g2.setFont(u8g2_font_fub11_tr); // choisir police adaptée
-    u8g2.drawStr(2, y -4, items[i]);
-    u8g2.setDrawColor(1); // remettre blanc pour la suite
+#if defined(BENCH_CONTROLE)
+// Mesure en cycles CPU d'une itération de contrôle (consigne, décision relais,
+// formatage des deux températures affichées) ; build_flags = -D BENCH_CONTROLE
+void benchControle() {
+  const int n = 1440;
+  char buf[16];
+  int minutesChauffe = 0;
+  Thermostat t;
+  t.reset();
+  DateTime base(2025, 1, 1, 0, 0, 0);
+  uint32_t debut = ESP.getCycleCount();
+  for (int i = 0; i < n; i++) {
+    centi_t cible = getTempCible(base + TimeSpan(i * 60));
+    minutesChauffe += t.decide(tempAct, cible, (uint32_t)i * 60000);
+    formatTemp(buf, sizeof(buf), tempAct);
+    formatTemp(buf, sizeof(buf), cible);
   }
+  uint32_t cycles = ESP.getCycleCount() - debut;
+  Serial.printf("Bench controle: %lu cycles/iteration (%d min de chauffe)\n",
+                (unsigned long)(cycles / n), minutesChauffe);
 }
-
-// Fonction affichage programation date
-void drawDate() {
-  // dessiner le texte
-  u8g2.setFont(u8g2_font_fub11_tr); // choisir police adaptée
-  u8g2.drawStr(30, 11, "DateProg");
-
-  // Affichage date
-  String sday = (day < 10 ? "0" : "") + String(day);
-  u8g2.drawStr(22, 35, sday.c_str());
-  if (menuIndex==1) drawArrow(22,35,11,2);
-  u8g2.drawStr(42, 35, "/");
-  String smonth = (month < 10 ? "0" : "") + String(month);
-  u8g2.drawStr(49, 35, smonth.c_str());
-  if (menuIndex==2) drawArrow(49,35,11,2);
-  u8g2.drawStr(69, 35, "/");
-  String syear = String(year);
-  u8g2.drawStr(76, 35, syear.c_str());
-  if (menuIndex==3) drawArrow(76,35,11,4);
-
-  // Affichage heure
-  String shour = (hour < 10 ? "0" : "") + String(hour);
-  u8g2.drawStr(40, 57, shour.c_str());
-  if (menuIndex==4) drawArrow(40,57,11,2);
-  u8g2.drawStr(60, 57, ":");
-  String sminute = (minute < 10 ? "0" : "") + String(minute);
-  u8g2.drawStr(66, 57, sminute.c_str());
-  if (menuIndex==5) drawArrow(66,57,11,2);
-
-  u8g2.setFont(u8g2_font_open_iconic_check_1x_t);
-  u8g2.drawGlyph(100, 57, 0x0040);
-}
-
-// Fonction affichage programation température
-void drawTemp() {
-  u8g2.setFont(u8g2_font_fub11_tr); // choisir police adaptée
-  u8g2.drawStr(30, 11, "TempProg");
-
-  // Affichage programmation jour
-  u8g2.drawStr(0, 35, "D_");
-  String sprogHourDayTemp = (progHourDayTemp < 10 ? "0" : "") + String(progHourDayTemp);
-  u8g2.drawStr(24, 35, sprogHourDayTemp.c_str());
-  if (menuIndex==1) drawArrow(24,35,11,2);
-  u8g2.drawStr(44, 35, ":");
-  String sProgMinuteDayTemp = (progMinuteDayTemp < 10 ? "0" : "") + String(progMinuteDayTemp);
-  u8g2.drawStr(51, 35, sProgMinuteDayTemp.c_str());
-  if (menuIndex==2) drawArrow(51,35,11,2);
-  u8g2.drawStr(71, 35, "=");
-  String sprogTempDayTemp = (progTempDayTemp < 9.9 ? "0" : "") + String(progTempDayTemp,1);
-  u8g2.drawStr(88, 35, sprogTempDayTemp.c_str());
-  if (menuIndex==3) drawArrow(88,35,11,4);
-
-  // Affichage programmation nuit
-  u8g2.drawStr(0, 57, "N_");
-  String sprogHourNightTemp = (progHourNightTemp < 10 ? "0" : "") + String(progHourNightTemp);
-  u8g2.drawStr(24, 57, sprogHourNightTemp.c_str());
-  if (menuIndex==4) drawArrow(24,57,11,2);
-  u8g2.drawStr(44, 57, ":");
-  String sProgMinuteNightTemp = (progMinuteNightTemp < 10 ? "0" : "") + String(progMinuteNightTemp);
-  u8g2.drawStr(51, 57, sProgMinuteNightTemp.c_str());
-  if (menuIndex==5) drawArrow(51,57,11,2);
-  u8g2.drawStr(71, 57, "=");
-  String sprogTempNightTemp = (progTempNightTemp < 9.9 ? "0" : "") + String(progTempNightTemp,1);
-  u8g2.drawStr(88, 57, sprogTempNightTemp.c_str());
-  if (menuIndex==6) drawArrow(88,57,11,4);
-}
-
-// Fonction interpolation en S (cosinus)
-float smoothStep(float startTemp, float endTemp, int startMinute, int endMinute, int nowMinute) {
-  // Cas avant/après la période
-  if (nowMinute < startMinute) return endTemp;
-  if (nowMinute > endMinute)   return endTemp;
-
-  float ratio = float(nowMinute - startMinute) / float(endMinute - startMinute);
-  float sCurve = (1 - cos(ratio * PI)) / 2.0; // courbe en S
-  return startTemp + sCurve * (endTemp - startTemp);
-}
-
-// Calcul de la température cible
-float getTempCible(DateTime now) {
-  int hour   = now.hour();
-  int minute = now.minute();
-  int minuteNow   = hour * 60 + minute;
-  int minuteDay   = progHourDay   * 60 + progMinuteDay;
-  int minuteNight = progHourNight * 60 + progMinuteNight;
-
-  // Cas normal (jour sans minuit)
-  if (minuteDay < minuteNight) {
-    if (minuteNow >= minuteDay && minuteNow < minuteNight) {
-      // On est en jour -> interpoler depuis la nuit
-      return smoothStep(progTempNight, progTempDay,
-                        minuteDay, minuteDay + fadeDuration, minuteNow);
-    } else {
-      // On est en nuit -> interpoler depuis le jour
-      return smoothStep(progTempDay, progTempNight,
-                        minuteNight, minuteNight + fadeDuration, minuteNow);
-    }
+#endif
+
+// Affichage d'un champ texte en cours de saisie, caractère courant sous les flèches
+void drawTexte(const char *title, int titleX, const String &texte) {
+  u8g2.setFont(u8g2_font_fub11_tr);
+  u8g2.drawStr(titleX, 11, title); // glyphes: SSID:WPAsword
+  u8g2.setFont(u8g2_font_ncenB08_tf);
+  char current[2] = { charSet[charIndex], 0 };
+  int large=10;
+  int x=u8g2.getStrWidth(texte.c_str()); // glyphes: {charSet}
+  // Si l'écran est plus grand que le texte
+  if (x < LARGEUR_ECRAN-large) {
+    u8g2.drawStr(0, 39, texte.c_str()); // glyphes: {charSet}
+    u8g2.drawStr(x+1, 39, current); // glyphes: {charSet}
+    drawArrow(x+1,39,8,1);
   } else {
-    // Cas qui traverse minuit
-    if (minuteNow >= minuteDay || minuteNow < minuteNight) {
-      // Jour
-      return smoothStep(progTempNight, progTempDay,
-                        minuteDay, (minuteDay + fadeDuration) % (24*60), minuteNow);
-    } else {
-      // Nuit
-      return smoothStep(progTempDay, progTempNight,
-                        minuteNight, (minuteNight + fadeDuration) % (24*60), minuteNow);
-    }
+    u8g2.drawStr(LARGEUR_ECRAN-1-x-large, 39, texte.c_str()); // glyphes: {charSet}
+    u8g2.drawStr(LARGEUR_ECRAN-large, 39, current); // glyphes: {charSet}
+    drawArrow(LARGEUR_ECRAN-large,39,8,1);
   }
 }
 
@@ -413,15 +567,16 @@ float getTempCible(DateTime now) {
 void drawWifi() {
   if (wifiState == WifiMain) {
     const char* items[] = {"Scan SSID", "Fixe SSID", "WPA", "Save"};
+    u8g2.setFont(u8g2_font_fub11_tr);
     for (int i = 0; i < 4; i++) {
       int y = 15 + i*15;
       if (menuIndex == i+1 ) {
-        u8g2.drawBox(0, y-12, 128, 14);
+        u8g2.drawBox(0, y-12, LARGEUR_ECRAN, 14);
         u8g2.setDrawColor(0);
       } else {
         u8g2.setDrawColor(1);
       }
-      u8g2.drawStr(2, y, items[i]);
+      u8g2.drawStr(2, y, items[i]); // glyphes: {tableau:items}
       u8g2.setDrawColor(1);
     }
   }
@@ -437,69 +592,57 @@ void drawWifi() {
       for (int i = 0; i < 5 ; i++) {
         int y = 11 + 2 + 9 + i * 10;
         if (i == menuIndex) {
-          u8g2.drawBox(0, y-9, 128, 10);
+          u8g2.drawBox(0, y-9, LARGEUR_ECRAN, 10);
           u8g2.setDrawColor(0);
         } else {
           u8g2.setDrawColor(1);
         }
-        u8g2.drawStr(2, y, WiFi.SSID(i).c_str());
+        u8g2.drawStr(2, y, WiFi.SSID(i).c_str()); // glyphes: {ascii}
         u8g2.setDrawColor(1);
       }
     } else { // sinon affiche le SSID sélectionné et les 4 derniers
       for (int i = menuIndex; i > menuIndex - 4; i--) {
         int y = 11 + 2 + 9 + 4 * 10 - (menuIndex-i) * 10;
         if (i == menuIndex) {
-          u8g2.drawBox(0, y-9, 128, 10);
+          u8g2.drawBox(0, y-9, LARGEUR_ECRAN, 10);
           u8g2.setDrawColor(0);
         } else {
           u8g2.setDrawColor(1);
         }
-        u8g2.drawStr(2, y, WiFi.SSID(i).c_str());
+        u8g2.drawStr(2, y, WiFi.SSID(i).c_str()); // glyphes: {ascii}
         u8g2.setDrawColor(1);
       }
     }
   }
 
-  else if (wifiState == WifiSSID)
-  {
-    u8g2.setFont(u8g2_font_fub11_tr);
-    u8g2.drawStr(23, 11, "SSID:");
-    u8g2.setFont(u8g2_font_ncenB08_tf);
-    char current[2] = { charSet[charIndex], 0 };
-    // u8g2.getStrWidth(wifiSSID.c_str() pour connaitre la position de la taille de la chaine
-    int large=10;
-    // Si l'écran est plus grand que le texte
-    if (u8g2.getStrWidth(wifiSSIDTemp.c_str()) < 128-large) {
-      u8g2.drawStr(0, 39, wifiSSIDTemp.c_str());
-      u8g2.drawStr(u8g2.getStrWidth(wifiSSIDTemp.c_str())+1, 39, current);
-      drawArrow(u8g2.getStrWidth(wifiSSIDTemp.c_str())+1,39,8,1);
-    } else {
-      int x=u8g2.getStrWidth(wifiSSIDTemp.c_str());
-      u8g2.drawStr(128-1-x-large, 39, wifiSSIDTemp.c_str());
-      u8g2.drawStr(128-large, 39, current);
-      drawArrow(128-large,39,8,1);
-    }
+  else if (wifiState == WifiSSID) {
+    drawTexte("SSID:", 23, wifiSSIDTemp);
   }
 
   else if (wifiState == WifiPassword) {
-    u8g2.setFont(u8g2_font_fub11_tr);
-    u8g2.drawStr(13, 11, "WPAssword:");
-    u8g2.setFont(u8g2_font_ncenB08_tf);
+    drawTexte("WPAssword:", 13, wifiPassTemp);
+  }
+}
 
-    char current[2] = { charSet[charIndex], 0 };
-    int large=10;
-    // Si l'écran est plus grand que le texte
-    if (u8g2.getStrWidth(wifiPassTemp.c_str()) < 128-large) {
-      u8g2.drawStr(0, 39, wifiPassTemp.c_str());
-      u8g2.drawStr(u8g2.getStrWidth(wifiPassTemp.c_str())+1, 39, current);
-      drawArrow(u8g2.getStrWidth(wifiPassTemp.c_str())+1,39,8,1);
-    } else {
-      int x=u8g2.getStrWidth(wifiPassTemp.c_str());
-      u8g2.drawStr(128-1-x-large, 39, wifiPassTemp.c_str());
-      u8g2.drawStr(128-large, 39, current);
-      drawArrow(128-large,39,8,1);
+// Décision de déploiement pour la version pointée par le manifeste : entrée
+// "rollout" de la version et cohortes qu'elle cite
+DecisionDeploiement decisionManifeste(JsonDocument &doc, const String &version) {
+  JsonVariant regle = doc["rollout"][version];
+  if (regle.isNull()) return DeploiementOui;   // ancien format : tout le parc
+  char id[9];
+  snprintf(id, sizeof(id), "%08lx", (unsigned long)partageId());
+  String versionMin = regle["min_version"] | "";
+  RegleDeploiement r;
+  r.tranches = tranchesPourcentage(regle["percent"] | 100.0f);
+  r.arrete = regle["halted"] | false;
+  r.versionMin = versionMin.c_str();
+  r.cohorte = false;
+  for (JsonVariant nom : regle["cohorts"].as<JsonArray>()) {
+    for (JsonVariant membre : doc["cohorts"][nom.as<String>()].as<JsonArray>()) {
+      if (membre.as<String>().equalsIgnoreCase(id)) r.cohorte = true;
     }
   }
+  return decideDeploiement(partageId(), currentVersion.c_str(), version.c_str(), r);
 }
 
 // Fonction pour vérifier les mises à jour
@@ -508,8 +651,9 @@ String checkUpdate() {
   client.setInsecure();  // pas de vérification TLS
 
   HTTPClient https;
+  u8g2.setFont(u8g2_font_fub11_tr);
   if (!https.begin(client, String(manifestURL)+"version.json")) { 
-    u8g2.drawStr(0, 64, "NO HTTP Access !!!");
+    u8g2.drawStr(0, HAUTEUR_ECRAN, "NO HTTP Access !!!");
     return "ERROR";
   }
 
@@ -523,8 +667,8 @@ String checkUpdate() {
 
     DeserializationError err = deserializeJson(doc, payload);
     if (err) {
-      u8g2.drawStr(0, 64, "JSON Error !!!");
-      u8g2.sendBuffer();
+      u8g2.drawStr(0, HAUTEUR_ECRAN, "JSON Error !!!");
+      busEnvoieEcran(u8g2);
       sleep(2);
       return "ERROR";
     }
@@ -538,134 +682,263 @@ String checkUpdate() {
     }
     String latestURL = doc["firmwares"][latest]["url"] | "";
     latestmd5 = doc["firmwares"][latest]["md5"] | "";
+    latestSha256 = doc["firmwares"][latest]["sha256"] | "";
 
     if (latest.length() == 0 || latestURL.length() == 0) {
-      u8g2.drawStr(0, 64, "JSON Incomplete !!!");
-      u8g2.sendBuffer();
+      u8g2.drawStr(0, HAUTEUR_ECRAN, "JSON Incomplete !!!");
+      busEnvoieEcran(u8g2);
       sleep(2);
       return "ERROR";
     }
 
+    rapportURL = doc["report"] | "";
+
     if (latest != currentVersion) {
+      DecisionDeploiement decision = decisionManifeste(doc, latest);
+      if (decision != DeploiementOui) {
+        Serial.printf("Version %s : %s\n", latest.c_str(), texteDecision(decision));
+        const char *message = decision == DeploiementArrete ? "Rollout halted"
+                            : decision == DeploiementVersionMin ? "Too old" : "Not yet";
+        u8g2.drawStr(0, HAUTEUR_ECRAN, message); // glyphes: RTNadehlotuy{espace}
+        busEnvoieEcran(u8g2);
+        sleep(2);
+        return "NOTYET";
+      }
       Serial.printf("Nouvelle version %s dispo, mise à jour...\n", latest.c_str());
-      u8g2.drawStr(0, 64, "Update Needed");
-      u8g2.sendBuffer();
+      u8g2.drawStr(0, HAUTEUR_ECRAN, "Update Needed");
+      busEnvoieEcran(u8g2);
       sleep(2);
       latestVersion = latest;
       return "UPDATENEED";
     } else {
       Serial.println("Firmware déjà à jour.");
-      u8g2.drawStr(0, 64, "Up to date");
-      u8g2.sendBuffer();
+      u8g2.drawStr(0, HAUTEUR_ECRAN, "Up to date");
+      busEnvoieEcran(u8g2);
       sleep(2);
       return "UPTODATE";
     }
   } else {
     Serial.printf("Erreur HTTP %d\n", httpCode);
     https.end();
-    u8g2.drawStr(0, 64, "HTTP Error !!!");
-    u8g2.sendBuffer();
+    u8g2.drawStr(0, HAUTEUR_ECRAN, "HTTP Error !!!");
+    busEnvoieEcran(u8g2);
     sleep(2); 
     return "ERROR";
   }
 }
 
-// Fonction pour télécharger et installer la mise à jour
-// cp .pio/build/seeed_xiao_esp32c3/firmware.bin release/firmware-0.2.bin && md5 .pio/build/seeed_xiao_esp32c3/firmware.map
-String upgrade() {
-  String url = String(manifestURL) + "firmware-" + latestVersion + ".bin";
-
-  WiFiClientSecure client;
-  client.setInsecure();
+// Rapport du résultat d'une mise à jour au collecteur du manifeste ; true
+// si le collecteur l'a reçu
+bool envoieRapport(const String &url, const String &depuis, const String &vers,
+                   const char *resultat, const char *erreur) {
+  char id[9];
+  snprintf(id, sizeof(id), "%08lx", (unsigned long)partageId());
+  JsonDocument doc;
+  doc["id"] = id;
+  doc["from"] = depuis;
+  doc["to"] = vers;
+  doc["result"] = resultat;
+  doc["error"] = erreur ? erreur : "";
+  String corps;
+  serializeJson(doc, corps);
+
+  WiFiClient client;
+  WiFiClientSecure clientSecurise;
+  bool securise = url.startsWith("https:");
+  if (securise) clientSecurise.setInsecure();
+  HTTPClient http;
+  http.setConnectTimeout(DEPLOIEMENT_RAPPORT_TIMEOUT_MS);
+  http.setTimeout(DEPLOIEMENT_RAPPORT_TIMEOUT_MS);
+  if (!http.begin(securise ? clientSecurise : client, url)) return false;
+  http.addHeader("Content-Type", "application/json");
+  int code = http.POST(corps);
+  http.end();
+  Serial.printf("Rapport %s %s -> %s : HTTP %d\n", resultat, depuis.c_str(), vers.c_str(), code);
+  return code >= 200 && code < 300;
+}
 
-  HTTPClient https;
-  https.useHTTP10(true); // aide à avoir un Content-Length
-  if (!https.begin(client, url)) {
-    u8g2.setDrawColor(0);  //on efface les lignes d'avant
-    u8g2.drawBox(0, 53, 128, 11);
-    u8g2.setDrawColor(1);
-    u8g2.drawStr(2, 64, "NO HTTP Access !!!");
-    u8g2.sendBuffer();
-    sleep(2);
-    return "ERROR";
+// Rapport en attente de la dernière mise à jour : retour à l'ancienne image
+// dès le démarrage, succès après DEPLOIEMENT_VALIDATION_MS de marche ;
+// quelques essais espacés, puis abandon
+void updateRapportDeploiement() {
+  if (!rapportEnAttente || WiFi.status() != WL_CONNECTED) return;
+  if (!rapportRetour && millis() < DEPLOIEMENT_VALIDATION_MS) return;
+  if ((long)(millis() - rapportProchain) < 0) return;
+  prefs.begin("deploie", true);
+  String url = prefs.getString("url", "");
+  String depuis = prefs.getString("depuis", "");
+  String vers = prefs.getString("vers", "");
+  prefs.end();
+  if (url.length() == 0 ||
+      envoieRapport(url, depuis, vers, rapportRetour ? "rollback" : "ok", nullptr) ||
+      ++rapportEssais >= DEPLOIEMENT_RAPPORT_ESSAIS) {
+    prefs.begin("deploie", false);
+    prefs.clear();
+    prefs.end();
+    rapportEnAttente = false;
+  } else {
+    rapportProchain = millis() + DEPLOIEMENT_RAPPORT_REESSAI_MS;
   }
+}
 
-  int code = https.GET();
+// Téléchargement et écriture d'une image dans la partition OTA ; retourne
+// nullptr si l'image est installée, sinon le message d'erreur affiché.
+// L'image est vérifiée avant Update.end() : SHA-256 du manifeste s'il est
+// publié, MD5 dans tous les cas (Update.end() échoue s'il diffère).
+const char *installe(HTTPClient &http, WiFiClient &client, const String &url) {
+  http.useHTTP10(true); // aide à avoir un Content-Length
+  if (!http.begin(client, url)) return "NO HTTP Access !!!";
+
+  int code = http.GET();
   if (code != HTTP_CODE_OK) {
-    https.end();
-    u8g2.setDrawColor(0);  //on efface les lignes d'avant
-    u8g2.drawBox(0, 53, 128, 11);
-    u8g2.setDrawColor(1);
-    u8g2.drawStr(2, 64, "HTTP ERROR");
-    u8g2.sendBuffer();
-    sleep(2);
-    return "ERROR";
+    http.end();
+    return "HTTP ERROR";
   }
 
-  int len = https.getSize();                // peut être -1 si chunked
+  int len = http.getSize();                // peut être -1 si chunked
   if (!Update.begin(len > 0 ? (size_t)len : UPDATE_SIZE_UNKNOWN)) {
-    https.end();
-    u8g2.setDrawColor(0);  //on efface les lignes d'avant
-    u8g2.drawBox(0, 53, 128, 11);
-    u8g2.setDrawColor(1);
-    u8g2.drawStr(2, 64, "No OTA Space");
-    u8g2.sendBuffer();
-    sleep(2);
-    return "ERROR";
+    http.end();
+    return "No OTA Space";
   }
 
   // >>> Vérif d’intégrité intégrée (MD5 attendu)
   if (latestmd5.length() == 32 && !Update.setMD5(latestmd5.c_str())) {
     Update.abort();
-    https.end();
-    u8g2.setDrawColor(0);  //on efface les lignes d'avant
-    u8g2.drawBox(0, 53, 128, 11);
-    u8g2.setDrawColor(1);
-    u8g2.drawStr(2, 64, "MD5 BAD ARG");
-    u8g2.sendBuffer();
-    sleep(2);
-    return "ERROR";
+    http.end();
+    return "MD5 BAD ARG";
   }
 
-  WiFiClient *stream = https.getStreamPtr();
-  size_t written = Update.writeStream(*stream);
-
-  if (len > 0 && written != (size_t)len) {   // téléchargement incomplet
+  mbedtls_sha256_context sha;
+  mbedtls_sha256_init(&sha);
+#if ESP_IDF_VERSION_MAJOR >= 5
+  mbedtls_sha256_starts(&sha, 0);
+#else
+  mbedtls_sha256_starts_ret(&sha, 0);
+#endif
+  WiFiClient *stream = http.getStreamPtr();
+  uint8_t tampon[1024];
+  size_t written = 0;
+  unsigned long dernier = millis();
+  while ((len <= 0 || written < (size_t)len) && millis() - dernier < 10000) {
+    int dispo = stream->available();
+    if (dispo <= 0) {
+      if (!stream->connected()) break;
+      delay(1);
+      continue;
+    }
+    int n = stream->readBytes(tampon, min((size_t)dispo, sizeof(tampon)));
+    if (n <= 0) continue;
+    if (Update.write(tampon, n) != (size_t)n) break;
+#if ESP_IDF_VERSION_MAJOR >= 5
+    mbedtls_sha256_update(&sha, tampon, n);
+#else
+    mbedtls_sha256_update_ret(&sha, tampon, n);
+#endif
+    written += n;
+    dernier = millis();
+  }
+  uint8_t empreinte[32];
+#if ESP_IDF_VERSION_MAJOR >= 5
+  mbedtls_sha256_finish(&sha, empreinte);
+#else
+  mbedtls_sha256_finish_ret(&sha, empreinte);
+#endif
+  mbedtls_sha256_free(&sha);
+
+  if ((len > 0 && written != (size_t)len) || written == 0) {   // téléchargement incomplet
     Update.abort();
-    https.end();
-    u8g2.setDrawColor(0);  //on efface les lignes d'avant
-    u8g2.drawBox(0, 53, 128, 11);
-    u8g2.setDrawColor(1);
-    u8g2.drawStr(2, 64, "STREAM ERROR");
-    u8g2.sendBuffer();
-    sleep(2);
-    return "ERROR";
+    http.end();
+    return "STREAM ERROR";
+  }
+
+  if (latestSha256.length() == 64) {
+    char hex[65];
+    for (int i = 0; i < 32; i++) sprintf(hex + 2 * i, "%02x", empreinte[i]);
+    if (!latestSha256.equalsIgnoreCase(hex)) {
+      Update.abort();
+      http.end();
+      return "SHA256 FAIL";
+    }
   }
 
   if (!Update.end()) {                       // MD5 mauvais -> end() échoue
-    https.end();
+    http.end();
     Serial.printf("Update error: %s\n", Update.errorString());
+    return "VERIFY FAIL";
+  }
+  http.end();
+  return nullptr;
+}
+
+// Fonction pour télécharger et installer la mise à jour : depuis les pairs
+// du réseau local retenus par planifie() (HTTP simple, image vérifiée
+// contre le manifeste), ou depuis l'origine si l'élection l'a désigné
+// cp .pio/build/seeed_xiao_esp32c3/firmware.bin release/firmware-0.2.bin && md5 .pio/build/seeed_xiao_esp32c3/firmware.map
+String upgrade(const Pair *pairs, const Plan &plan) {
+  const char *erreur = "NO SOURCE";
+  u8g2.setFont(u8g2_font_fub11_tr);
+
+  if (plan.decision == SourcePairs) {
+    for (int i = 0; i < plan.nb && erreur; i++) {
+      const Pair &p = pairs[plan.ordre[i]];
+      String url = "http://" + IPAddress(p.ip).toString() + ":" + String((unsigned)p.port) +
+                   "/firmware-" + latestVersion + ".bin";
+      WiFiClient client;
+      HTTPClient http;
+      erreur = installe(http, client, url);
+      Serial.printf("Mise a jour depuis %s : %s\n", url.c_str(), erreur ? erreur : "ok");
+      // Image différente du manifeste : ce pair n'est plus sollicité
+      if (erreur && (strcmp(erreur, "VERIFY FAIL") == 0 || strcmp(erreur, "SHA256 FAIL") == 0)) {
+        exclutPair(election, p.id);
+      }
+    }
+    if (erreur) return "PAIRS";
+  } else {
+    // Les autres appareils attendent que celui-ci la serve
+    partageEtat(PairTelechargement, latestVersion.c_str());
+    String url = String(manifestURL) + "firmware-" + latestVersion + ".bin";
+    WiFiClientSecure client;
+    client.setInsecure();
+    HTTPClient https;
+    erreur = installe(https, client, url);
+    Serial.printf("Mise a jour depuis l'origine : %s\n", erreur ? erreur : "ok");
+  }
+
+  if (erreur) {
+    partageEtat(PairInactif, "");
+    if (rapportURL.length()) envoieRapport(rapportURL, currentVersion, latestVersion, "failed", erreur);
     u8g2.setDrawColor(0);  //on efface les lignes d'avant
-    u8g2.drawBox(0, 53, 128, 11);
+    u8g2.drawBox(0, 53, LARGEUR_ECRAN, 11);
     u8g2.setDrawColor(1);
-    u8g2.drawStr(2, 64, "VERIFY FAIL");
-    u8g2.sendBuffer();
+    u8g2.drawStr(2, HAUTEUR_ECRAN, erreur); // glyphes: !256ABCDEFGHILMNOPRSTUVYaceops{espace}
+    busEnvoieEcran(u8g2);
     sleep(2);
     return "ERROR";
   }
 
-  https.end();
   u8g2.setDrawColor(0);  //on efface les lignes d'avant
-  u8g2.drawBox(0, 53, 128, 11);
+  u8g2.drawBox(0, 53, LARGEUR_ECRAN, 11);
   u8g2.setDrawColor(1);
-  u8g2.drawStr(2, 64, "Upgrade Done!");
-  u8g2.sendBuffer();
+  u8g2.drawStr(2, HAUTEUR_ECRAN, "Upgrade Done!");
+  busEnvoieEcran(u8g2);
   // Sauvegarde dans les préférences
   prefs.begin("config", false);
   prefs.putBool("sversion", stableVersion);
   prefs.putString("version", latestVersion);
+  // Annonce dès le redémarrage : les pairs qui attendent cette image
+  prefs.putBool("partageTot", plan.decision == SourceOrigine);
+  prefs.end();
+  // Résultat rapporté après le redémarrage ; la partition installée
+  // distingue un retour à l'ancienne image
+  const esp_partition_t *installee = esp_ota_get_boot_partition();
+  prefs.begin("deploie", false);
+  prefs.putString("url", rapportURL);
+  prefs.putString("depuis", currentVersion);
+  prefs.putString("vers", latestVersion);
+  prefs.putUInt("partition", installee ? installee->address : 0);
   prefs.end();
   sleep(2);
+  sauveReprise(horlogeNow(), superviseurRelais()); // reprise à chaud après le reboot
   ESP.restart();                             // reboot si tout est ok
   return "DONE";
 }
@@ -676,11 +949,11 @@ void drawVersion() {
   u8g2.setFont(u8g2_font_fub11_tr); // choisir police adaptée
   u8g2.drawStr(20, 11, "Firmware");
   u8g2.drawStr(2, 25, "Version:");
-  u8g2.drawStr(72, 25, currentVersion.c_str());
+  u8g2.drawStr(72, 25, currentVersion.c_str()); // glyphes: 0123456789.
 
   if (WiFi.status() == WL_CONNECTED){
     if (versionState == VersionMain){
-      u8g2.drawBox(0, 26, 128, 13);
+      u8g2.drawBox(0, 26, LARGEUR_ECRAN, 13);
       u8g2.setDrawColor(0);
       u8g2.drawStr(2, 38, "Check update");
       u8g2.setDrawColor(1);
@@ -690,7 +963,7 @@ void drawVersion() {
       u8g2.drawStr(2, 38, "Check update");
       u8g2.setDrawColor(1);
       u8g2.drawStr(2, 51, "Wait ...");
-      u8g2.sendBuffer();
+      busEnvoieEcran(u8g2);
       String result = checkUpdate();
       if (result == "UPDATENEED"){
         versionState = VersionUpdate;
@@ -702,9 +975,9 @@ void drawVersion() {
 
     if (versionState == VersionUpdate){
       u8g2.drawStr(2, 38, "Found :");
-      u8g2.drawStr(63, 38, latestVersion.c_str());
+      u8g2.drawStr(63, 38, latestVersion.c_str()); // glyphes: 0123456789.
       u8g2.setDrawColor(1);
-      u8g2.drawBox(0, 39, 128, 13);
+      u8g2.drawBox(0, 39, LARGEUR_ECRAN, 13);
       u8g2.setDrawColor(0);
       u8g2.drawStr(2, 51, "Upgrade");
       u8g2.setDrawColor(1);
@@ -712,25 +985,48 @@ void drawVersion() {
 
     if (versionState == VersionUpgrade){
       Serial.print("Upgrade.");
+      // Annonce "en attente" puis recherche d'un pair qui sert la version
+      partageEtat(PairAttente, latestVersion.c_str());
+      partageRecherche();
+      commenceElection(election, millis());
+      partageProchaine = 0;
+      partageEnCours = true;
+      versionState = VersionPairs;
+    }
+
+    if (versionState == VersionPairs){
       u8g2.drawStr(2, 38, "Found :");
-      u8g2.drawStr(63, 38, latestVersion.c_str());
-      u8g2.setDrawColor(0);  // On efface le selecteur
-      u8g2.drawBox(0, 39, 128, 13);
-      u8g2.setDrawColor(1);
+      u8g2.drawStr(63, 38, latestVersion.c_str()); // glyphes: 0123456789.
       u8g2.drawStr(2, 51, "Upgrade");
-      u8g2.drawStr(2, 64, "Wait ...");
-      u8g2.sendBuffer();
-
-      String result = upgrade();
+      u8g2.drawStr(2, HAUTEUR_ECRAN, "Wait peers");
 
-      if (result == "error") {
-        Serial.print("OTHER.");
-        versionState = VersionMain;
-        sleep(2);
-      } else {
-        Serial.print("Upgrade done.");
-        u8g2.drawStr(2, 64, "Upgrade done.");
-        versionState = VersionMain;
+      Pair pairs[PAIRS_MAX];
+      int n = 0;
+      if (!partageEnCours && millis() >= partageProchaine) {
+        partageRecherche();
+        partageEnCours = true;
+      }
+      if (partageEnCours && partageResultats(latestVersion.c_str(), pairs, n)) {
+        partageEnCours = false;
+        Plan plan = planifie(election, pairs, n, latestVersion.c_str(), latestmd5.c_str(),
+                             partageId(), millis());
+        if (plan.decision == SourceAttente) {
+          partageProchaine = millis() + plan.attenteMs;
+        } else {
+          u8g2.setDrawColor(0);  //on efface les lignes d'avant
+          u8g2.drawBox(0, 53, LARGEUR_ECRAN, 11);
+          u8g2.setDrawColor(1);
+          u8g2.drawStr(2, HAUTEUR_ECRAN, "Wait ...");
+          busEnvoieEcran(u8g2);
+          String result = upgrade(pairs, plan);
+          if (result == "PAIRS") {
+            // Pairs occupés ou écartés : on patiente, pas d'origine
+            partageProchaine = millis() + PARTAGE_REESSAI_MS;
+          } else {
+            Serial.print("OTHER.");
+            versionState = VersionMain;
+          }
+        }
       }
     }
   }
@@ -743,112 +1039,47 @@ void drawSave() {
 }
 
 // Fonction générique d’auto-repeat
-// Retourne true si "target" a été modifiée
-bool handleRepeat(Bounce &btn, float &target, float step, unsigned long &pressedSince, unsigned long &lastRepeat) {
-  bool changed = false;
-  unsigned long now = millis();
-
-  if (btn.fell()) {
-    // Action immédiate
-    target += step;
-    pressedSince = now;
-    lastRepeat   = now;
-    changed = true;
-  }
-
-  if (btn.read() == LOW) { // Bouton maintenu
-    unsigned long held = now - pressedSince;
-    unsigned long interval = 0;
-
-    if (held > delay2) {
-      interval = rate2;    // très rapide
-    } else if (held > delay1) {
-      interval = rate1;    // rapide
-    }
-
-    if (interval > 0 && now - lastRepeat >= interval) {
-      target += step;
-      lastRepeat = now;
-      changed = true;
-    }
-  }
-  return changed;
+// Retourne true quand le bouton demande un pas (appui immédiat ou répétition)
+bool repeatStep(const Bouton &btn) {
+  return btn.fell() || btn.repeated();
 }
 
-void handleRepeatInt(Bounce &btn, int &target, int minVal, int maxVal,
-                     int step, unsigned long &pressedSince, unsigned long &lastRepeat) {
-  unsigned long now = millis();
-
-  if (btn.fell()) {
-    target += step;
-    if (target > maxVal) target = minVal;
-    if (target < minVal) target = maxVal;
-    pressedSince = now;
-    lastRepeat   = now;
-  }
-
-  if (btn.read() == LOW) { // Bouton maintenu
-    unsigned long held = now - pressedSince;
-    unsigned long interval = 0;
-
-    if (held > delay2) {
-      interval = rate2;    // rapide
-    } else if (held > delay1) {
-      interval = rate1;    // lent
-    }
+// Retourne true si "target" a été modifiée
+bool handleRepeat(const Bouton &btn, centi_t &target, centi_t step) {
+  if (!repeatStep(btn)) return false;
+  target += step;
+  return true;
+}
 
-    if (interval > 0 && now - lastRepeat >= interval) {
-      target += step;
-      if (target > maxVal) target = minVal;
-      if (target < minVal) target = maxVal;
-      lastRepeat = now;
-    }
-  }
+// Incrément avec rebouclage min <-> max
+void handleRepeatInt(const Bouton &btn, int &target, int minVal, int maxVal, int step) {
+  if (!repeatStep(btn)) return;
+  target += step;
+  if (target > maxVal) target = minVal;
+  if (target < minVal) target = maxVal;
 }
 
-void drawWiFiArc(U8G2 &u8g2, int x, int y, int r, int startAngle, int endAngle) {
-  for (int a = startAngle; a <= endAngle; a++) {
-    float rad = a * 3.14159 / 180.0;
-    int px = x + r * cos(rad);
-    int py = y - r * sin(rad);
-    u8g2.drawPixel(px, py);
-  }
+// nombre d'arcs selon le RSSI
+// 0 -> dead!
+// -80 à 85 : poor point
+// - 75 à 80 : moyen- un arc
+// - 70 à 75 : moyen + deux arc
+// - 1 à 70 : bon trois arc
+// -1 : pas d'icône
+int niveauWifi(long rssi) {
+  if (rssi == 0 || rssi <= -86) return -1;
+  int niveau = 0;
+  if (rssi > -79) niveau = 1;   // un arc
+  if (rssi > -74) niveau = 2;   // deux arcs
+  if (rssi > -64) niveau = 3;   // trois arcs
+  return niveau;
 }
 
-void drawWiFiIcon(U8G2 &u8g2, int x, int y, long rssi) {
-  // nombre d'arcs selon le RSSI
-  // 0 -> dead!
-  // -80 à 85 : poor point
-  // - 75 à 80 : moyen- un arc
-  // - 70 à 75 : moyen + deux arc
-  // - 1 à 70 : bon trois arc
-  // point
-  if (rssi != 0 && rssi > -86)
-  {
-    u8g2.drawPixel(x-1, y-1);
-    u8g2.drawPixel(x,   y-1);
-    u8g2.drawPixel(x-2, y);
-    u8g2.drawPixel(x-1, y);
-    u8g2.drawPixel(x,   y);
-    u8g2.drawPixel(x+1, y);
-    u8g2.drawPixel(x-1, y+1);
-    u8g2.drawPixel(x,   y+1);
-  }
-  // un arc
-  if (rssi != 0 && rssi > -79)
-  {
-    drawWiFiArc(u8g2, x, y, 4, 40, 140);
-  }
-  // deux arcs
-  if (rssi != 0 && rssi > -74)
-  {
-    drawWiFiArc(u8g2, x, y, 7, 40, 140);
-  }
-  // trois arcs
-  if (rssi != 0 && rssi > -64)
-  {
-    drawWiFiArc(u8g2, x, y, 10, 40, 140);
-  }
+void drawWiFiIcon(Profil::Ecran &u8g2, int x, int y, long rssi) {
+  // Sprites précalculés par tools/gen_icones.py (include/icones.h)
+  int niveau = niveauWifi(rssi);
+  if (niveau < 0) return;
+  u8g2.drawXBMP(x + WIFI_ICON_DX, y + WIFI_ICON_DY, WIFI_ICON_W, WIFI_ICON_H, wifiIcons[niveau]);
 }
 
 void handleWiFiReconnect(String ssid, String password) {
@@ -869,400 +1100,1305 @@ void handleWiFiReconnect(String ssid, String password) {
   }
 }
 
-void loop() {
-  //Serial.print("Loop.");
+// ---------------------------------------------------------------------------
+// Description déclarative des écrans
+// ---------------------------------------------------------------------------
+// Chaque écran = une fonction d'entrée (boutons) + une fonction de dessin,
+// rangées dans une table indexée par ScreenState (recherche directe).
+// Les éditeurs Date/Temp sont décrits par des tables de champs const (en flash)
+// et partagent le même code d'édition et de rendu.
+
+// Types de champ éditable
+enum FieldType : uint8_t {
+  FieldInt,     // entier affiché sur nbChar chiffres (zéro de tête)
+  FieldFixed    // température en centièmes, affichée "xx.x"
+};
 
-  // Activation de l'OTA
-  ArduinoOTA.handle();
+// Champ éditable : valeur, bornes, pas et position à l'écran
+struct FieldDesc {
+  FieldType type;
+  uint8_t x, y;       // position du texte (police fub11)
+  uint8_t nbChar;     // largeur en caractères (centrage de la flèche)
+  int *value;
+  int16_t minVal, maxVal, step;
+};
 
-  // Vérifier/reconnecter le WiFi si besoin
-  handleWiFiReconnect(wifiSSID, wifiPass);
+// Texte fixe (séparateurs, libellés)
+struct LabelDesc {
+  uint8_t x, y;
+  const char *text;
+};
 
-  // Récupération de la date et de l'heure
-  char date[30];
-  DateTime now = rtc.now();
-  if (menuState != Date) {
-    //sprintf(date, "%02d/%02d/%04d %02d:%02d:%02d",
-    //  now.day(), now.month(), now.year(),
-    //  now.hour(), now.minute(), now.second());
-    day=now.day();
-    month=now.month();
-    year=now.year();
-    hour=now.hour();
-    minute=now.minute();
-  }
-  sprintf(date, "%02d/%02d %02d:%02d:%02d",
-    day, month, hour, minute, now.second());
+// Éditeur : menuIndex 1..nbFields édite un champ, nbFields+1 valide
+struct EditorDesc {
+  const char *title;
+  uint8_t titleX;
+  const LabelDesc *labels;
+  uint8_t nbLabels;
+  const FieldDesc *fields;
+  uint8_t nbFields;
+  bool checkIcon;       // icône de validation en bas à droite
+  uint8_t menuPos;      // position dans le menu au retour
+  void (*onSave)();
+};
 
-  // Récupération de la température cible
-  //tempCible = getTempCible(rtc.now());
-  if (!manualTemp) tempCible = getTempCible(rtc.now());
+// Sauvegarde de la date dans le RTC
+void saveDate() {
+  DateTime nouvelleDate(year, month, day, hour, minute, 0);
+  regleHorloge(nouvelleDate);
+}
 
-  // Mise à jour de la tempéraure
-  // Timer pour la température
-  static unsigned long lastRequest = 0;
-  if (millis() - lastRequest > tempDelay) {
-    ds.requestTemperatures(); 
-    lastRequest = millis();
-  }
-  float t = ds.getTempCByIndex(0);   // on lit la dernière valeur dispo (sans bloquer)
-  if (t == DEVICE_DISCONNECTED_C) {
-    tempAct=66.6;
+// Copie de travail de la programmation avant édition
+void enterTemp() {
+  progHourDayTemp = progHourDay;
+  progMinuteDayTemp = progMinuteDay;
+  progTempDayTemp = progTempDay;
+  progHourNightTemp = progHourNight;
+  progMinuteNightTemp = progMinuteNight;
+  progTempNightTemp = progTempNight;
+}
+
+// Mise à jour et sauvegarde de la programmation
+void saveTemp() {
+  progHourDay = progHourDayTemp;
+  progMinuteDay = progMinuteDayTemp;
+  progTempDay = progTempDayTemp;
+  progHourNight = progHourNightTemp;
+  progMinuteNight = progMinuteNightTemp;
+  progTempNight = progTempNightTemp;
+  // Sauvegarde dans les préférences
+  prefs.begin("config", false);
+  prefs.putInt("hourDay", progHourDay);
+  prefs.putInt("minDay", progMinuteDay);
+  prefs.putShort("tempDayC", progTempDay);
+  prefs.putInt("hourNight", progHourNight);
+  prefs.putInt("minNight", progMinuteNight);
+  prefs.putShort("tempNightC", progTempNight);
+  prefs.end();
+}
+
+const LabelDesc dateLabels[] = {
+  {42, 35, "/"}, {69, 35, "/"}, {60, 57, ":"}
+};
+const FieldDesc dateFields[] = {
+  {FieldInt, 22, 35, 2, &day,    1, 31,   1},
+  {FieldInt, 49, 35, 2, &month,  1, 12,   1},
+  {FieldInt, 76, 35, 4, &year,   1, 9999, 1},
+  {FieldInt, 40, 57, 2, &hour,   0, 23,   1},
+  {FieldInt, 66, 57, 2, &minute, 0, 59,   1}
+};
+const EditorDesc dateEditor = {
+  "DateProg", 30, dateLabels, 3, dateFields, 5, true, 1, saveDate
+};
+
+const LabelDesc tempLabels[] = {
+  {0, 35, "D_"}, {44, 35, ":"}, {71, 35, "="},
+  {0, 57, "N_"}, {44, 57, ":"}, {71, 57, "="}
+};
+const FieldDesc tempFields[] = {
+  {FieldInt,   24, 35, 2, &progHourDayTemp,     0, 23,  1},
+  {FieldInt,   51, 35, 2, &progMinuteDayTemp,   0, 59,  1},
+  {FieldFixed, 88, 35, 4, &progTempDayTemp,     0, 5000, 10},
+  {FieldInt,   24, 57, 2, &progHourNightTemp,   0, 23,  1},
+  {FieldInt,   51, 57, 2, &progMinuteNightTemp, 0, 59,  1},
+  {FieldFixed, 88, 57, 4, &progTempNightTemp,   0, 5000, 10}
+};
+const EditorDesc tempEditor = {
+  "TempProg", 30, tempLabels, 6, tempFields, 6, false, 2, saveTemp
+};
+
+// Applique un pas à un champ : rebouclage pour les entiers, butée pour la virgule fixe
+void stepField(const FieldDesc &f, int dir) {
+  int v = *f.value + dir * f.step;
+  if (f.type == FieldFixed) {
+    v = constrain(v, f.minVal, f.maxVal);
   } else {
-    tempAct=t;
+    if (v > f.maxVal) v = f.minVal;
+    if (v < f.minVal) v = f.maxVal;
   }
+  *f.value = v;
+}
 
-  // Activation du chauffage
-  if (tempAct<tempCible)
-  {
-    digitalWrite(PIN_RELAY, HIGH);  // relais ON
+// Gestion générique des boutons d'un éditeur
+void inputEditor(const EditorDesc &e) {
+  if (btnGauche.fell() && menuIndex > 0)              menuIndex--;
+  if (btnDroite.fell() && menuIndex < e.nbFields + 1) menuIndex++;
+  if (menuIndex == 0) {
+    menuState = Menu;
+    menuIndex = e.menuPos;
+  } else if (menuIndex <= e.nbFields) {
+    const FieldDesc &f = e.fields[menuIndex - 1];
+    if (repeatStep(btnHaut)) stepField(f, +1);
+    if (repeatStep(btnBas))  stepField(f, -1);
   } else {
-    digitalWrite(PIN_RELAY, LOW);   // relais OFF
+    drawSave();
+    e.onSave();
+    menuState = Accueil;
+    menuIndex = 0;
   }
+}
 
-  // Récupération de la puissance du signal WiFi
-  // Timer pour le RSSI
-  static unsigned long lastRSSIRequest = 0;
-  static long rssi = 0;
-  if (millis() - lastRSSIRequest > 1000) {  // toutes les 1s
-    rssi = WiFi.RSSI();
-    lastRSSIRequest = millis();
+// Rendu générique d'un éditeur
+void drawEditor(const EditorDesc &e) {
+  char buf[16];
+  u8g2.setFont(u8g2_font_fub11_tr); // choisir police adaptée
+  u8g2.drawStr(e.titleX, 11, e.title); // glyphes: {tableau:dateEditor}{tableau:tempEditor}
+  for (int i = 0; i < e.nbLabels; i++) {
+    u8g2.drawStr(e.labels[i].x, e.labels[i].y, e.labels[i].text); // glyphes: {tableau:dateLabels}{tableau:tempLabels}
   }
-
-  // Mise à jour debounce
-  btnHaut.update();
-  btnBas.update();
-  btnGauche.update();
-  btnDroite.update();
-
-  // Navigation menu
-  if (menuState == Accueil) {
-    if (btnDroite.fell()) {
-      menuState = Menu;
-      if (menuIndex == 0) menuIndex = 1;
-    }
-    // Ajustement température quand on est en Accueil
-    // Passe en manuel si la consigne change
-    //if (btnHaut.fell()) tempCible += 0.1;
-    //if (btnBas.fell())  tempCible -= 0.1;
-    if (handleRepeat(btnHaut, tempCible, +0.1, hautPressedSince, hautLastRepeat)) {
-      manualTemp = true;
-    }
-    if (handleRepeat(btnBas,  tempCible, -0.1, basPressedSince,  basLastRepeat)) {
-      manualTemp = true;
-    }
-    if (btnGauche.fell()) {
-      manualTemp = false;
-    }
-  } else if (menuState == Menu) {
-    if (btnHaut.fell() && menuIndex > 1)   menuIndex--;
-    if (btnBas.fell()  && menuIndex < 4)   menuIndex++;
-    if (btnGauche.fell()) {
-      menuState = Accueil;
-      menuIndex = 0;
-    }
-    if (btnDroite.fell() && menuIndex == 1) {
-      menuState = Date;
-      menuIndex = 1;
+  for (int i = 0; i < e.nbFields; i++) {
+    const FieldDesc &f = e.fields[i];
+    if (f.type == FieldFixed) {
+      snprintf(buf, sizeof(buf), "%02d.%d", *f.value / 100, (*f.value / 10) % 10);
+    } else {
+      snprintf(buf, sizeof(buf), "%0*d", f.nbChar, *f.value);
     }
-    if (btnDroite.fell() && menuIndex == 2) {
-      menuState = Temp;
-      menuIndex = 1;
-      progHourDayTemp = progHourDay;
-      progMinuteDayTemp = progMinuteDay;
-      progTempDayTemp = progTempDay;
-      progHourNightTemp = progHourNight;
-      progMinuteNightTemp = progMinuteNight;
-      progTempNightTemp = progTempNight;
+    u8g2.drawStr(f.x, f.y, buf); // glyphes: 0123456789.
+    if (menuIndex == i + 1) drawArrow(f.x, f.y, 11, f.nbChar);
+  }
+  if (e.checkIcon) {
+    u8g2.setFont(u8g2_font_open_iconic_check_1x_t);
+    u8g2.drawGlyph(100, 57, 0x0040);
+  }
+}
+
+// Saisie d'un texte caractère par caractère (SSID, mot de passe)
+// Gauche efface (ou sort si vide), droite court ajoute, droite long valide
+void inputTexte(String &texte, int indexSortie, int indexValide) {
+  int nChars = sizeof(charSet) - 1; // nombre de caractères dispo
+  handleRepeatInt(btnHaut, charIndex, 0, nChars-1, +1);
+  handleRepeatInt(btnBas,  charIndex, 0, nChars-1, -1);
+  if (btnGauche.fell()) {
+    if (texte.length() > 0) texte.remove(texte.length()-1);
+    else {
+      wifiState = WifiMain; // sortie
+      menuIndex = indexSortie;
     }
-    if (btnDroite.fell() && menuIndex == 3) {
-      menuState = Wifi;
-      menuIndex = 1;
-      wifiState = WifiMain;
-    }
-    if (btnDroite.fell() && menuIndex == 4) {
-      menuState = Version;
-      menuIndex = 1;
-      versionState = VersionMain;
+  }
+  // Arme l'appui court (un appui commencé sur un autre écran est ignoré)
+  if (btnDroite.fell()) {
+    droiteArme = true;
+  }
+  // Gestion du long appui : sortie directe après 2s d'appui
+  if (btnDroite.longPress() && droiteArme) {
+    droiteArme = false;
+    wifiState = WifiMain;
+    menuIndex = indexValide;
+  }
+  // Gestion du court appui : relâché avant le long appui
+  if (btnDroite.rose() && droiteArme) {
+    texte += charSet[charIndex]; // Ajjout du character
+    droiteArme = false;
+  }
+}
+
+// Entrées du menu principal : libellé, écran cible, action à l'entrée
+struct MenuItem {
+  const char *label;
+  ScreenState target;
+  void (*onEnter)();
+};
+
+void enterWifi()    { wifiState = WifiMain; }
+void enterVersion() { versionState = VersionMain; }
+
+const MenuItem menuItems[] = {
+  {"Date",      Date,    nullptr},
+  {"Prog Temp", Temp,    enterTemp},
+  {"Wifi",      Wifi,    enterWifi},
+  {"Version",   Version, enterVersion},
+  {"Stats",     Stats,   nullptr},
+  {"Tendance",  TendanceEcran, nullptr}
+};
+const int nbMenuItems = sizeof(menuItems) / sizeof(menuItems[0]);
+// Entrées visibles à l'écran, la liste défile au-delà
+const int nbMenuVisibles = 4;
+
+// Fonction affichage menu
+void drawMenu() {
+  int marge = 16;
+  int premier = menuIndex > nbMenuVisibles ? menuIndex - nbMenuVisibles : 0;
+
+  for (int i = premier; i < nbMenuItems && i < premier + nbMenuVisibles; i++) {
+    int y = marge + (i - premier) * marge; // position verticale
+
+    if (i + 1 == menuIndex) {
+      // rectangle de sélection
+      u8g2.drawBox(0, y - marge, LARGEUR_ECRAN, marge); // -14 pour décaler le haut
+      u8g2.setDrawColor(0); // texte noir
+    } else {
+      u8g2.setDrawColor(1); // texte blanc
     }
-  } else if (menuState == Date) {
-    if (btnGauche.fell() && menuIndex > 0)   menuIndex--;
-    if (btnDroite.fell()  && menuIndex < 6)   menuIndex++;
-    if (menuIndex == 0) {
+    // dessiner le texte
+    u8g2.setFont(u8g2_font_fub11_tr); // choisir police adaptée
+    u8g2.drawStr(2, y -4, menuItems[i].label); // glyphes: {tableau:menuItems}
+    u8g2.setDrawColor(1); // remettre blanc pour la suite
+  }
+}
+
+void inputAccueil() {
+  if (btnDroite.fell()) {
+    menuState = Menu;
+    if (menuIndex == 0) menuIndex = 1;
+  }
+  // Ajustement température quand on est en Accueil
+  // Passe en manuel si la consigne change
+  if (handleRepeat(btnHaut, tempCible, +10)) {
+    manualTemp = true;
+  }
+  if (handleRepeat(btnBas,  tempCible, -10)) {
+    manualTemp = true;
+  }
+  if (btnGauche.fell()) {
+    manualTemp = false;
+  }
+}
+
+void inputMenu() {
+  if (btnHaut.fell() && menuIndex > 1)           menuIndex--;
+  if (btnBas.fell()  && menuIndex < nbMenuItems) menuIndex++;
+  if (btnGauche.fell()) {
+    menuState = Accueil;
+    menuIndex = 0;
+  }
+  if (btnDroite.fell()) {
+    const MenuItem &item = menuItems[menuIndex - 1];
+    menuState = item.target;
+    menuIndex = 1;
+    if (item.onEnter) item.onEnter();
+  }
+}
+
+void inputDate() { inputEditor(dateEditor); }
+void inputTemp() { inputEditor(tempEditor); }
+void drawDate()  { drawEditor(dateEditor); }
+void drawTemp()  { drawEditor(tempEditor); }
+
+void inputWifi() {
+  if (wifiState == WifiMain){
+    if (btnHaut.fell() && menuIndex > 1)   menuIndex--;
+    if (btnBas.fell()  && menuIndex < 4)   menuIndex++;
+    if (btnGauche.fell()) {
       menuState = Menu;
-      menuIndex = 1;
+      menuIndex = 3;
     }
-    if (menuIndex == 1) {
-      handleRepeatInt(btnHaut, day, 1, 31, +1, hautPressedSince, hautLastRepeat);
-      handleRepeatInt(btnBas, day, 1, 31, -1, basPressedSince, basLastRepeat);
-    }
-    if (menuIndex == 2) {
-      handleRepeatInt(btnHaut, month, 1, 12, +1, hautPressedSince, hautLastRepeat);
-      handleRepeatInt(btnBas, month, 1, 12, -1, basPressedSince, basLastRepeat);
-    }
-    if (menuIndex == 3) {
-      handleRepeatInt(btnHaut, year, 1, 9999, +1, hautPressedSince, hautLastRepeat);
-      handleRepeatInt(btnBas, year, 1, 9999, -1, basPressedSince, basLastRepeat);
+    if (menuIndex == 1 && btnDroite.fell()) {
+      wifiState = WifiScan;
+      u8g2.clearBuffer(); // efface le buffer
+      u8g2.setFont(u8g2_font_fub11_tr); // choisir police adaptée
+      u8g2.drawStr(40, 38, "Wait ...");
+      busEnvoieEcran(u8g2);
+      wifiCount = WiFi.scanNetworks();
+      menuIndex = 0;
     }
-    if (menuIndex == 4) {
-      handleRepeatInt(btnHaut, hour, 0, 23, +1, hautPressedSince, hautLastRepeat);
-      handleRepeatInt(btnBas, hour, 0, 23, -1, basPressedSince, basLastRepeat);
+    if (menuIndex == 2 && btnDroite.fell()) {
+      wifiState = WifiSSID;
     }
-    if (menuIndex == 5) {
-      handleRepeatInt(btnHaut, minute, 0, 59, +1, hautPressedSince, hautLastRepeat);
-      handleRepeatInt(btnBas, minute, 0, 59, -1, basPressedSince, basLastRepeat);
+    if (menuIndex == 3 && btnDroite.fell()) {
+      wifiState = WifiPassword;
     }
-    if (menuIndex == 6) {
-      drawSave();
-      DateTime nouvelleDate(year, month, day, hour, minute, 0);
-      rtc.adjust(nouvelleDate);
+    if (menuIndex == 4 && btnDroite.fell()) {
+      wifiSSID = wifiSSIDTemp;
+      wifiPass = wifiPassTemp;
+      // Sauvegarde dans les préférences
+      prefs.begin("wifi", false);
+      prefs.putString("wifiSSID", wifiSSID);
+      prefs.putString("wifiPass", wifiPass);
+      prefs.end();
       menuState = Accueil;
       menuIndex = 0;
+      drawSave();
     }
-  } else if (menuState == Temp) {
-    if (btnGauche.fell() && menuIndex > 0)   menuIndex--;
-    if (btnDroite.fell()  && menuIndex < 7)   menuIndex++;
-    if (menuIndex == 0) {
-      menuState = Menu;
-      menuIndex = 2;
+  } else if (wifiState == WifiScan) {
+    if (btnGauche.fell()) {
+      wifiState = WifiMain;
+      menuIndex = 1;
     }
-    if (menuIndex == 1) {
-      handleRepeatInt(btnHaut, progHourDayTemp, 0, 23, +1, hautPressedSince, hautLastRepeat);
-      handleRepeatInt(btnBas, progHourDayTemp, 0, 23, -1, basPressedSince, basLastRepeat);
+    if (btnHaut.fell() && menuIndex > 0) menuIndex--;
+    if (btnBas.fell() && menuIndex < wifiCount-1) menuIndex++;
+    if (btnDroite.fell()) {
+      wifiSSIDTemp = WiFi.SSID(menuIndex);
+      wifiState = WifiMain;
+      menuIndex = 3;
     }
-    if (menuIndex == 2) {
-      handleRepeatInt(btnHaut, progMinuteDayTemp, 0, 59, +1, hautPressedSince, hautLastRepeat);
-      handleRepeatInt(btnBas, progMinuteDayTemp, 0, 59, -1, basPressedSince, basLastRepeat);
+  } else if (wifiState == WifiSSID) {
+    inputTexte(wifiSSIDTemp, 2, 3);
+  } else if (wifiState == WifiPassword) {
+    inputTexte(wifiPassTemp, 3, 4);
+  }
+}
+
+void inputVersion() {
+  if (btnGauche.fell() && versionState == VersionPairs) {
+    // Abandon de la mise à jour : les pairs ne nous attendent plus
+    partageEtat(PairInactif, "");
+    versionState = VersionMain;
+    return;   // l'appui annule l'attente, il ne quitte pas l'écran
+  }
+  if (btnGauche.fell() && menuIndex > 0)   menuIndex--;
+  if (menuIndex == 0) {
+    menuState = Menu;
+    menuIndex = 4;
+  }
+  if (btnDroite.fell() && versionState == VersionMain){
+    versionState = VersionCheck;
+  }
+  if (btnDroite.fell() && versionState == VersionUpdate){
+    versionState = VersionUpgrade;
+  }
+  if ((btnHaut.fell() || btnBas.fell()) && versionState == VersionMain){
+    stableVersion = !stableVersion;
+    u8g2.setFont(u8g2_font_fub11_tr);
+    u8g2.drawStr(0, HAUTEUR_ECRAN, stableVersion ? "switch to stable" : "switch to latest");
+    busEnvoieEcran(u8g2);
+    sleep(1);
+  }
+}
+
+// Affichage de l'écran d'accueil
+void drawAccueil() {
+  // Affichage de l'heure
+  u8g2.setFont(u8g2_font_ncenB08_tr); // Choix de la police
+  u8g2.drawStr(0, 8, dateStr); // glyphes: 0123456789/:{espace}
+
+  // Affichage de la température actuelle
+  // Conversion en chaîne de caractères avec 1 décimale
+  char tempStrAct[16];
+  formatTemp(tempStrAct, sizeof(tempStrAct), tempAct);
+  u8g2.setFont(u8g2_font_fub25_tr);
+  u8g2.drawStr(25, 45, tempStrAct); // Affiche la température ; glyphes: 0123456789.-
+  u8g2.setFont(u8g2_font_fub11_tr);
+  u8g2.drawStr(93, 27, "o");
+
+  // Affichage de la température cible
+  char tempStrCible[16];
+  formatTemp(tempStrCible, sizeof(tempStrCible), tempCible);
+  u8g2.setFont(u8g2_font_t0_12_tf);
+  u8g2.drawStr(95, HAUTEUR_ECRAN, tempStrCible); // glyphes: 0123456789.-
+  u8g2.setFont(u8g2_font_tiny5_tf);
+  u8g2.drawStr(120, 59, "o");
+  // Affichage d'une icone cadenat si forcage manuel de la température
+  if (manualTemp) {
+    u8g2.setFont(u8g2_font_open_iconic_thing_1x_t);
+    u8g2.drawGlyph(86, 65, 0x004f);
+  }
+
+  // Affichage de l'icône de chauffage (état réel du relais), ou d'un
+  // point d'exclamation si une règle de sécurité le tient ouvert
+  if (superviseurDefaut() != DefautAucun) {
+    u8g2.setFont(u8g2_font_fub11_tr);
+    u8g2.drawStr(4, 62, "!");
+  } else if (superviseurRelais())
+  {
+    u8g2.setFont(u8g2_font_open_iconic_embedded_2x_t);
+    u8g2.drawGlyph(0, HAUTEUR_ECRAN, 0x0043);
+  }
+
+  // Affichage du signal wifi
+  int x=120;
+  int y=10;
+  drawWiFiIcon(u8g2, x, y, rssi);
+  if (saveMsgUntil && ((long)saveMsgUntil - (long)millis()) > 0) {
+    u8g2.setFont(u8g2_font_fub11_tr);
+    u8g2.drawStr(25, HAUTEUR_ECRAN, "Saved !");
+  } else if (saveMsgUntil) {
+    saveMsgUntil = 0;
+  }
+}
+
+// Sauvegarde de la comptabilité (changement d'heure, puissance modifiée)
+void sauveConso() {
+  prefs.begin("conso", false);
+  prefs.putBytes("etat", &conso, sizeof(conso));
+  prefs.end();
+}
+
+// Export CSV sur le port série : 24 dernières heures puis 31 derniers jours,
+// du plus ancien au plus récent
+void exportConso() {
+  Serial.printf("# conso watts=%u total_wh=%lu\n", conso.watts,
+                (unsigned long)conso.wattheures(conso.totalSecondes));
+  Serial.println("heure,debut_unix,secondes_on,wh,charge_pourmille");
+  for (int i = CONSO_HEURES - 1; i >= 0; i--) {
+    uint16_t s = conso.secondesHeure(i);
+    Serial.printf("%d,%lu,%u,%lu,%u\n", -i, (unsigned long)(conso.heure - i) * 3600, s,
+                  (unsigned long)conso.wattheures(s), pourmilleCharge(s, 3600));
+  }
+  Serial.println("jour,debut_unix,secondes_on,wh,charge_pourmille");
+  for (int i = CONSO_JOURS - 1; i >= 0; i--) {
+    uint32_t s = conso.secondesJour(i);
+    Serial.printf("%d,%lu,%lu,%lu,%u\n", -i, (unsigned long)(conso.heure / 24 - i) * 86400,
+                  (unsigned long)s, (unsigned long)conso.wattheures(s), pourmilleCharge(s, 86400));
+  }
+}
+
+// Fenêtres glissantes puis colonnes de la courbe (en centièmes), la plus
+// ancienne en premier
+void exportTendance() {
+  const char *noms[] = { "1h", "24h" };
+  const StatsTendance fenetres[] = { tendance.heure.stats(), tendance.jour.stats() };
+  Serial.println("fenetre,mesures,min,moy,max,relais_pourmille");
+  for (int i = 0; i < 2; i++) {
+    const StatsTendance &s = fenetres[i];
+    Serial.printf("%s,%lu,%d,%d,%d,%u\n", noms[i], (unsigned long)s.mesures, s.min, s.moy, s.max,
+                  s.pourmilleRelais);
+  }
+  Serial.println("colonne,debut_unix,act_min,act_max,cible_min,cible_max");
+  for (int x = 0; x < TENDANCE_COLONNES; x++) {
+    const ColonneTendance &c = tendance.courbe.colonne(x);
+    if (c.actMin > c.actMax) continue;
+    int ilYa = TENDANCE_COLONNES - 1 - x;
+    Serial.printf("%d,%lu,%d,%d,%d,%d\n", -ilYa,
+                  (unsigned long)(tendance.courbe.index - ilYa) * TENDANCE_COLONNE_S,
+                  c.actMin, c.actMax, c.cibleMin, c.cibleMax);
+  }
+}
+
+// Compte le temps relais fermé de l'itération écoulée
+void updateConso(uint32_t unixtime, bool relais) {
+  static unsigned long dernier = millis();
+  static bool relaisPrec = false;
+  unsigned long maintenant = millis();
+  // L'état du relais valait pour l'intervalle qui se termine
+  if (conso.avance(unixtime, relaisPrec, maintenant - dernier)) sauveConso();
+  dernier = maintenant;
+  relaisPrec = relais;
+}
+
+// Sauvegarde de l'état de régulation dans le bloc de reprise (mémoire RTC,
+// quelques dizaines de µs : à chaque mesure) ; la première mesure après le
+// démarrage date la reprise de la régulation
+void sauveReprise(DateTime now, bool relais) {
+  if (!controleRepris) {
+    controleRepris = true;
+    uint16_t duree = (uint16_t)min(millis(), 65535UL);
+    if (repriseChaude) reprise.dureeChaudMs = duree;
+    else reprise.dureeFroidMs = duree;
+    Serial.printf("Regulation reprise %lu ms apres le demarrage (%s)\n",
+                  (unsigned long)duree, repriseChaude ? "a chaud" : "a froid");
+  }
+  if (millis() > REPRISE_STABLE_MS) reprise.crashsConsecutifs = 0;
+  reprise.controle = true;
+  reprise.manuel = manualTemp;
+  reprise.relais = relais;
+  reprise.tempAct = tempAct;
+  reprise.tempCible = tempCible;
+  reprise.tempRaw = tempRaw;
+  reprise.msSauve = millis();
+  reprise.unixSauve = now.unixtime();
+  reprise.derivePpm = horlogeDerivePpm();
+  reprise.resolution = resolution;
+  reprise.prechauffe = prechauffe;
+  reprise.conso = conso;
+  reprise.scelle();
+}
+
+void exportReprise() {
+  Serial.printf("# reprise derniere=%s crashs=%u chaud_ms=%u froid_ms=%u\n",
+                nomsCause[reprise.derniereCause], reprise.crashsConsecutifs,
+                reprise.dureeChaudMs, reprise.dureeFroidMs);
+  for (int i = 0; i < NbCausesReset; i++) {
+    Serial.printf("%s,%u\n", nomsCause[i], reprise.resets[i]);
+  }
+}
+
+// Bits TELEMETRIE_* de l'état courant (télémétrie et balises)
+uint8_t etatTelemetrie() {
+  uint8_t etat = (uint8_t)(superviseurDefaut() << TELEMETRIE_DEFAUT_DECALAGE);
+  if (superviseurRelais()) etat |= TELEMETRIE_RELAIS;
+  if (thermostat.demande) etat |= TELEMETRIE_DEMANDE;
+  if (manualTemp) etat |= TELEMETRIE_MANUEL;
+  if (ecranAllume) etat |= TELEMETRIE_ECRAN;
+  if (WiFi.status() == WL_CONNECTED) etat |= TELEMETRIE_WIFI;
+  return etat;
+}
+
+// État montré par le tableau de bord web
+EtatTableau etatTableau() {
+  EtatTableau e;
+  e.tempAct = dixiemesTemp(tempAct);
+  e.tempCible = dixiemesTemp(tempCible);
+  e.relais = superviseurRelais();
+  e.manuel = manualTemp;
+  e.defaut = (uint8_t)superviseurDefaut();
+  return e;
+}
+
+// Trame de télémétrie si la période est écoulée ; sautée plutôt que
+// d'attendre si le tampon d'émission n'a pas la place
+void envoieTelemetrie() {
+  if (telemetriePeriode == 0 || millis() - derniereTelemetrie < telemetriePeriode) return;
+  if (Serial.availableForWrite() < (int)TELEMETRIE_TRAME_MAX) return;
+  derniereTelemetrie = millis();
+
+  MesureTelemetrie m;
+  m.ms = derniereTelemetrie;
+  m.raw = tempRaw;
+  m.temp = tempAct;
+  m.cible = tempCible;
+  m.etat = etatTelemetrie();
+  m.rssi = (int8_t)rssi;
+  m.resolution = resolution.bits;
+  m.boucleUs = boucleUs;
+
+  uint8_t trame[TELEMETRIE_TRAME_MAX];
+  Serial.write(trame, encodeTelemetrie(m, trame));
+}
+
+// Balise d'état : en broadcast à chaque période et sur changement, à
+// l'émetteur d'une sonde de découverte. L'envoi UDP ne bloque pas (lwIP
+// refuse le paquet s'il n'a pas de tampon : la balise suivante le remplace)
+void envoieBalise() {
+  if (WiFi.status() != WL_CONNECTED) {
+    if (baliseOuverte) udpBalise.stop();
+    baliseOuverte = false;
+    return;
+  }
+  if (!baliseOuverte) baliseOuverte = udpBalise.begin(BALISE_PORT);
+  if (!baliseOuverte) return;
+
+  // Sondes reçues depuis la dernière itération (nos propres balises
+  // broadcast sont écartées au type)
+  bool sonde = false;
+  IPAddress sondeIP;
+  uint16_t sondePort = 0;
+  for (int i = 0; i < 4 && udpBalise.parsePacket() > 0; i++) {
+    uint8_t type = 0;
+    if (udpBalise.read(&type, 1) == 1 && type == BALISE_SONDE) {
+      sonde = true;
+      sondeIP = udpBalise.remoteIP();
+      sondePort = udpBalise.remotePort();
     }
-    if (menuIndex == 3) {
-      handleRepeat(btnHaut, progTempDayTemp, +0.1, hautPressedSince, hautLastRepeat);
-      handleRepeat(btnBas,  progTempDayTemp, -0.1, basPressedSince,  basLastRepeat);
+  }
+
+  Balise b;
+  b.id = partageId();
+  versionBalise(currentVersion.c_str(), b.version);
+  b.temp = tempAct;
+  b.cible = tempCible;
+  b.etat = etatTelemetrie();
+  b.rssi = (int8_t)rssi;
+  b.disponibilite = millis() / 1000;
+  b.periode = balisePeriode;
+
+  unsigned long ecoule = millis() - derniereBaliseMs;
+  bool diffuse = balisePeriode != 0 &&
+                 (ecoule >= balisePeriode * 1000UL ||
+                  (ecoule >= BALISE_CHANGEMENT_MIN_MS && baliseChange(derniereBalise, b)));
+  if (!sonde && !diffuse) return;
+
+  uint8_t trame[BALISE_TAILLE];
+  if (sonde) {
+    b.sequence = baliseSequence++;
+    udpBalise.beginPacket(sondeIP, sondePort);
+    udpBalise.write(trame, encodeBalise(b, trame));
+    udpBalise.endPacket();
+  }
+  if (diffuse) {
+    b.sequence = baliseSequence++;
+    udpBalise.beginPacket(WiFi.broadcastIP(), BALISE_PORT);
+    udpBalise.write(trame, encodeBalise(b, trame));
+    udpBalise.endPacket();
+    derniereBalise = b;
+    derniereBaliseMs = millis();
+  }
+}
+
+void envoieImprov(ImprovType type, const uint8_t *donnees, uint8_t longueur) {
+  uint8_t paquet[IMPROV_PAQUET_MAX];
+  Serial.write(paquet, encodeImprov(paquet, type, donnees, longueur));
+}
+
+void envoieImprovOctet(ImprovType type, uint8_t valeur) {
+  envoieImprov(type, &valeur, 1);
+}
+
+void envoieImprovResultat(uint8_t rpc, const char *const *chaines, int n) {
+  uint8_t donnees[255];
+  envoieImprov(ImprovResultat, donnees, (uint8_t)donneesResultat(donnees, rpc, chaines, n));
+}
+
+// Adresse du tableau de bord, seul résultat d'une connexion réussie
+void envoieImprovAdresse(uint8_t rpc) {
+  char url[32];
+  snprintf(url, sizeof(url), "http://%s/", WiFi.localIP().toString().c_str());
+  const char *chaines[] = { url };
+  envoieImprovResultat(rpc, chaines, 1);
+}
+
+// Commande Improv complète reçue sur le port série
+void traiteImprov() {
+  if (improv.type != ImprovCommande) return;   // nos propres types en écho : ignorés
+  CommandeImprov c;
+  if (!decodeCommande(improv.donnees, improv.longueur, c)) {
+    envoieImprovOctet(ImprovErreur, ImprovPaquetInvalide);
+    return;
+  }
+  envoieImprovOctet(ImprovErreur, ImprovSansErreur);
+  if (c.rpc == ImprovRpcWifi) {
+    // Les identifiants en place restent sauvegardés tant que les
+    // nouveaux n'ont pas fait leurs preuves
+    improvSSID = c.ssid;
+    improvPass = c.motDePasse;
+    improvConnexion = true;
+    improvDebut = millis();
+    envoieImprovOctet(ImprovEtat, ImprovConnexion);
+    WiFi.disconnect();
+    WiFi.begin(improvSSID, improvPass);
+  } else if (c.rpc == ImprovRpcEtat) {
+    bool connecte = WiFi.status() == WL_CONNECTED;
+    envoieImprovOctet(ImprovEtat, improvConnexion ? ImprovConnexion : connecte ? ImprovConnecte : ImprovPret);
+    if (connecte && !improvConnexion) envoieImprovAdresse(ImprovRpcEtat);
+  } else if (c.rpc == ImprovRpcInfo) {
+    char nom[16];
+    snprintf(nom, sizeof(nom), "tapis-%08lx", (unsigned long)partageId());
+    const char *chaines[] = { "Tapis chauffant", currentVersion.c_str(), "ESP32-C3", nom };
+    envoieImprovResultat(ImprovRpcInfo, chaines, 4);
+  } else if (c.rpc == ImprovRpcScan) {
+    if (!improvScan) {
+      WiFi.scanNetworks(true);   // asynchrone : résultats suivis par updateImprov()
+      improvScan = true;
     }
-    if (menuIndex == 4) {
-      handleRepeatInt(btnHaut, progHourNightTemp, 0, 23, +1, hautPressedSince, hautLastRepeat);
-      handleRepeatInt(btnBas, progHourNightTemp, 0, 23, -1, basPressedSince, basLastRepeat);
+  } else {
+    envoieImprovOctet(ImprovErreur, ImprovCommandeInconnue);
+  }
+}
+
+// Suivi non bloquant de la connexion d'essai et du scan
+void updateImprov() {
+  if (improvScan) {
+    int n = WiFi.scanComplete();
+    if (n != WIFI_SCAN_RUNNING) {
+      for (int i = 0; i < n; i++) {
+        String ssid = WiFi.SSID(i);
+        char rssiTexte[8];
+        snprintf(rssiTexte, sizeof(rssiTexte), "%ld", (long)WiFi.RSSI(i));
+        const char *chaines[] = { ssid.c_str(), rssiTexte,
+                                  WiFi.encryptionType(i) == WIFI_AUTH_OPEN ? "NO" : "YES" };
+        envoieImprovResultat(ImprovRpcScan, chaines, 3);
+      }
+      envoieImprovResultat(ImprovRpcScan, nullptr, 0);   // fin de liste
+      WiFi.scanDelete();
+      improvScan = false;
     }
-    if (menuIndex == 5) {
-      handleRepeatInt(btnHaut, progMinuteNightTemp, 0, 59, +1, hautPressedSince, hautLastRepeat);
-      handleRepeatInt(btnBas, progMinuteNightTemp, 0, 59, -1, basPressedSince, basLastRepeat);
+  }
+  if (!improvConnexion) return;
+  if (WiFi.status() == WL_CONNECTED && WiFi.SSID() == improvSSID) {
+    improvConnexion = false;
+    wifiSSID = improvSSID;
+    wifiPass = improvPass;
+    prefs.begin("wifi", false);
+    prefs.putString("wifiSSID", wifiSSID);
+    prefs.putString("wifiPass", wifiPass);
+    prefs.end();
+    envoieImprovOctet(ImprovEtat, ImprovConnecte);
+    envoieImprovAdresse(ImprovRpcWifi);
+    Serial.printf("WiFi provisionne : %s\n", wifiSSID.c_str());
+  } else if (millis() - improvDebut >= IMPROV_CONNEXION_MS) {
+    // Échec : retour au réseau sauvegardé
+    improvConnexion = false;
+    envoieImprovOctet(ImprovErreur, ImprovEchecConnexion);
+    envoieImprovOctet(ImprovEtat, ImprovPret);
+    WiFi.disconnect();
+    WiFi.begin(wifiSSID, wifiPass);
+  }
+}
+
+// "21.5" en centièmes de degré, au dixième comme les éditeurs ; false hors
+// de 0..50 °C
+static bool litTemp(const char *texte, int &centi) {
+  char *fin;
+  float c = strtof(texte, &fin);
+  if (fin == texte) return false;
+  while (isspace((unsigned char)*fin)) fin++;
+  if (*fin != '\0' || c < 0 || c > 50) return false;
+  centi = (int)lroundf(c * 10) * 10;
+  return true;
+}
+
+// Nombre de jours du mois (1..12), années bissextiles comprises
+static int joursDansMois(int annee, int mois) {
+  static const uint8_t jours[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  bool bissextile = (annee % 4 == 0 && annee % 100 != 0) || annee % 400 == 0;
+  return mois == 2 && bissextile ? 29 : jours[mois - 1];
+}
+
+// Réglages des éditeurs sans écran ni boutons (unité relais), depuis le
+// port série ou le tableau de bord ; mêmes préférences et mêmes bornes :
+//   consigne 21.5 | consigne auto          forçage manuel, comme l'accueil
+//   programme 09:30 25.5 19:00 20.5        écran TempProg
+//   date 2026-10-19 14:30                  écran DateProg
+// Retourne false si la commande n'est pas un réglage valide.
+bool appliqueReglage(const char *commande) {
+  int hj, mj, hn, mn, tj, tn, a, mo, j, h, mi;
+  char tempJour[8], tempNuit[8];
+  if (strcmp(commande, "consigne auto") == 0) {
+    manualTemp = false;
+    Serial.println("consigne=auto");
+  } else if (strncmp(commande, "consigne ", 9) == 0) {
+    int c;
+    if (!litTemp(commande + 9, c)) return false;
+    tempCible = c;
+    manualTemp = true;
+    Serial.printf("consigne=%d manuelle\n", tempCible);
+  } else if (sscanf(commande, "programme %d:%d %7s %d:%d %7s", &hj, &mj, tempJour,
+                    &hn, &mn, tempNuit) == 6) {
+    if (hj < 0 || hj > 23 || mj < 0 || mj > 59 || hn < 0 || hn > 23 || mn < 0 || mn > 59 ||
+        !litTemp(tempJour, tj) || !litTemp(tempNuit, tn)) return false;
+    progHourDayTemp = hj;
+    progMinuteDayTemp = mj;
+    progTempDayTemp = tj;
+    progHourNightTemp = hn;
+    progMinuteNightTemp = mn;
+    progTempNightTemp = tn;
+    saveTemp();
+    Serial.printf("programme=%02d:%02d %d %02d:%02d %d\n", progHourDay, progMinuteDay,
+                  progTempDay, progHourNight, progMinuteNight, progTempNight);
+  } else if (sscanf(commande, "date %d-%d-%d %d:%d", &a, &mo, &j, &h, &mi) == 5) {
+    if (a < 2000 || a > 2099 || mo < 1 || mo > 12 || j < 1 || j > joursDansMois(a, mo) ||
+        h < 0 || h > 23 || mi < 0 || mi > 59) return false;
+    year = a;
+    month = mo;
+    day = j;
+    hour = h;
+    minute = mi;
+    saveDate();
+    Serial.printf("date=%04d-%02d-%02d %02d:%02d\n", year, month, day, hour, minute);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Lecture non bloquante d'une ligne de commande sur le port série ; les
+// paquets Improv passent avant et ne laissent rien dans la ligne
+void lireSerie() {
+  while (Serial.available() > 0) {
+    char c = (char)Serial.read();
+    LectureImprov lu = improv.lit((uint8_t)c);
+    if (lu == ImprovPaquet || lu == ImprovInvalide) {
+      commandeLongueur = 0;
+      if (lu == ImprovPaquet) traiteImprov();
+      else envoieImprovOctet(ImprovErreur, ImprovPaquetInvalide);
+      continue;
     }
-    if (menuIndex == 6) {
-      handleRepeat(btnHaut, progTempNightTemp, +0.1, hautPressedSince, hautLastRepeat);
-      handleRepeat(btnBas,  progTempNightTemp, -0.1, basPressedSince,  basLastRepeat);
+    if (improv.dansPaquet()) continue;
+    if (c != '\n' && c != '\r') {
+      if (commandeLongueur < sizeof(commandeSerie) - 1) commandeSerie[commandeLongueur++] = c;
+      continue;
     }
-    if (menuIndex == 7) {
-      drawSave();
-      menuState = Accueil;
-      menuIndex = 0;
-      // Mise à jour des valeurs
-      progHourDay = progHourDayTemp;
-      progMinuteDay = progMinuteDayTemp;
-      progTempDay = progTempDayTemp;
-      progHourNight = progHourNightTemp;
-      progMinuteNight = progMinuteNightTemp;
-      progTempNight = progTempNightTemp;
-      // Sauvegarde dans les préférences
+    if (commandeLongueur == 0) continue;
+    commandeSerie[commandeLongueur] = '\0';
+    commandeLongueur = 0;
+
+    if (strcmp(commandeSerie, "conso") == 0) {
+      exportConso();
+    } else if (strcmp(commandeSerie, "reprise") == 0) {
+      exportReprise();
+    } else if (strcmp(commandeSerie, "bus") == 0) {
+      exportBus();
+    } else if (strcmp(commandeSerie, "tableau") == 0) {
+      exportTableau();
+    } else if (strcmp(commandeSerie, "tendance") == 0) {
+      exportTendance();
+#if defined(TRACE_BOUCLE)
+    } else if (strcmp(commandeSerie, "trace") == 0) {
+      exportTrace();
+#endif
+    } else if (strncmp(commandeSerie, "telemetrie ", 11) == 0) {
+      telemetriePeriode = (uint32_t)atol(commandeSerie + 11);
       prefs.begin("config", false);
-      prefs.putInt("hourDay", progHourDay);
-      prefs.putInt("minDay", progMinuteDay);
-      prefs.putFloat("tempDay", progTempDay);
-      prefs.putInt("hourNight", progHourNight);
-      prefs.putInt("minNight", progMinuteNight);
-      prefs.putFloat("tempNight", progTempNight);
+      prefs.putUInt("telemetrie", telemetriePeriode);
       prefs.end();
-    }
-  } else if (menuState == Wifi) {
-    if (wifiState == WifiMain){
-      if (btnHaut.fell() && menuIndex > 1)   menuIndex--;
-      if (btnBas.fell()  && menuIndex < 4)   menuIndex++;
-      if (btnGauche.fell()) {
-        menuState = Menu;
-        menuIndex = 3;
-      }
-      if (menuIndex == 1 && btnDroite.fell()) {
-        wifiState = WifiScan;
-        u8g2.clearBuffer(); // efface le buffer
-        u8g2.setFont(u8g2_font_fub11_tr); // choisir police adaptée
-        u8g2.drawStr(40, 38, "Wait ...");
-        u8g2.sendBuffer();
-        wifiCount = WiFi.scanNetworks();
-        menuIndex = 0;
-      }
-      if (menuIndex == 2 && btnDroite.fell()) {
-        wifiState = WifiSSID;
-      }
-      if (menuIndex == 3 && btnDroite.fell()) {
-        wifiState = WifiPassword;
-      }
-      if (menuIndex == 4 && btnDroite.fell()) {
-        wifiSSID = wifiSSIDTemp;
-        wifiPass = wifiPassTemp;
-        // Sauvegarde dans les préférences
-        prefs.begin("wifi", false);
-        prefs.putString("wifiSSID", wifiSSID);
-        prefs.putString("wifiPass", wifiPass);
+      Serial.printf("telemetrie=%lu\n", (unsigned long)telemetriePeriode);
+    } else if (strncmp(commandeSerie, "balise ", 7) == 0) {
+      long periode = atol(commandeSerie + 7);
+      if (periode >= 0 && periode <= 3600) {
+        balisePeriode = (uint16_t)periode;
+        prefs.begin("config", false);
+        prefs.putUShort("balise", balisePeriode);
         prefs.end();
-        menuState = Accueil;
-        menuIndex = 0;
-        drawSave();
-      }
-    } else if (wifiState == WifiScan) {
-      if (btnGauche.fell()) {
-        wifiState = WifiMain;
-        menuIndex = 1;
+        Serial.printf("balise=%u\n", balisePeriode);
       }
-      if (btnHaut.fell() && menuIndex > 0) menuIndex--;
-      if (btnBas.fell() && menuIndex < wifiCount-1) menuIndex++;
-      if (btnDroite.fell()) {
-        wifiSSIDTemp = WiFi.SSID(menuIndex);
-        wifiState = WifiMain;
-        menuIndex = 3;
-      }
-    } else if (wifiState == WifiSSID) {
-      int nChars = sizeof(charSet) - 1; // nombre de caractères dispo
-      handleRepeatInt(btnHaut, charIndex, 0, nChars-1, +1, hautPressedSince, hautLastRepeat);
-      handleRepeatInt(btnBas,  charIndex, 0, nChars-1, -1, basPressedSince,  basLastRepeat);
-      if (btnGauche.fell()) {
-        if (wifiSSIDTemp.length() > 0) wifiSSIDTemp.remove(wifiSSIDTemp.length()-1);
-        else {
-          wifiState = WifiMain; // sortie
-          menuIndex = 2;
-        }
-      }
-      // Déclanchement du chrono à l'appuie
-      if (btnDroite.fell()) {
-        droitePressedAt = millis();
-      }
-      // Gestion du court appui
-      if (btnDroite.rose()) {  // relaché
-        // Si relâché avant 2s → appui court
-        if (droitePressedAt != 0) {
-          wifiSSIDTemp += charSet[charIndex]; // Ajjout du character
-          droitePressedAt = 0; // Reset pour éviter répétition
-        }
-      }
-      // Gestion du long appui
-      if (btnDroite.read() == LOW && droitePressedAt != 0) {
-        if (millis() - droitePressedAt >= LONG_PRESS_MS) {
-          droitePressedAt = 0;       // Reset pour éviter répétition
-          wifiState = WifiMain; // sortie directe après 2s d'appui
-          menuIndex = 3;
-        }
-      }
-    } else if (wifiState == WifiPassword) {
-      int nChars = sizeof(charSet) - 1; // nombre de caractères dispo
-      handleRepeatInt(btnHaut, charIndex, 0, nChars-1, +1, hautPressedSince, hautLastRepeat);
-      handleRepeatInt(btnBas,  charIndex, 0, nChars-1, -1, basPressedSince,  basLastRepeat);
-      if (btnGauche.fell()) {
-        if (wifiPassTemp.length() > 0) wifiPassTemp.remove(wifiPassTemp.length()-1);
-        else {
-          wifiState = WifiMain; // sortie
-          menuIndex = 3;
-        }
-      }
-      // Déclanchement du chrono à l'appuie
-      if (btnDroite.fell()) {
-        droitePressedAt = millis();
-      }
-      // Gestion du court appui
-      if (btnDroite.rose()) {  // relaché
-        // Si relâché avant 2s → appui court
-        if (droitePressedAt != 0) {
-          wifiPassTemp += charSet[charIndex]; // Ajjout du character
-          droitePressedAt = 0; // Reset pour éviter répétition
-        }
+    } else if (strncmp(commandeSerie, "baud ", 5) == 0) {
+      long baud = atol(commandeSerie + 5);
+      if (baud >= 9600 && baud <= 2000000) {
+        prefs.begin("config", false);
+        prefs.putUInt("baud", (uint32_t)baud);
+        prefs.end();
+        Serial.printf("baud=%ld au prochain demarrage\n", baud);
       }
-      // Gestion du long appui
-      if (btnDroite.read() == LOW && droitePressedAt != 0) {
-        if (millis() - droitePressedAt >= LONG_PRESS_MS) {
-          droitePressedAt = 0;       // Reset pour éviter répétition
-          wifiState = WifiMain; // sortie directe après 2s d'appui
-          menuIndex = 4;
-        }
+    } else if (strncmp(commandeSerie, "watts ", 6) == 0) {
+      long w = atol(commandeSerie + 6);
+      if (w > 0 && w <= CONSO_WATTS_MAX) {
+        conso.watts = (uint16_t)w;
+        sauveConso();
+        Serial.printf("watts=%u\n", conso.watts);
       }
+    } else if (appliqueReglage(commandeSerie)) {
+      // consigne, programme ou date, comme depuis les éditeurs
+    } else {
+      Serial.println("Commandes: conso | watts <n> | telemetrie <ms> | baud <n> | reprise | balise <s> | bus | tableau | tendance");
+      Serial.println("Reglages: consigne <C>|auto | programme HH:MM <C> HH:MM <C> | date AAAA-MM-JJ HH:MM");
     }
-  } else if (menuState == Version) {
-    if (btnGauche.fell() && menuIndex > 0)   menuIndex--;
-    //if (btnBas.fell()  && menuIndex < 1)   menuIndex++;
-    if (menuIndex == 0) {
-      menuState = Menu;
-      menuIndex = 4;
+  }
+}
+
+// Écran Stats : haut/bas règle la puissance du tapis, droite exporte sur
+// le port série, gauche revient au menu (sauvegarde si la puissance a changé)
+void inputStats() {
+  static bool modifie = false;
+  int watts = conso.watts;
+  handleRepeatInt(btnHaut, watts, 1, CONSO_WATTS_MAX, +1);
+  handleRepeatInt(btnBas,  watts, 1, CONSO_WATTS_MAX, -1);
+  if (watts != conso.watts) {
+    conso.watts = (uint16_t)watts;
+    modifie = true;
+  }
+  if (btnDroite.fell()) exportConso();
+  if (btnGauche.fell()) {
+    if (modifie) {
+      sauveConso();
+      drawSave();
+      modifie = false;
     }
-    if (btnDroite.fell() && versionState == VersionMain){
-      versionState = VersionCheck;
+    menuState = Menu;
+    menuIndex = 5;
+  }
+}
+
+void drawStats() {
+  char kwh[16];
+  char ligne[32];
+  uint32_t secondesJour = conso.heure != 0 ? horlogeNow().unixtime() % 86400 : 0;
+
+  u8g2.setFont(u8g2_font_ncenB08_tr);
+  uint32_t s = conso.secondesJour(0);
+  formatKwh(kwh, sizeof(kwh), conso.wattheures(s));
+  snprintf(ligne, sizeof(ligne), "Auj %s kWh %u%%", kwh, pourmilleCharge(s, secondesJour) / 10);
+  u8g2.drawStr(0, 8, ligne); // glyphes: Auj0123456789.kWh%{espace}
+
+  s = conso.secondesJour(1);
+  formatKwh(kwh, sizeof(kwh), conso.wattheures(s));
+  snprintf(ligne, sizeof(ligne), "Hier %s kWh %u%%", kwh, pourmilleCharge(s, 86400) / 10);
+  u8g2.drawStr(0, 18, ligne); // glyphes: Hier0123456789.kWh%{espace}
+
+  uint32_t semaine = 0;
+  for (int i = 0; i < 7; i++) semaine += conso.secondesJour(i);
+  formatKwh(kwh, sizeof(kwh), conso.wattheures(semaine));
+  snprintf(ligne, sizeof(ligne), "7j %s kWh  %uW", kwh, conso.watts);
+  u8g2.drawStr(0, 28, ligne); // glyphes: 7j0123456789.kWh{espace}
+
+  // Taux de charge des 24 dernières heures, la plus récente à droite
+  u8g2.drawHLine(3, HAUTEUR_ECRAN - 1, CONSO_HEURES * 5);
+  for (int i = 0; i < CONSO_HEURES; i++) {
+    int h = pourmilleCharge(conso.secondesHeure(CONSO_HEURES - 1 - i), 3600) * 30 / 1000;
+    if (h > 0) u8g2.drawBox(i * 5 + 4, HAUTEUR_ECRAN - 1 - h, 4, h);
+  }
+}
+
+// Écran Tendance : min / moy / max et taux de marche sur 1 h et 24 h, puis
+// courbe des 24 dernières heures (mesure en trait plein, consigne en
+// pointillé) ; droite exporte sur le port série, gauche revient au menu
+void inputTendance() {
+  if (btnDroite.fell()) exportTendance();
+  if (btnGauche.fell()) {
+    menuState = Menu;
+    menuIndex = 6;
+  }
+}
+
+// Zone de la courbe, sous les deux lignes de statistiques
+const int TENDANCE_HAUT = 22;
+const int TENDANCE_BAS = HAUTEUR_ECRAN - 1;
+
+// Ligne de statistiques d'une fenêtre
+void drawLigneTendance(int y, const char *nom, const StatsTendance &s) {
+  char buf[16];
+  u8g2.setFont(u8g2_font_tiny5_tf);
+  u8g2.drawStr(0, y, nom); // glyphes: 1h24
+  if (s.mesures == 0) {
+    u8g2.drawStr(20, y, "--");
+    return;
+  }
+  const centi_t valeurs[] = { s.min, s.moy, s.max };
+  for (int i = 0; i < 3; i++) {
+    formatTemp(buf, sizeof(buf), valeurs[i]);
+    u8g2.drawStr(20 + i * 26, y, buf); // glyphes: -0123456789.
+  }
+  snprintf(buf, sizeof(buf), "%u%%", s.pourmilleRelais / 10);
+  u8g2.drawStr(100, y, buf); // glyphes: 0123456789%
+}
+
+// Ordonnée d'une température entre les bornes bas et haut de l'échelle
+int yTendance(int32_t temp, int32_t bas, int32_t haut) {
+  return TENDANCE_BAS - (int)((temp - bas) * (TENDANCE_BAS - TENDANCE_HAUT) / (haut - bas));
+}
+
+void drawTendance() {
+  u8g2.setFont(u8g2_font_tiny5_tf);
+  u8g2.drawStr(20, 5, "min");
+  u8g2.drawStr(46, 5, "moy");
+  u8g2.drawStr(72, 5, "max");
+  u8g2.drawStr(100, 5, "relais");
+  drawLigneTendance(12, "1h", tendance.heure.stats());
+  drawLigneTendance(19, "24h", tendance.jour.stats());
+
+  // Échelle ajustée aux colonnes affichées, 1 °C de haut au moins
+  int32_t bas = INT16_MAX, haut = INT16_MIN;
+  for (int x = 0; x < TENDANCE_COLONNES; x++) {
+    const ColonneTendance &c = tendance.courbe.colonne(x);
+    if (c.actMin > c.actMax) continue;
+    bas = min(bas, (int32_t)min(c.actMin, c.cibleMin));
+    haut = max(haut, (int32_t)max(c.actMax, c.cibleMax));
+  }
+  if (bas > haut) return;   // pas encore de mesure
+  if (haut - bas < 100) {
+    bas = (bas + haut) / 2 - 50;
+    haut = bas + 100;
+  }
+  for (int x = 0; x < TENDANCE_COLONNES; x++) {
+    const ColonneTendance &c = tendance.courbe.colonne(x);
+    if (c.actMin > c.actMax) continue;
+    int y = yTendance(c.actMax, bas, haut);
+    u8g2.drawVLine(x, y, yTendance(c.actMin, bas, haut) - y + 1);
+    if (x % 2 == 0) {
+      u8g2.drawPixel(x, yTendance(c.cibleMin, bas, haut));
+      u8g2.drawPixel(x, yTendance(c.cibleMax, bas, haut));
+    }
+  }
+}
+
+// Vues des écrans (voir include/rendu.h) : tout ce que draw() affiche,
+// à la résolution affichée
+void vueAccueil(Vue &v) {
+  char buf[16];
+  v.ajouteTexte(dateStr);
+  formatTemp(buf, sizeof(buf), tempAct);
+  v.ajouteTexte(buf);
+  formatTemp(buf, sizeof(buf), tempCible);
+  v.ajouteTexte(buf);
+  v.ajoute(manualTemp);
+  v.ajoute(superviseurDefaut());
+  v.ajoute(superviseurRelais());
+  v.ajoute(niveauWifi(rssi));
+  v.ajoute(saveMsgUntil && ((long)saveMsgUntil - (long)millis()) > 0);
+}
+
+void vueMenu(Vue &v) {
+  v.ajoute(menuIndex);
+}
+
+void vueEditeur(Vue &v, const EditorDesc &e) {
+  v.ajoute(menuIndex);
+  for (int i = 0; i < e.nbFields; i++) v.ajoute(*e.fields[i].value);
+}
+void vueDate(Vue &v) { vueEditeur(v, dateEditor); }
+void vueTemp(Vue &v) { vueEditeur(v, tempEditor); }
+
+void vueWifi(Vue &v) {
+  v.ajoute(wifiState);
+  v.ajoute(menuIndex);
+  v.ajoute(charIndex);
+  v.ajouteTexte(wifiSSIDTemp.c_str());
+  v.ajouteTexte(wifiPassTemp.c_str());
+}
+
+void vueVersion(Vue &v) {
+  v.ajoute(versionState);
+  v.ajoute(stableVersion);
+  v.ajoute(WiFi.status() == WL_CONNECTED);
+  v.ajouteTexte(currentVersion.c_str());
+  v.ajouteTexte(latestVersion.c_str());
+  // Vérification, mise à jour et recherche des pairs avancent dans
+  // drawVersion() : à chaque image permise
+  if (versionState == VersionCheck || versionState == VersionUpgrade || versionState == VersionPairs) {
+    v.ajoute(millis());
+  }
+}
+
+void vueStats(Vue &v) {
+  uint32_t secondesJour = conso.heure != 0 ? horlogeNow().unixtime() % 86400 : 0;
+  uint32_t s = conso.secondesJour(0);
+  v.ajoute(s);
+  v.ajoute(pourmilleCharge(s, secondesJour) / 10);
+  for (int i = 1; i < 7; i++) v.ajoute(conso.secondesJour(i));
+  v.ajoute(conso.watts);
+  for (int i = 0; i < CONSO_HEURES; i++) {
+    v.ajoute(pourmilleCharge(conso.secondesHeure(i), 3600) * 30 / 1000);
+  }
+}
+
+void vueTendance(Vue &v) {
+  const StatsTendance fenetres[] = { tendance.heure.stats(), tendance.jour.stats() };
+  for (const StatsTendance &s : fenetres) {
+    v.ajoute(s.mesures != 0);
+    v.ajoute(dixiemesTemp(s.min));
+    v.ajoute(dixiemesTemp(s.moy));
+    v.ajoute(dixiemesTemp(s.max));
+    v.ajoute(s.pourmilleRelais / 10);
+  }
+  // Courbe : compteur de ses changements, sans la reparcourir
+  v.ajoute(tendance.courbe.modifications);
+}
+
+// Table des écrans, dans l'ordre de ScreenState
+struct ScreenDesc {
+  void (*input)();
+  void (*draw)();
+  void (*vue)(Vue &v);
+};
+const ScreenDesc screens[] = {
+  {inputAccueil, drawAccueil, vueAccueil},  // Accueil
+  {inputMenu,    drawMenu,    vueMenu},     // Menu
+  {inputDate,    drawDate,    vueDate},     // Date
+  {inputTemp,    drawTemp,    vueTemp},     // Temp
+  {inputWifi,    drawWifi,    vueWifi},     // Wifi
+  {inputVersion, drawVersion, vueVersion},  // Version
+  {inputStats,   drawStats,   vueStats},    // Stats
+  {inputTendance, drawTendance, vueTendance} // TendanceEcran
+};
+
+// Vue de l'écran courant
+Vue vueEcran() {
+  Vue v;
+  v.ajoute(menuState);
+  screens[menuState].vue(v);
+  return v;
+}
+
+// Mise à jour du modèle d'énergie pour l'itération qui se termine
+// Mesure non bloquante : lancement de la conversion, puis lecture une fois
+// la conversion terminée ; la résolution suivante est choisie à la lecture.
+// Retourne true quand une nouvelle mesure valide est disponible
+bool updateCapteur() {
+  unsigned long maintenant = millis();
+  if (conversionEnCours) {
+    if (maintenant - lastTempRequest < conversionMs(resolution.bits)) return false;
+    conversionEnCours = false;
+    int32_t raw = ds.getTemp(sondeAdresse);   // en 1/128 °C
+    tempRaw = (int16_t)raw;
+    if (raw == DEVICE_DISCONNECTED_RAW) {
+      tempAct=TEMP_CAPTEUR_ABSENT;
+      return false;
     }
-    if (btnDroite.fell() && versionState == VersionUpdate){
-      versionState = VersionUpgrade;
+    tempAct=rawToCenti(masqueRaw(raw, resolution.bits));
+    superviseurMesure(tempAct);
+    uint8_t bits = resolution.bits;
+    if (resolution.echantillon(tempAct, tempCible) != bits) {
+      ds.setResolution(sondeAdresse, resolution.bits);
     }
-    if ((btnHaut.fell() || btnBas.fell()) && versionState == VersionMain){
-      stableVersion = !stableVersion;
-      String messageSw = stableVersion ? "switch to stable" : "switch to latest";
-      u8g2.drawStr(0, 64, messageSw.c_str());
-      u8g2.sendBuffer();
-      sleep(1);
+    return true;
+  } else if (maintenant - lastTempRequest >= periodeMs(resolution.bits)) {
+    ds.requestTemperatures();
+    lastTempRequest = maintenant;
+    conversionEnCours = true;
+  }
+  return false;
+}
+
+// Délai avant la prochaine lecture ou le prochain lancement de conversion
+unsigned long prochaineEcheanceCapteur() {
+  unsigned long depuis = millis() - lastTempRequest;
+  unsigned long echeance = conversionEnCours ? conversionMs(resolution.bits)
+                                             : periodeMs(resolution.bits);
+  return depuis < echeance ? echeance - depuis : 0;
+}
+
+void compteEnergie(unsigned long attenteMs) {
+  static unsigned long debutIteration = 0;
+  static unsigned long dernierRapport = 0;
+  unsigned long now = millis();
+  unsigned long duree = now - debutIteration;
+  debutIteration = now;
+
+  energie.avance(duree);
+  energie.compte(SsCpu, duree > attenteMs ? duree - attenteMs : 0);
+  if (ecranAllume) energie.compte(SsEcran, duree);
+  if (WiFi.status() == WL_CONNECTED) energie.compte(SsWifi, duree);
+  // Conversion DS18B20 : recouvrement entre l'itération et la conversion en cours
+  // (instants relatifs à now)
+  long convDebut = -(long)(now - lastTempRequest);
+  long convFin = convDebut + (long)conversionMs(resolution.bits);
+  long recouvrement = min(0L, convFin) - max(-(long)duree, convDebut);
+  if (recouvrement > 0) energie.compte(SsCapteur, recouvrement);
+
+  if (now - dernierRapport >= energieRapportDelay) {
+    dernierRapport = now;
+    Serial.print("Energie (% eveille):");
+    const char *noms[NbSousSystemes] = {"CPU", "Ecran", "WiFi", "Capteur"};
+    for (int i = 0; i < NbSousSystemes; i++) {
+      uint16_t p = energie.pourmilleActif((SousSysteme)i);
+      Serial.printf(" %s %u.%u", noms[i], p / 10, p % 10);
     }
+    Serial.printf(" -> %u uA moyen\n", (unsigned)energie.courantMoyenUA());
+    Serial.printf("Rendu: %lu images, %lu sautees, %lu us/image, ~%lu ms CPU evites\n",
+                  (unsigned long)rendu.images, (unsigned long)rendu.sautees,
+                  (unsigned long)rendu.moyenneUs(), (unsigned long)rendu.economiseMs());
+    energie.reset();
+    rendu.remetCompteurs();
   }
+}
 
-  u8g2.clearBuffer(); // efface le buffer
-  if (menuState == Accueil) {
-    // Affichage de l'écran d'accueil
+void loop() {
+  //Serial.print("Loop.");
+  traceIteration();
+  unsigned long debutBoucleUs = micros();
 
-    // Affichage de l'heure
-    u8g2.setFont(u8g2_font_ncenB08_tr); // Choix de la police
-    u8g2.drawStr(0, 8, date);
+  // Activation de l'OTA
+  {
+    TRACE(TraceOta);
+    ArduinoOTA.handle();
+    updatePartage();
+  }
 
-    // Affichage de la température actuelle
-    // Conversion de float en chaîne de caractères
-    char tempStrAct[16];
-    sprintf(tempStrAct, "%.1f", tempAct); // Convertit tempAct en chaîne de caractères avec 1 décimale
-    u8g2.setFont(u8g2_font_fub25_tr);
-    u8g2.drawStr(25, 45, tempStrAct); // Affiche la température
-    u8g2.setFont(u8g2_font_fub11_tr);
-    u8g2.drawStr(93, 27, "o");
-
-    // Affichage de la température cible
-    char tempStrCible[16];
-    sprintf(tempStrCible, "%.1f", tempCible); // Convertit tempCible en chaîne de caractères avec 1 décimale
-    u8g2.setFont(u8g2_font_t0_12_tf);
-    u8g2.drawStr(95, 64, tempStrCible);
-    u8g2.setFont(u8g2_font_tiny5_tf);
-    u8g2.drawStr(120, 59, "o");
-    // Affichage d'une icone cadenat si forcage manuel de la température
-    if (manualTemp) {
-      u8g2.setFont(u8g2_font_open_iconic_thing_1x_t);
-      u8g2.drawGlyph(86, 65, 0x004f);
+  // Vérifier/reconnecter le WiFi si besoin
+  {
+    TRACE(TraceWifi);
+    updateImprov();
+    if (!improvConnexion) handleWiFiReconnect(wifiSSID, wifiPass);
+  }
+
+  // Récupération de la date et de l'heure (horloge logicielle, sans I2C)
+  DateTime now;
+  {
+    TRACE(TraceHorloge);
+    updateHorloge();
+    now = horlogeNow();
+  }
+  if (menuState != Date) {
+    //sprintf(date, "%02d/%02d/%04d %02d:%02d:%02d",
+    //  now.day(), now.month(), now.year(),
+    //  now.hour(), now.minute(), now.second());
+    day=now.day();
+    month=now.month();
+    year=now.year();
+    hour=now.hour();
+    minute=now.minute();
+  }
+  sprintf(dateStr, "%02d/%02d %02d:%02d:%02d",
+    day, month, hour, minute, now.second());
+
+  // Récupération de la température cible
+  if (!manualTemp) tempCible = getTempCible(now);
+
+  // Mise à jour de la tempéraure
+  bool nouvelleMesure;
+  {
+    TRACE(TraceCapteur);
+    nouvelleMesure = updateCapteur();
+  }
+
+  // Activation du chauffage : demande transmise au superviseur, qui
+  // retourne l'état réel du relais après les règles de sécurité
+  bool relais;
+  {
+    TRACE(TraceRelais);
+    superviseurDemande(thermostat.decide(tempAct, tempCible, millis()));
+    relais = superviseurRelais();
+  }
+  if (nouvelleMesure) {
+    updatePrechauffe(now, relais);
+    sauveReprise(now, relais);
+    tendance.ajoute(now.unixtime(), tempAct, tempCible, relais);
+  }
+  updateConso(now.unixtime(), relais);
+
+  // Commandes série (export de la comptabilité)
+  lireSerie();
+
+  // Tableau de bord web : requêtes et événements des flux ouverts
+  {
+    TRACE(TraceTableau);
+    updateTableau(etatTableau());
+  }
+
+  // Récupération de la puissance du signal WiFi
+  // Timer pour le RSSI
+  static unsigned long lastRSSIRequest = 0;
+  if (millis() - lastRSSIRequest > 1000) {  // toutes les 1s
+    rssi = WiFi.RSSI();
+    lastRSSIRequest = millis();
+  }
+
+  // Événements boutons reçus depuis la dernière itération
+  // (Profil::BOUTONS et Profil::ECRAN sont des constantes : sans boutons ni
+  // écran, ces branches et les écrans qu'elles appellent disparaissent de l'image)
+  if (Profil::BOUTONS) {
+    TRACE(TraceBoutons);
+    updateBoutons();
+  }
+
+  // Veille de l'écran : le premier appui ne fait que le rallumer
+  bool reveilEcran = false;
+  if (Profil::BOUTONS && activiteBoutons()) {
+    derniereActivite = millis();
+    if (!ecranAllume) {
+      u8g2.setPowerSave(0);
+      ecranAllume = true;
+      reveilEcran = true;
     }
+  } else if (ecranAllume && millis() - derniereActivite > ecranTimeout) {
+    u8g2.setPowerSave(1);
+    ecranAllume = false;
+  }
 
-    // Affichage de l'icône de chauffage
-    if (tempAct<tempCible)
+  // Vue de l'écran après navigation, calculée une fois par itération pour
+  // le rendu et pour l'échéance de l'image retenue
+  Vue vue;
+  if (Profil::ECRAN && ecranAllume) {
+    // Navigation menu
     {
-      u8g2.setFont(u8g2_font_open_iconic_embedded_2x_t);
-      u8g2.drawGlyph(0, 64, 0x0043);
+      TRACE(TraceMenu);
+      if (!reveilEcran) screens[menuState].input();
     }
 
-    // Affichage du signal wifi
-    int x=120;
-    int y=10;
-    drawWiFiIcon(u8g2, x, y, rssi);
-    //u8g2.setFont(u8g2_font_t0_12_tf);
-    //u8g2.drawStr(11, 16, (String(rssi)).c_str());
-    if (saveMsgUntil && ((long)saveMsgUntil - (long)millis()) > 0) {
-      u8g2.setFont(u8g2_font_fub11_tr);
-      u8g2.drawStr(25, 64, "Saved !");
-    } else if (saveMsgUntil) {
-      saveMsgUntil = 0;
+    // Image refaite seulement si ce qui est affiché a changé
+    vue = vueEcran();
+    if (reveilEcran) rendu.invalideTout();
+    if (rendu.aRendre(vue, millis())) {
+      unsigned long debutRenduUs = micros();
+      {
+        TRACE(TraceRendu);
+        u8g2.clearBuffer(); // efface le buffer
+        screens[menuState].draw();
+      }
+      {
+        TRACE(TraceEnvoi);
+        busEnvoieEcran(u8g2); // envoie à l'écran, page par page
+      }
+      rendu.rendue(micros() - debutRenduUs);
     }
-  } else if (menuState == Menu) {
-      drawMenu();
-  } else if (menuState == Date) {
-      drawDate();
-  } else if (menuState == Temp) {
-      drawTemp();
-  } else if (menuState == Wifi) {
-      drawWifi();
-  } else if (menuState == Version) {
-      drawVersion();
-  }
-  u8g2.sendBuffer(); // envoie à l'écran
-  //delay(2000);
-}
+  }
+  traceFinTravail();
+  boucleUs = micros() - debutBoucleUs;
+  envoieTelemetrie();
+  envoieBalise();
+  updateRapportDeploiement();
+
+  // Rien à faire avant le prochain bouton ou la prochaine échéance :
+  // écran allumé, on rafraîchit au plus tous les loopIdleMax ;
+  // écran éteint, on attend la prochaine étape de la mesure de température
+  unsigned long attente = loopIdleMax;
+  if (!ecranAllume) attente = prochaineEcheanceCapteur();
+  // Image retenue par la limite de cadence
+  if (Profil::ECRAN && ecranAllume) {
+    uint32_t image = rendu.echeance(vue, millis());
+    if (image && image < attente) attente = image;
+  }
+  attente = prochaineEcheanceBoutons(attente);
+  if (partageActif()) attente = 0;   // un pair télécharge notre image
+  if (tableauActif()) attente = 0;   // requête du tableau de bord en cours
+  if (improvConnexion || improvScan) attente = 0;   // provisionnement en cours
+
+  unsigned long debutAttente = millis();
+  if (!ecranAllume && WiFi.status() != WL_CONNECTED && attente >= minLightSleep) {
+    // Pas de liaison WiFi à maintenir : light sleep explicite
+    const int pinsBoutons[] = { PIN_BTN_HAUT, PIN_BTN_BAS, PIN_BTN_GAUCHE, PIN_BTN_DROITE };
+    dormirLeger(attente, pinsBoutons, Profil::BOUTONS);
+  } else {
+    // La boucle bloque sur la file au lieu de tourner à vide
+    attenteBoutons(attente);
+  }
+  compteEnergie(millis() - debutAttente);
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "pairs.h"
+
+#include <string.h>
+
+static bool concerne(const Pair &p, EtatPair etat, const char *version) {
+  return p.etat == etat && strcmp(p.versionEtat, version) == 0;
+}
+
+static bool exclu(const Election &e, uint32_t id) {
+  for (int i = 0; i < e.nbExclus; i++) {
+    if (e.exclus[i] == id) return true;
+  }
+  return false;
+}
+
+void commenceElection(Election &e, uint32_t maintenant) {
+  memset(&e, 0, sizeof(e));
+  e.debutMs = maintenant;
+}
+
+void exclutPair(Election &e, uint32_t id) {
+  if (!exclu(e, id) && e.nbExclus < PAIRS_MAX) e.exclus[e.nbExclus++] = id;
+}
+
+void recense(Pair *pairs, int &n, const Pair &p, const char *version) {
+  if (strcmp(p.version, version) == 0) {
+    int candidats = 0;
+    for (int i = 0; i < n; i++) candidats += strcmp(pairs[i].version, version) == 0;
+    if (candidats < PAIRS_MAX - 2) pairs[n++] = p;
+    return;
+  }
+  if (p.etat == PairInactif || strcmp(p.versionEtat, version) != 0) return;
+  for (int i = 0; i < n; i++) {
+    if (concerne(pairs[i], p.etat, version) && strcmp(pairs[i].version, version) != 0) {
+      if (p.etat == PairAttente && p.id < pairs[i].id) pairs[i] = p;
+      return;
+    }
+  }
+  pairs[n++] = p;
+}
+
+Plan planifie(Election &e, const Pair *pairs, int n, const char *version, const char *md5,
+              uint32_t id, uint32_t maintenant) {
+  Plan plan = {SourceAttente, 0, {}, 0};
+  if (n > PAIRS_MAX) n = PAIRS_MAX;
+  uint32_t depuisMs = maintenant - e.debutMs;
+
+  // Pairs servant l'image attendue : caches d'abord, puis appareils en
+  // commençant à un rang propre à chacun pour répartir la charge
+  uint8_t appareils[PAIRS_MAX];
+  int nbAppareils = 0;
+  for (int i = 0; i < n; i++) {
+    const Pair &p = pairs[i];
+    if (p.id == id || md5[0] == '\0' || exclu(e, p.id)) continue;
+    if (strcmp(p.version, version) != 0 || strcmp(p.md5, md5) != 0) continue;
+    if (p.cache) plan.ordre[plan.nb++] = (uint8_t)i;
+    else appareils[nbAppareils++] = (uint8_t)i;
+  }
+  for (int k = 0; k < nbAppareils; k++) {
+    plan.ordre[plan.nb++] = appareils[(id + k) % nbAppareils];
+  }
+  if (plan.nb) {
+    plan.decision = SourcePairs;
+    return plan;
+  }
+
+  if (depuisMs >= PARTAGE_ATTENTE_MAX_MS) {
+    plan.decision = SourceOrigine;
+    return plan;
+  }
+
+  // Quelqu'un la télécharge (ou vient de la télécharger et redémarre) :
+  // il la servira ensuite
+  for (int i = 0; i < n; i++) {
+    if (pairs[i].id != id && concerne(pairs[i], PairTelechargement, version)) {
+      e.dlVu = true;
+      e.dlVuMs = maintenant;
+    }
+  }
+  if (e.dlVu && maintenant - e.dlVuMs < PARTAGE_RELAIS_MS) {
+    plan.attenteMs = PARTAGE_REESSAI_MS;
+    return plan;
+  }
+
+  // Laisse à tous les appareils qui démarrent en même temps le temps de
+  // s'annoncer avant l'élection
+  if (depuisMs < PARTAGE_ELECTION_MS) {
+    plan.attenteMs = PARTAGE_ELECTION_MS - depuisMs;
+    return plan;
+  }
+
+  // Élection : le plus petit identifiant en attente télécharge
+  for (int i = 0; i < n; i++) {
+    if (pairs[i].id < id && concerne(pairs[i], PairAttente, version)) {
+      plan.attenteMs = PARTAGE_REESSAI_MS;
+      return plan;
+    }
+  }
+  plan.decision = SourceOrigine;
+  return plan;
+}
@@ -0,0 +1,197 @@
+#include "partage.h"
+
+#include <WiFi.h>
+#include <mdns.h>
+#include <esp_ota_ops.h>
+
+#define PARTAGE_SERVICE "_tapisfw"
+#define PARTAGE_PROTO "_tcp"
+
+static char versionServie[16];
+static char md5Servi[33];
+static uint32_t tailleImage = 0;
+static const esp_partition_t *partitionImage = nullptr;
+static bool annonceFaite = false;
+static uint32_t idLocal = 0;
+static unsigned long delaiAnnonce = PARTAGE_DELAI_MS;
+
+// Un seul client à la fois
+static WiFiServer serveur(PARTAGE_PORT);
+static WiFiClient client;
+static char requete[96];
+static size_t requeteLongueur = 0;
+static unsigned long clientDepuis = 0;
+static bool envoi = false;
+static uint32_t envoye = 0;
+static unsigned long dernierEnvoi = 0;
+static uint8_t morceau[1460];
+
+static mdns_search_once_t *recherche = nullptr;
+
+void beginPartage(const char *version, bool immediat) {
+  strncpy(versionServie, version, sizeof(versionServie) - 1);
+  if (immediat) delaiAnnonce = 0;
+  // Octets propres à l'appareil de l'adresse MAC
+  idLocal = (uint32_t)(ESP.getEfuseMac() >> 16);
+}
+
+uint32_t partageId() {
+  return idLocal;
+}
+
+// MD5 de l'image en cours (relecture complète de la partition, ~1 s, une
+// seule fois) puis annonce et ouverture du serveur
+static void annonce() {
+  if (annonceFaite) return;
+  annonceFaite = true;
+  strncpy(md5Servi, ESP.getSketchMD5().c_str(), sizeof(md5Servi) - 1);
+  tailleImage = ESP.getSketchSize();
+  partitionImage = esp_ota_get_running_partition();
+
+  char id[9];
+  snprintf(id, sizeof(id), "%08lx", (unsigned long)idLocal);
+  mdns_txt_item_t txt[] = {
+    {"v", versionServie}, {"md5", md5Servi}, {"id", id}, {"role", "pair"}, {"etat", ""}
+  };
+  mdns_service_add(nullptr, PARTAGE_SERVICE, PARTAGE_PROTO, PARTAGE_PORT, txt, 5);
+  serveur.begin();
+  Serial.printf("Partage: image %s (%lu octets, md5 %s) sur le port %u\n", versionServie,
+                (unsigned long)tailleImage, md5Servi, PARTAGE_PORT);
+}
+
+void partageEtat(EtatPair etat, const char *version) {
+  annonce();
+  char valeur[24] = "";
+  if (etat != PairInactif) {
+    snprintf(valeur, sizeof(valeur), "%s:%s", etat == PairAttente ? "att" : "dl", version);
+  }
+  mdns_service_txt_item_set(PARTAGE_SERVICE, PARTAGE_PROTO, "etat", valeur);
+}
+
+bool partageActif() {
+  return client.connected();
+}
+
+// Lecture de la ligne de requête ; true quand elle est complète
+static bool litRequete() {
+  while (client.available() && requeteLongueur < sizeof(requete) - 1) {
+    requete[requeteLongueur++] = (char)client.read();
+    requete[requeteLongueur] = '\0';
+    if (strstr(requete, "\r\n")) return true;
+  }
+  return false;
+}
+
+static void fermeClient() {
+  client.stop();
+  envoi = false;
+  requeteLongueur = 0;
+}
+
+void updatePartage() {
+  if (!annonceFaite) {
+    if (WiFi.status() == WL_CONNECTED && millis() >= delaiAnnonce) annonce();
+    return;
+  }
+
+  if (!client) {
+    client = serveur.available();
+    if (!client) return;
+    requeteLongueur = 0;
+    requete[0] = '\0';
+    envoi = false;
+    clientDepuis = millis();
+  }
+  if (!client.connected()) {
+    fermeClient();
+    return;
+  }
+
+  if (!envoi) {
+    if (!litRequete()) {
+      if (millis() - clientDepuis > PARTAGE_REQUETE_MS) fermeClient();
+      return;
+    }
+    char attendu[48];
+    snprintf(attendu, sizeof(attendu), "GET /firmware-%s.bin ", versionServie);
+    if (partitionImage == nullptr || strncmp(requete, attendu, strlen(attendu)) != 0) {
+      client.print("HTTP/1.0 404 Not Found\r\nConnection: close\r\n\r\n");
+      fermeClient();
+      return;
+    }
+    client.printf("HTTP/1.0 200 OK\r\nContent-Type: application/octet-stream\r\n"
+                  "Content-Length: %lu\r\nConnection: close\r\n\r\n", (unsigned long)tailleImage);
+    envoi = true;
+    envoye = 0;
+    dernierEnvoi = millis();
+    return;
+  }
+
+  // Envoi par segments TCP tant que le budget de l'itération le permet
+  unsigned long debut = millis();
+  while (envoye < tailleImage && millis() - debut < PARTAGE_BUDGET_MS) {
+    size_t n = tailleImage - envoye;
+    if (n > sizeof(morceau)) n = sizeof(morceau);
+    if (esp_partition_read(partitionImage, envoye, morceau, n) != ESP_OK) break;
+    size_t ecrit = client.write(morceau, n);
+    if (ecrit == 0) break;
+    envoye += ecrit;
+    dernierEnvoi = millis();
+  }
+  if (envoye >= tailleImage) {
+    Serial.printf("Partage: image servie a %s\n", client.remoteIP().toString().c_str());
+    fermeClient();
+  } else if (millis() - dernierEnvoi > PARTAGE_REQUETE_MS) {
+    fermeClient();   // pair qui ne lit plus
+  }
+}
+
+void partageRecherche() {
+  if (recherche) mdns_query_async_delete(recherche);
+  recherche = mdns_query_async_new(nullptr, PARTAGE_SERVICE, PARTAGE_PROTO, MDNS_TYPE_PTR,
+                                   PARTAGE_RECHERCHE_MS, PARTAGE_REPONSES_MAX);
+}
+
+static void copie(char *dst, size_t taille, const char *src) {
+  strncpy(dst, src ? src : "", taille - 1);
+  dst[taille - 1] = '\0';
+}
+
+bool partageResultats(const char *version, Pair *pairs, int &n) {
+  n = 0;
+  if (recherche == nullptr) return true;
+  mdns_result_t *resultats = nullptr;
+#if ESP_IDF_VERSION_MAJOR >= 5
+  uint8_t nb;
+  if (!mdns_query_async_get_results(recherche, 0, &resultats, &nb)) return false;
+#else
+  if (!mdns_query_async_get_results(recherche, 0, &resultats)) return false;
+#endif
+  mdns_query_async_delete(recherche);
+  recherche = nullptr;
+
+  for (mdns_result_t *r = resultats; r; r = r->next) {
+    if (r->addr == nullptr) continue;
+    Pair p;
+    memset(&p, 0, sizeof(p));
+    p.ip = r->addr->addr.u_addr.ip4.addr;
+    p.port = r->port;
+    for (size_t i = 0; i < r->txt_count; i++) {
+      const char *cle = r->txt[i].key, *val = r->txt[i].value ? r->txt[i].value : "";
+      if (strcmp(cle, "v") == 0) copie(p.version, sizeof(p.version), val);
+      else if (strcmp(cle, "md5") == 0) copie(p.md5, sizeof(p.md5), val);
+      else if (strcmp(cle, "id") == 0) p.id = strtoul(val, nullptr, 16);
+      else if (strcmp(cle, "role") == 0) p.cache = strcmp(val, "cache") == 0;
+      else if (strcmp(cle, "etat") == 0) {
+        const char *dp = strchr(val, ':');
+        if (dp) {
+          p.etat = strncmp(val, "att", 3) == 0 ? PairAttente : PairTelechargement;
+          copie(p.versionEtat, sizeof(p.versionEtat), dp + 1);
+        }
+      }
+    }
+    recense(pairs, n, p, version);
+  }
+  mdns_query_results_free(resultats);
+  return true;
+}
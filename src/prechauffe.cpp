@@ -0,0 +1,148 @@
+#include "prechauffe.h"
+
+static const int MINUTES_JOUR = 24 * 60;
+
+// Minutes écoulées depuis origine, sur le cadran de 24 h
+static int depuis(int minute, int origine) {
+  return ((minute - origine) % MINUTES_JOUR + MINUTES_JOUR) % MINUTES_JOUR;
+}
+
+static int borne(int v, int mini, int maxi) {
+  return v < mini ? mini : (v > maxi ? maxi : v);
+}
+
+// Moyenne exponentielle 1/4, la première mesure est prise telle quelle
+static void moyenne(int16_t &v, int32_t mesure) {
+  mesure = borne(mesure, 1, 0x7FFF);
+  v = v == 0 ? (int16_t)mesure : (int16_t)((3 * (int32_t)v + mesure) / 4);
+}
+
+void Prechauffe::reset() {
+  vitesseChauffe = vitesseRefroid = 0;
+  retard[TransitionJour] = retard[TransitionNuit] = 0;
+  dernierEcart[TransitionJour] = dernierEcart[TransitionNuit] = ECART_INCONNU;
+  relaisPrec = refValide = false;
+  segmentMs = refMs = 0;
+  refTemp = 0;
+  enCours = derniereSuivie = TransitionAucune;
+}
+
+void Prechauffe::echantillon(centi_t temp, bool relais, uint32_t ms) {
+  // Nouvelle période : le relais vient de basculer
+  if (relais != relaisPrec) {
+    relaisPrec = relais;
+    segmentMs = ms;
+    refValide = false;
+    return;
+  }
+  // Référence prise une fois le temps mort passé
+  if (!refValide) {
+    if (ms - segmentMs >= PRECHAUFFE_MORT_MS) {
+      refTemp = temp;
+      refMs = ms;
+      refValide = true;
+    }
+    return;
+  }
+  if (ms - refMs < PRECHAUFFE_FENETRE_MS) return;
+
+  int32_t vitesse = (int32_t)((int64_t)(temp - refTemp) * 3600000 / (int32_t)(ms - refMs));
+  if (relais && vitesse > 0) moyenne(vitesseChauffe, vitesse);
+  if (!relais && vitesse < 0) moyenne(vitesseRefroid, -vitesse);
+  refTemp = temp;
+  refMs = ms;
+}
+
+void Prechauffe::rampe(Transition t, const Programme &p, int &debut, int &duree) const {
+  bool jour = t == TransitionJour;
+  int minute = jour ? p.minuteDay : p.minuteNight;
+  int autre = jour ? p.minuteNight : p.minuteDay;
+  int32_t delta = p.tempDay - p.tempNight;
+  bool chauffe = jour ? delta > 0 : delta < 0;
+  if (delta < 0) delta = -delta;
+  int16_t vitesse = chauffe ? vitesseChauffe : vitesseRefroid;
+
+  // Pente max de la courbe en S : pi/2 * delta / duree ; le facteur 2
+  // laisse 25 % de marge sur la vitesse apprise
+  duree = p.fadeDuration;
+  if (vitesse > 0) {
+    int d = (int)((delta * 2 * 60 + vitesse - 1) / vitesse);
+    if (d > duree) duree = d < PRECHAUFFE_DUREE_MAX ? d : PRECHAUFFE_DUREE_MAX;
+  }
+
+  // Pas d'empiètement sur la transition précédente : avance totale
+  // limitée à la moitié de l'intervalle entre les deux horaires
+  int limite = depuis(minute, autre) / 2;
+  if (limite < p.fadeDuration) limite = p.fadeDuration;
+  if (duree > limite) duree = limite;
+  int r = retard[t];
+  if (duree + r > limite) r = limite - duree;
+
+  // Plateau programmé à minute + fadeDuration, avancé du retard appris
+  debut = depuis(minute + p.fadeDuration - r - duree, 0);
+}
+
+centi_t Prechauffe::consigne(int minuteNow, const Programme &p) const {
+  int debutJ, dureeJ, debutN, dureeN;
+  rampe(TransitionJour, p, debutJ, dureeJ);
+  rampe(TransitionNuit, p, debutN, dureeN);
+
+  int dj = depuis(minuteNow, debutJ);
+  int dn = depuis(minuteNow, debutN);
+  if (dj < dureeJ) return smoothStep(p.tempNight, p.tempDay, 0, dureeJ, dj);
+  if (dn < dureeN) return smoothStep(p.tempDay, p.tempNight, 0, dureeN, dn);
+  // Plateau de la dernière rampe terminée
+  return dj - dureeJ < dn - dureeN ? p.tempDay : p.tempNight;
+}
+
+Transition Prechauffe::suivi(int minuteNow, centi_t temp, const Programme &p) {
+  int32_t delta = p.tempDay - p.tempNight;
+  if (delta < PRECHAUFFE_ECART_MIN && delta > -PRECHAUFFE_ECART_MIN) {
+    enCours = TransitionAucune;
+    return TransitionAucune;
+  }
+
+  if (enCours == TransitionAucune) {
+    // Début de suivi au départ d'une rampe (une fois par rampe, les
+    // transitions alternent), si le plateau n'est pas déjà là
+    for (int i = TransitionJour; i <= TransitionNuit; i++) {
+      Transition t = (Transition)i;
+      int debut, duree;
+      rampe(t, p, debut, duree);
+      if (t == derniereSuivie || depuis(minuteNow, debut) >= duree) continue;
+      derniereSuivie = t;
+      centi_t plateau = t == TransitionJour ? p.tempDay : p.tempNight;
+      int32_t reste = plateau - temp;
+      if (reste > PRECHAUFFE_TOLERANCE || reste < -PRECHAUFFE_TOLERANCE) enCours = t;
+    }
+    return TransitionAucune;
+  }
+
+  Transition t = enCours;
+  bool jour = t == TransitionJour;
+  centi_t plateau = jour ? p.tempDay : p.tempNight;
+  bool monte = jour ? delta > 0 : delta < 0;
+  bool atteint = monte ? temp >= plateau - PRECHAUFFE_TOLERANCE
+                       : temp <= plateau + PRECHAUFFE_TOLERANCE;
+
+  // Écart signé à l'arrivée programmée (négatif = en avance) : minute où
+  // la courbe en S d'origine entre elle-même dans la tolérance du plateau
+  centi_t depart = jour ? p.tempNight : p.tempDay;
+  int arrivee = 0;
+  while (arrivee < p.fadeDuration) {
+    int32_t reste = plateau - smoothStep(depart, plateau, 0, p.fadeDuration, arrivee);
+    if (reste <= PRECHAUFFE_TOLERANCE && reste >= -PRECHAUFFE_TOLERANCE) break;
+    arrivee++;
+  }
+  int ecart = depuis(minuteNow, (jour ? p.minuteDay : p.minuteNight) + arrivee);
+  if (ecart > MINUTES_JOUR / 2) ecart -= MINUTES_JOUR;
+  if (!atteint && ecart < PRECHAUFFE_ABANDON) return TransitionAucune;
+  if (!atteint) ecart = PRECHAUFFE_ABANDON;
+
+  // Correction de moitié de l'écart, bornée par transition
+  enCours = TransitionAucune;
+  dernierEcart[t] = (int16_t)ecart;
+  int correction = borne(ecart, -PRECHAUFFE_CORRECTION_MAX, PRECHAUFFE_CORRECTION_MAX) / 2;
+  retard[t] = (int16_t)borne(retard[t] + correction, -PRECHAUFFE_RETARD_MAX, PRECHAUFFE_RETARD_MAX);
+  return t;
+}
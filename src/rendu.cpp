@@ -0,0 +1,41 @@
+#include "rendu.h"
+
+#include <string.h>
+
+void Vue::ajoute(const void *donnees, size_t n) {
+  const uint8_t *p = (const uint8_t *)donnees;
+  for (size_t i = 0; i < n; i++) {
+    empreinte ^= p[i];
+    empreinte *= 16777619u;
+  }
+}
+
+void Vue::ajouteTexte(const char *texte) {
+  ajoute(texte, strlen(texte) + 1);
+}
+
+void Rendu::reset() {
+  memset(this, 0, sizeof(*this));
+  invalide = true;
+}
+
+bool Rendu::aRendre(const Vue &v, uint32_t maintenant) {
+  uint32_t depuis = maintenant - dernierMs;
+  bool change = invalide || v.empreinte != empreinte;
+  bool rafraichit = RENDU_RAFRAICHISSEMENT_MS != 0 && depuis >= RENDU_RAFRAICHISSEMENT_MS;
+  if ((!change || depuis < RENDU_INTERVALLE_MIN_MS) && !invalide && !rafraichit) {
+    sautees++;
+    return false;
+  }
+  if (v.empreinte != empreinte) versions++;
+  empreinte = v.empreinte;
+  dernierMs = maintenant;
+  invalide = false;
+  return true;
+}
+
+uint32_t Rendu::echeance(const Vue &v, uint32_t maintenant) const {
+  if (v.empreinte == empreinte && !invalide) return 0;
+  uint32_t depuis = maintenant - dernierMs;
+  return depuis < RENDU_INTERVALLE_MIN_MS ? RENDU_INTERVALLE_MIN_MS - depuis : 1;
+}
@@ -0,0 +1,79 @@
+#include "reprise.h"
+
+#include <string.h>
+#include "telemetrie.h"
+
+// Empreinte FNV-1a des tailles et positions des champs du bloc et des
+// structures qu'il contient, calculée à la compilation
+static constexpr uint32_t empreinte(uint32_t h) {
+  return h;
+}
+
+template <typename... Reste>
+static constexpr uint32_t empreinte(uint32_t h, size_t v, Reste... reste) {
+  return empreinte((h ^ (uint32_t)v) * 16777619u, reste...);
+}
+
+#define CHAMP(S, m) offsetof(S, m), sizeof(S::m)
+
+static constexpr uint32_t REPRISE_DISPOSITION = empreinte(2166136261u,
+  sizeof(EtatReprise), CHAMP(EtatReprise, magic), CHAMP(EtatReprise, version),
+  CHAMP(EtatReprise, taille), CHAMP(EtatReprise, disposition), CHAMP(EtatReprise, resets),
+  CHAMP(EtatReprise, crashsConsecutifs), CHAMP(EtatReprise, derniereCause),
+  CHAMP(EtatReprise, dureeChaudMs), CHAMP(EtatReprise, dureeFroidMs),
+  CHAMP(EtatReprise, controle), CHAMP(EtatReprise, manuel), CHAMP(EtatReprise, relais),
+  CHAMP(EtatReprise, tempAct), CHAMP(EtatReprise, tempCible), CHAMP(EtatReprise, tempRaw),
+  CHAMP(EtatReprise, msSauve), CHAMP(EtatReprise, unixSauve), CHAMP(EtatReprise, derivePpm),
+  CHAMP(EtatReprise, resolution), CHAMP(EtatReprise, prechauffe), CHAMP(EtatReprise, conso),
+  CHAMP(EtatReprise, crc),
+  sizeof(PolitiqueResolution), CHAMP(PolitiqueResolution, bits),
+  CHAMP(PolitiqueResolution, nbEchantillons), CHAMP(PolitiqueResolution, nbChangements),
+  sizeof(Prechauffe), CHAMP(Prechauffe, vitesseChauffe), CHAMP(Prechauffe, vitesseRefroid),
+  CHAMP(Prechauffe, retard), CHAMP(Prechauffe, dernierEcart), CHAMP(Prechauffe, relaisPrec),
+  CHAMP(Prechauffe, refValide), CHAMP(Prechauffe, segmentMs), CHAMP(Prechauffe, refMs),
+  CHAMP(Prechauffe, refTemp), CHAMP(Prechauffe, enCours), CHAMP(Prechauffe, derniereSuivie),
+  sizeof(Consommation), CHAMP(Consommation, watts), CHAMP(Consommation, heure),
+  CHAMP(Consommation, resteMs), CHAMP(Consommation, heures), CHAMP(Consommation, jours),
+  CHAMP(Consommation, totalSecondes));
+
+#undef CHAMP
+
+static uint16_t crcBloc(const EtatReprise &e) {
+  return crc16Ccitt((const uint8_t *)&e, offsetof(EtatReprise, crc));
+}
+
+bool EtatReprise::valide() const {
+  return magic == REPRISE_MAGIC && version == REPRISE_VERSION &&
+         taille == sizeof(EtatReprise) && disposition == REPRISE_DISPOSITION &&
+         crc == crcBloc(*this);
+}
+
+void EtatReprise::scelle() {
+  crc = crcBloc(*this);
+}
+
+bool EtatReprise::demarrage(CauseReset cause) {
+  if (!valide()) {
+    memset(this, 0, sizeof(*this));
+    magic = REPRISE_MAGIC;
+    version = REPRISE_VERSION;
+    taille = sizeof(EtatReprise);
+    disposition = REPRISE_DISPOSITION;
+  }
+  if (resets[cause] < 0xFFFF) resets[cause]++;
+  derniereCause = cause;
+
+  bool crash = cause == CausePanique || cause == CauseWatchdog;
+  if (crash) {
+    if (crashsConsecutifs < 0xFF) crashsConsecutifs++;
+  } else {
+    crashsConsecutifs = 0;
+  }
+
+  bool chaud = controle && (cause == CauseLogiciel || crash) &&
+               crashsConsecutifs < REPRISE_CRASHS_MAX;
+  // L'état n'est repris qu'une fois : la prochaine sauvegarde le revalide
+  controle = false;
+  scelle();
+  return chaud;
+}
@@ -0,0 +1,31 @@
+#include "securite.h"
+
+bool Securite::decide(uint32_t ms) {
+  DefautSecurite d = DefautAucun;
+
+  if (!mesureRecue || ms - mesureMs > SECURITE_FRAICHEUR_MS) d = DefautMesurePerimee;
+
+  if (mesureRecue) {
+    if (temp >= SECURITE_TEMP_MAX) surchauffe = true;
+    else if (temp < SECURITE_TEMP_MAX - SECURITE_HYSTERESIS) surchauffe = false;
+  }
+  if (surchauffe) d = DefautSurchauffe;
+
+  if (repos && ms - reposDepuisMs >= SECURITE_REPOS_MS) repos = false;
+  if (repos && d == DefautAucun) d = DefautMarcheMax;
+
+  bool voulu = demande && d == DefautAucun;
+  if (voulu && relais && ms - relaisDepuisMs >= SECURITE_MARCHE_MAX_MS) {
+    repos = true;
+    reposDepuisMs = ms;
+    voulu = false;
+    d = DefautMarcheMax;
+  }
+
+  if (voulu != relais) {
+    relais = voulu;
+    relaisDepuisMs = ms;
+  }
+  defaut = d;
+  return relais;
+}
@@ -0,0 +1,88 @@
+#include "superviseur.h"
+
+#include <esp_task_wdt.h>
+#include "profil.h"
+
+static Securite securite;
+static int pinRelaisSuperviseur = -1;
+
+// Protège l'état partagé entre loop() et la tâche ; l'écriture du relais
+// se fait sous le verrou pour ne jamais appliquer une décision périmée
+static portMUX_TYPE muxSecurite = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *const nomsDefauts[NbDefauts] = {
+  "aucun", "mesure perimee", "surchauffe", "marche continue max"
+};
+
+static void applique() {
+  portENTER_CRITICAL(&muxSecurite);
+  bool relais = securite.decide(millis());
+  digitalWrite(pinRelaisSuperviseur, relais == Profil::RELAIS_ACTIF_HAUT ? HIGH : LOW);
+  portEXIT_CRITICAL(&muxSecurite);
+}
+
+static void tacheSuperviseur(void *) {
+  esp_task_wdt_add(NULL);
+  DefautSecurite dernierDefaut = DefautAucun;
+  TickType_t reveil = xTaskGetTickCount();
+  for (;;) {
+    applique();
+    DefautSecurite d = superviseurDefaut();
+    if (d != dernierDefaut) {
+      Serial.printf("Securite: %s\n", nomsDefauts[d]);
+      dernierDefaut = d;
+    }
+    esp_task_wdt_reset();
+    vTaskDelayUntil(&reveil, pdMS_TO_TICKS(SUPERVISEUR_PERIODE_MS));
+  }
+}
+
+void beginSuperviseur(int pinRelais) {
+  pinRelaisSuperviseur = pinRelais;
+  securite.reset();
+  // Niveau de repos écrit avant le passage en sortie : un relais actif à
+  // l'état bas ne colle pas au démarrage
+  digitalWrite(pinRelais, Profil::RELAIS_ACTIF_HAUT ? LOW : HIGH);
+  pinMode(pinRelais, OUTPUT);
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_task_wdt_config_t config = {};
+  config.timeout_ms = SUPERVISEUR_WDT_S * 1000;
+  config.trigger_panic = true;
+  esp_task_wdt_reconfigure(&config);
+#else
+  esp_task_wdt_init(SUPERVISEUR_WDT_S, true);
+#endif
+  // Priorité au-dessus de loop() (1) : la sécurité passe avant l'UI et le réseau
+  xTaskCreate(tacheSuperviseur, "superviseur", 3072, nullptr, 5, nullptr);
+}
+
+void superviseurDemande(bool chauffe) {
+  portENTER_CRITICAL(&muxSecurite);
+  bool change = securite.demande != chauffe;
+  securite.demande = chauffe;
+  portEXIT_CRITICAL(&muxSecurite);
+  if (change) applique();
+}
+
+void superviseurMesure(centi_t temp) {
+  portENTER_CRITICAL(&muxSecurite);
+  securite.mesure(temp, millis());
+  portEXIT_CRITICAL(&muxSecurite);
+  // Surchauffe coupée dès la mesure, sans attendre la période de la tâche
+  applique();
+}
+
+bool superviseurRelais() {
+  portENTER_CRITICAL(&muxSecurite);
+  bool relais = securite.relais;
+  portEXIT_CRITICAL(&muxSecurite);
+  return relais;
+}
+
+DefautSecurite superviseurDefaut() {
+  portENTER_CRITICAL(&muxSecurite);
+  DefautSecurite d = securite.defaut;
+  portEXIT_CRITICAL(&muxSecurite);
+  return d;
+}
@@ -0,0 +1,365 @@
+#include "tableau.h"
+
+#include <WiFi.h>
+#include <mdns.h>
+#include "tableau_page.h"
+
+// Une case par connexion : requête en cours de lecture ou flux ouvert
+struct ClientTableau {
+  WiFiClient client;
+  bool actif;
+  bool flux;
+  bool premier;                  // flux ouvert, état complet pas encore envoyé
+  char ligne[96];                // ligne d'en-tête en cours, tronquée
+  size_t longueur;
+  char chemin[16];               // chemin demandé, vide avant la ligne de requête
+  bool etagValide;               // If-None-Match égal à l'ETag de la page
+  bool post;
+  bool enTetesLus;               // POST : corps en cours de lecture dans ligne
+  size_t corps;                  // Content-Length
+  unsigned long depuis;
+  unsigned long dernierEvenement;
+  unsigned long derniereEcriture;
+  uint32_t tasAvant;             // tas libre avant l'acceptation
+  EtatTableau envoye;
+};
+static_assert(TABLEAU_COMMANDE_MAX < sizeof(ClientTableau::ligne), "corps de POST dans ligne");
+
+static WiFiServer serveur(TABLEAU_PORT);
+static ClientTableau clients[TABLEAU_CLIENTS_MAX];
+static bool demarre = false;
+static const char *versionTableau = "";
+static CommandeTableau commandeTableau = nullptr;
+
+// Mesures, cumulées depuis le démarrage du serveur
+static uint32_t pages = 0, pages304 = 0, etats = 0, introuvables = 0, refus = 0;
+static uint32_t commandes = 0, commandesRefusees = 0;
+static uint32_t evenements = 0, coupes = 0, octets = 0;
+static uint32_t fluxOuverts = 0, fluxMesures = 0, tasFluxMax = 0;
+static uint64_t tasFluxTotal = 0;
+static uint64_t serviceUs = 0, clientsIterations = 0;
+static uint32_t serviceMaxUs = 0;
+static unsigned long debutMesure = 0;
+
+int16_t dixiemesTemp(centi_t temp) {
+  int32_t t = temp;
+  return (int16_t)(t < 0 ? -((-t + 5) / 10) : (t + 5) / 10);
+}
+
+// "-12.5" à partir de dixièmes
+static int ecritDixiemes(char *buf, size_t taille, int16_t d) {
+  int32_t v = d < 0 ? -(int32_t)d : d;
+  return snprintf(buf, taille, "%s%ld.%ld", d < 0 ? "-" : "", (long)(v / 10), (long)(v % 10));
+}
+
+size_t jsonTableau(char *buf, size_t taille, const EtatTableau &e, const EtatTableau *avant,
+                   const char *version) {
+  size_t n = 0;
+  bool vide = true;
+  char valeur[24];
+  // Ajoute "cle":valeur ; false si le tampon ne suffit pas
+  auto champ = [&](const char *cle, const char *v) {
+    int k = snprintf(buf + n, taille - n, "%c\"%s\":%s", vide ? '{' : ',', cle, v);
+    if (k < 0 || (size_t)k >= taille - n) return false;
+    n += k;
+    vide = false;
+    return true;
+  };
+  if (taille < 3) return 0;
+  if (!avant || avant->tempAct != e.tempAct) {
+    ecritDixiemes(valeur, sizeof(valeur), e.tempAct);
+    if (!champ("tempAct", valeur)) return 0;
+  }
+  if (!avant || avant->tempCible != e.tempCible) {
+    ecritDixiemes(valeur, sizeof(valeur), e.tempCible);
+    if (!champ("tempCible", valeur)) return 0;
+  }
+  if ((!avant || avant->relais != e.relais) && !champ("relais", e.relais ? "1" : "0")) return 0;
+  if ((!avant || avant->manuel != e.manuel) && !champ("manuel", e.manuel ? "1" : "0")) return 0;
+  if (!avant || avant->defaut != e.defaut) {
+    snprintf(valeur, sizeof(valeur), "%u", e.defaut);
+    if (!champ("defaut", valeur)) return 0;
+  }
+  if (!avant) {
+    snprintf(valeur, sizeof(valeur), "\"%.20s\"", version);
+    if (!champ("version", valeur)) return 0;
+  }
+  if (vide || n + 2 > taille) return 0;
+  buf[n++] = '}';
+  buf[n] = '\0';
+  return n;
+}
+
+void beginTableau(const char *version, CommandeTableau commande) {
+  versionTableau = version;
+  commandeTableau = commande;
+}
+
+bool tableauActif() {
+  for (const ClientTableau &c : clients) {
+    if (c.actif && !c.flux) return true;
+  }
+  return false;
+}
+
+static void ferme(ClientTableau &c) {
+  c.client.stop();
+  c.actif = false;
+  c.flux = false;
+}
+
+// Écriture complète ou fermeture : un client qui ne lit plus remplit le
+// tampon d'émission, l'écriture est alors partielle
+static bool ecrit(ClientTableau &c, const void *donnees, size_t n) {
+  size_t envoyes = c.client.write((const uint8_t *)donnees, n);
+  octets += envoyes;
+  if (envoyes == n) {
+    c.derniereEcriture = millis();
+    return true;
+  }
+  coupes++;
+  ferme(c);
+  return false;
+}
+
+static bool ecritTexte(ClientTableau &c, const char *texte) {
+  return ecrit(c, texte, strlen(texte));
+}
+
+// Lecture des en-têtes ligne par ligne ; true à la ligne vide finale
+static bool litEnTetes(ClientTableau &c) {
+  while (c.client.available()) {
+    char ch = (char)c.client.read();
+    if (ch == '\r') continue;
+    if (ch != '\n') {
+      if (c.longueur < sizeof(c.ligne) - 1) c.ligne[c.longueur++] = ch;
+      continue;
+    }
+    c.ligne[c.longueur] = '\0';
+    if (c.longueur == 0) return true;
+    c.longueur = 0;
+    if (c.chemin[0] == '\0') {
+      // Ligne de requête : "GET /chemin HTTP/1.1" ou "POST /commande HTTP/1.1"
+      c.post = strncmp(c.ligne, "POST ", 5) == 0;
+      const char *p = strncmp(c.ligne, "GET ", 4) == 0 ? c.ligne + 4 : c.post ? c.ligne + 5 : "?";
+      size_t l = strcspn(p, " ?");
+      if (l >= sizeof(c.chemin)) l = sizeof(c.chemin) - 1;
+      memcpy(c.chemin, p, l);
+      c.chemin[l] = '\0';
+      if (l == 0) strcpy(c.chemin, "?");
+    } else if (strncasecmp(c.ligne, "If-None-Match:", 14) == 0) {
+      c.etagValide = strstr(c.ligne + 14, TABLEAU_PAGE_ETAG) != nullptr;
+    } else if (strncasecmp(c.ligne, "Content-Length:", 15) == 0) {
+      c.corps = strtoul(c.ligne + 15, nullptr, 10);
+    }
+  }
+  return false;
+}
+
+// Requête complète : en-têtes, puis corps d'un POST (Content-Length octets,
+// au plus TABLEAU_COMMANDE_MAX) dans ligne
+static bool litRequete(ClientTableau &c) {
+  if (!c.enTetesLus) {
+    if (!litEnTetes(c)) return false;
+    c.enTetesLus = true;
+    if (!c.post || c.corps > TABLEAU_COMMANDE_MAX) return true;
+  }
+  while (c.longueur < c.corps && c.client.available()) {
+    c.ligne[c.longueur++] = (char)c.client.read();
+  }
+  if (c.longueur < c.corps) return false;
+  c.ligne[c.longueur] = '\0';
+  return true;
+}
+
+// Corps d'un POST /commande passé à la fonction de beginTableau()
+static void repondCommande(ClientTableau &c) {
+  // Fin de ligne éventuelle d'un "curl --data-binary @-" ou d'un echo
+  while (c.longueur > 0 && (c.ligne[c.longueur - 1] == '\n' || c.ligne[c.longueur - 1] == '\r')) {
+    c.ligne[--c.longueur] = '\0';
+  }
+  if (c.corps > TABLEAU_COMMANDE_MAX) {
+    commandesRefusees++;
+    ecritTexte(c, "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+  } else if (commandeTableau && c.longueur > 0 && commandeTableau(c.ligne)) {
+    commandes++;
+    ecritTexte(c, "HTTP/1.1 204 No Content\r\nConnection: close\r\n\r\n");
+  } else {
+    commandesRefusees++;
+    ecritTexte(c, "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+  }
+}
+
+static void repond(ClientTableau &c, const EtatTableau &e) {
+  char entete[224];
+  if (c.post) {
+    if (strcmp(c.chemin, "/commande") == 0) {
+      repondCommande(c);
+    } else {
+      introuvables++;
+      ecritTexte(c, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    }
+  } else if (strcmp(c.chemin, "/") == 0 || strcmp(c.chemin, "/index.html") == 0) {
+    if (c.etagValide) {
+      pages304++;
+      snprintf(entete, sizeof(entete),
+               "HTTP/1.1 304 Not Modified\r\nETag: %s\r\nCache-Control: max-age=%lu\r\n"
+               "Connection: close\r\n\r\n", TABLEAU_PAGE_ETAG, (unsigned long)TABLEAU_CACHE_S);
+      ecritTexte(c, entete);
+    } else {
+      pages++;
+      snprintf(entete, sizeof(entete),
+               "HTTP/1.1 200 OK\r\nContent-Type: text/html; charset=utf-8\r\n"
+               "Content-Encoding: gzip\r\nContent-Length: %u\r\nETag: %s\r\n"
+               "Cache-Control: max-age=%lu\r\nVary: Accept-Encoding\r\nConnection: close\r\n\r\n",
+               (unsigned)TABLEAU_PAGE_TAILLE, TABLEAU_PAGE_ETAG, (unsigned long)TABLEAU_CACHE_S);
+      if (ecritTexte(c, entete)) ecrit(c, TABLEAU_PAGE_GZ, TABLEAU_PAGE_TAILLE);
+    }
+  } else if (strcmp(c.chemin, "/etat") == 0) {
+    etats++;
+    char json[160];
+    size_t n = jsonTableau(json, sizeof(json), e, nullptr, versionTableau);
+    snprintf(entete, sizeof(entete),
+             "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %u\r\n"
+             "Cache-Control: no-store\r\nConnection: close\r\n\r\n", (unsigned)n);
+    if (ecritTexte(c, entete)) ecrit(c, json, n);
+  } else if (strcmp(c.chemin, "/evenements") == 0) {
+    // Le flux reste ouvert : l'état complet part à l'itération suivante
+    if (ecritTexte(c, "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                      "Cache-Control: no-store\r\nConnection: keep-alive\r\n\r\nretry: 5000\n\n")) {
+      c.flux = true;
+      c.premier = true;
+      fluxOuverts++;
+    }
+    return;
+  } else {
+    introuvables++;
+    ecritTexte(c, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+  }
+  if (c.actif) ferme(c);
+}
+
+// Événement SSE des champs modifiés, ou commentaire de maintien
+static void pousse(ClientTableau &c, const EtatTableau &e) {
+  unsigned long maintenant = millis();
+  if (!c.premier && maintenant - c.dernierEvenement < TABLEAU_INTERVALLE_MS) return;
+  char evenement[176];
+  memcpy(evenement, "data: ", 6);
+  size_t n = jsonTableau(evenement + 6, sizeof(evenement) - 8, e, c.premier ? nullptr : &c.envoye,
+                         versionTableau);
+  if (n > 0) {
+    memcpy(evenement + 6 + n, "\n\n", 2);
+    if (!ecrit(c, evenement, n + 8)) return;
+    evenements++;
+    c.envoye = e;
+    c.dernierEvenement = maintenant;
+    if (c.premier) {
+      // Coût du flux établi : socket, tampons de réception et d'émission
+      c.premier = false;
+      uint32_t libre = ESP.getFreeHeap();
+      uint32_t tas = c.tasAvant > libre ? c.tasAvant - libre : 0;
+      tasFluxTotal += tas;
+      fluxMesures++;
+      if (tas > tasFluxMax) tasFluxMax = tas;
+    }
+  } else if (maintenant - c.derniereEcriture >= TABLEAU_VEILLE_MS) {
+    ecritTexte(c, ":\n\n");
+  }
+}
+
+// Nouvelle connexion dans une case libre, sinon 503
+static void accepte() {
+  uint32_t libre = ESP.getFreeHeap();
+  WiFiClient nouveau = serveur.available();
+  if (!nouveau) return;
+  ClientTableau *c = nullptr;
+  for (ClientTableau &k : clients) {
+    if (!k.actif) {
+      c = &k;
+      break;
+    }
+  }
+  if (c == nullptr || libre < TABLEAU_TAS_MIN) {
+    refus++;
+    nouveau.print("HTTP/1.1 503 Service Unavailable\r\nRetry-After: 10\r\n"
+                  "Content-Length: 0\r\nConnection: close\r\n\r\n");
+    nouveau.stop();
+    return;
+  }
+  c->client = nouveau;
+  c->client.setNoDelay(true);
+  c->actif = true;
+  c->flux = false;
+  c->longueur = 0;
+  c->chemin[0] = '\0';
+  c->etagValide = false;
+  c->post = false;
+  c->enTetesLus = false;
+  c->corps = 0;
+  c->depuis = millis();
+  c->derniereEcriture = c->depuis;
+  c->tasAvant = libre;
+}
+
+void updateTableau(const EtatTableau &e) {
+  if (!demarre) {
+    if (WiFi.status() != WL_CONNECTED) return;
+    serveur.begin();
+    mdns_service_add(nullptr, "_http", "_tcp", TABLEAU_PORT, nullptr, 0);
+    demarre = true;
+    debutMesure = millis();
+    Serial.printf("Tableau: http port %u, %d clients au plus\n", TABLEAU_PORT, TABLEAU_CLIENTS_MAX);
+  }
+
+  unsigned long debut = micros();
+  accepte();
+  int actifs = 0;
+  for (ClientTableau &c : clients) {
+    if (!c.actif) continue;
+    actifs++;
+    if (!c.client.connected()) {
+      ferme(c);
+      continue;
+    }
+    if (!c.flux) {
+      if (litRequete(c)) repond(c, e);
+      else if (millis() - c.depuis > TABLEAU_REQUETE_MS) ferme(c);
+      continue;
+    }
+    // Rien n'est attendu du navigateur sur un flux ouvert
+    while (c.client.available()) c.client.read();
+    pousse(c, e);
+  }
+  if (actifs > 0) {
+    uint32_t duree = micros() - debut;
+    serviceUs += duree;
+    clientsIterations += actifs;
+    if (duree > serviceMaxUs) serviceMaxUs = duree;
+  }
+}
+
+void exportTableau() {
+  int actifs = 0, flux = 0;
+  for (const ClientTableau &c : clients) {
+    actifs += c.actif;
+    flux += c.actif && c.flux;
+  }
+  Serial.printf("Tableau port %u : %d/%d connexions, %d flux, tas libre %lu\n", TABLEAU_PORT,
+                actifs, TABLEAU_CLIENTS_MAX, flux, (unsigned long)ESP.getFreeHeap());
+  Serial.printf("pages %lu (304 %lu), etat %lu, 404 %lu, refus %lu, evenements %lu, "
+                "octets %lu, coupes %lu\n", (unsigned long)pages, (unsigned long)pages304,
+                (unsigned long)etats, (unsigned long)introuvables, (unsigned long)refus,
+                (unsigned long)evenements, (unsigned long)octets, (unsigned long)coupes);
+  Serial.printf("commandes %lu, refusees %lu\n", (unsigned long)commandes,
+                (unsigned long)commandesRefusees);
+  Serial.printf("tas par flux : moyen %lu, max %lu octets (%lu flux)\n",
+                (unsigned long)(fluxMesures ? tasFluxTotal / fluxMesures : 0),
+                (unsigned long)tasFluxMax, (unsigned long)fluxOuverts);
+  // Charge : part du temps depuis le démarrage du serveur, en pour dix mille
+  unsigned long ecouleMs = millis() - debutMesure;
+  uint32_t charge = ecouleMs ? (uint32_t)(serviceUs * 10 / ecouleMs) : 0;
+  Serial.printf("service : %lu us par client et par iteration, max %lu us, charge %lu.%02lu %%\n",
+                (unsigned long)(clientsIterations ? serviceUs / clientsIterations : 0),
+                (unsigned long)serviceMaxUs, (unsigned long)(charge / 100),
+                (unsigned long)(charge % 100));
+}
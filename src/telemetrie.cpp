@@ -0,0 +1,58 @@
+#include "telemetrie.h"
+
+uint16_t crc16Ccitt(const uint8_t *donnees, size_t n) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < n; i++) {
+    crc ^= (uint16_t)donnees[i] << 8;
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+size_t cobsEncode(const uint8_t *src, size_t n, uint8_t *dst) {
+  size_t code = 0;      // position de l'octet de longueur du bloc en cours
+  size_t o = 1;
+  uint8_t longueur = 1;
+  for (size_t i = 0; i < n; i++) {
+    if (src[i] == 0) {
+      dst[code] = longueur;
+      code = o++;
+      longueur = 1;
+    } else {
+      dst[o++] = src[i];
+      longueur++;
+    }
+  }
+  dst[code] = longueur;
+  return o;
+}
+
+static void ecrit16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void ecrit32(uint8_t *p, uint32_t v) {
+  ecrit16(p, (uint16_t)v);
+  ecrit16(p + 2, (uint16_t)(v >> 16));
+}
+
+size_t encodeTelemetrie(const MesureTelemetrie &m, uint8_t *sortie) {
+  uint8_t brut[TELEMETRIE_TAILLE];
+  brut[0] = TELEMETRIE_TYPE;
+  ecrit32(brut + 1, m.ms);
+  ecrit16(brut + 5, (uint16_t)m.raw);
+  ecrit16(brut + 7, (uint16_t)m.temp);
+  ecrit16(brut + 9, (uint16_t)m.cible);
+  brut[11] = m.etat;
+  brut[12] = (uint8_t)m.rssi;
+  brut[13] = m.resolution;
+  ecrit32(brut + 14, m.boucleUs);
+  ecrit16(brut + 18, crc16Ccitt(brut, TELEMETRIE_TAILLE - 2));
+
+  size_t n = cobsEncode(brut, TELEMETRIE_TAILLE, sortie);
+  sortie[n++] = 0;
+  return n;
+}
@@ -0,0 +1,141 @@
+#include "tendance.h"
+
+void CaseTendance::vide() {
+  somme = 0;
+  min = INT16_MAX;
+  max = INT16_MIN;
+  mesures = 0;
+  relais = 0;
+}
+
+void CaseTendance::ajoute(centi_t temp, bool relaisFerme) {
+  somme += temp;
+  if (temp < min) min = temp;
+  if (temp > max) max = temp;
+  mesures++;
+  if (relaisFerme) relais++;
+}
+
+template <uint16_t N>
+void Fenetre<N>::reset(uint16_t duree) {
+  dureeCase = duree;
+  datee = false;
+  index = 0;
+  courante.vide();
+  for (uint16_t i = 0; i < N; i++) cases[i].vide();
+  minima.reset();
+  maxima.reset();
+  somme = 0;
+  mesures = 0;
+  relais = 0;
+}
+
+template <uint16_t N>
+void Fenetre<N>::ferme() {
+  // La case de même rang, N cases plus tôt, sort de la fenêtre
+  CaseTendance &c = cases[index % N];
+  somme -= c.somme;
+  mesures -= c.mesures;
+  relais -= c.relais;
+  while (!minima.vide() && minima.premier() + N <= index) minima.retirePremier();
+  while (!maxima.vide() && maxima.premier() + N <= index) maxima.retirePremier();
+
+  c = courante;
+  somme += c.somme;
+  mesures += c.mesures;
+  relais += c.relais;
+  if (c.mesures != 0) {
+    // Les cases dominées par la nouvelle ne seront plus jamais l'extrême
+    while (!minima.vide() && cases[minima.dernier() % N].min >= c.min) minima.retireDernier();
+    minima.ajoute(index);
+    while (!maxima.vide() && cases[maxima.dernier() % N].max <= c.max) maxima.retireDernier();
+    maxima.ajoute(index);
+  }
+  courante.vide();
+  index++;
+}
+
+template <uint16_t N>
+void Fenetre<N>::ajoute(uint32_t temps, centi_t temp, bool relaisFerme) {
+  uint32_t i = temps / dureeCase;
+  if (!datee) {
+    datee = true;
+    index = i;
+  } else if (i > index) {
+    if (i - index > N) {
+      // Tout l'historique est sorti de la fenêtre
+      reset(dureeCase);
+      datee = true;
+      index = i;
+    } else {
+      while (index < i) ferme();   // cases sautées : closes vides
+    }
+  }
+  courante.ajoute(temp, relaisFerme);
+}
+
+template <uint16_t N>
+StatsTendance Fenetre<N>::stats() const {
+  StatsTendance s = {0, 0, 0, 0, 0};
+  s.mesures = mesures + courante.mesures;
+  if (s.mesures == 0) return s;
+  s.min = courante.min;
+  s.max = courante.max;
+  if (!minima.vide() && cases[minima.premier() % N].min < s.min) s.min = cases[minima.premier() % N].min;
+  if (!maxima.vide() && cases[maxima.premier() % N].max > s.max) s.max = cases[maxima.premier() % N].max;
+  int64_t total = somme + courante.somme;
+  int64_t demi = s.mesures / 2;
+  s.moy = (centi_t)((total >= 0 ? total + demi : total - demi) / (int64_t)s.mesures);
+  s.pourmilleRelais = (uint16_t)((uint64_t)(relais + courante.relais) * 1000 / s.mesures);
+  return s;
+}
+
+template struct Fenetre<TENDANCE_CASES_HEURE>;
+template struct Fenetre<TENDANCE_CASES_JOUR>;
+
+void ColonneTendance::vide() {
+  actMin = INT16_MAX;
+  actMax = INT16_MIN;
+  cibleMin = INT16_MAX;
+  cibleMax = INT16_MIN;
+}
+
+void Courbe::reset() {
+  datee = false;
+  index = 0;
+  for (int i = 0; i < TENDANCE_COLONNES; i++) colonnes[i].vide();
+  modifications = 0;
+}
+
+void Courbe::ajoute(uint32_t temps, centi_t temp, centi_t cible) {
+  uint32_t i = temps / TENDANCE_COLONNE_S;
+  if (!datee) {
+    datee = true;
+    index = i;
+  } else if (i > index) {
+    // La courbe glisse : colonnes sautées vidées (une fois la largeur au plus)
+    uint32_t n = i - index < (uint32_t)TENDANCE_COLONNES ? i - index : TENDANCE_COLONNES;
+    for (uint32_t k = 1; k <= n; k++) colonnes[(i - n + k) % TENDANCE_COLONNES].vide();
+    index = i;
+    modifications++;
+  }
+  ColonneTendance &c = colonnes[index % TENDANCE_COLONNES];
+  bool change = false;
+  if (temp < c.actMin) { c.actMin = temp; change = true; }
+  if (temp > c.actMax) { c.actMax = temp; change = true; }
+  if (cible < c.cibleMin) { c.cibleMin = cible; change = true; }
+  if (cible > c.cibleMax) { c.cibleMax = cible; change = true; }
+  if (change) modifications++;
+}
+
+void Tendance::reset() {
+  heure.reset(TENDANCE_CASE_HEURE_S);
+  jour.reset(TENDANCE_CASE_JOUR_S);
+  courbe.reset();
+}
+
+void Tendance::ajoute(uint32_t temps, centi_t temp, centi_t cible, bool relaisFerme) {
+  heure.ajoute(temps, temp, relaisFerme);
+  jour.ajoute(temps, temp, relaisFerme);
+  courbe.ajoute(temps, temp, cible);
+}
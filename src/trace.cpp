@@ -0,0 +1,90 @@
+#include "trace.h"
+
+#if defined(TRACE_BOUCLE)
+
+#include <esp_pm.h>
+#include <esp_timer.h>
+
+TraceEvenement traceTampon[TRACE_TAILLE];
+uint32_t traceTete = 0;
+volatile bool traceActif = false;
+
+static const char *const nomsEtapes[NbTraceEtapes] = {
+  "iteration", "ArduinoOTA.handle", "handleWiFiReconnect", "horloge", "capteur",
+  "relais", "updateBoutons", "menu", "rendu", "sendBuffer", "tableau", "travail"
+};
+
+// Début de la partie active de l'itération courante
+static uint32_t travailDebut = 0;
+
+// Avec la fréquence dynamique, les cycles n'ont pas de durée fixe :
+// la fréquence est tenue au max tant que la capture est armée
+static esp_pm_lock_handle_t verrouFrequence = nullptr;
+
+static void arme() {
+  traceTete = 0;
+  if (verrouFrequence) esp_pm_lock_acquire(verrouFrequence);
+  traceActif = true;
+}
+
+void beginTrace() {
+  esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "trace", &verrouFrequence);
+  arme();
+}
+
+void traceIteration() {
+  if (!traceActif) return;
+  travailDebut = ESP.getCycleCount();
+  traceEnregistre(TraceIteration, travailDebut, (uint32_t)esp_timer_get_time());
+}
+
+void traceFinTravail() {
+  if (!traceActif) return;
+  uint32_t duree = ESP.getCycleCount() - travailDebut;
+  traceEnregistre(TraceTravail, travailDebut, duree);
+  uint32_t ms = duree / (getCpuFrequencyMhz() * 1000);
+  if (ms > TRACE_SEUIL_MS) {
+    traceActif = false;
+    if (verrouFrequence) esp_pm_lock_release(verrouFrequence);
+    Serial.printf("Trace figee: iteration de %lu ms, commande 'trace' pour l'export\n",
+                  (unsigned long)ms);
+  }
+}
+
+void exportTrace() {
+  bool etaitActif = traceActif;
+  traceActif = false;
+
+  uint32_t mhz = getCpuFrequencyMhz();
+  uint32_t n = traceTete < (uint32_t)TRACE_TAILLE ? traceTete : TRACE_TAILLE;
+  uint32_t ancreCycles = 0, ancreUs = 0;
+  bool ancre = false, premier = true;
+
+  Serial.println("{\"traceEvents\":[");
+  for (uint32_t i = traceTete - n; i != traceTete; i++) {
+    const TraceEvenement &e = traceTampon[i & (TRACE_TAILLE - 1)];
+    if (e.etape == TraceIteration) {
+      ancreCycles = e.debut;
+      ancreUs = e.duree;
+      ancre = true;
+      continue;
+    }
+    // Intervalles antérieurs à la première ancre conservée : pas de base de temps
+    if (!ancre || e.etape >= NbTraceEtapes) continue;
+    uint32_t ts = ancreUs + (uint32_t)(e.debut - ancreCycles) / mhz;
+    Serial.printf("%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":1}\n",
+                  premier ? "" : ",", nomsEtapes[e.etape], (unsigned long)ts,
+                  (unsigned long)(e.duree / mhz));
+    premier = false;
+  }
+  Serial.println("]}");
+
+  // Réarmement (la capture figée a été exportée)
+  if (etaitActif) {
+    traceActif = true;
+  } else {
+    arme();
+  }
+}
+
+#endif
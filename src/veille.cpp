@@ -0,0 +1,42 @@
+#include "veille.h"
+
+#include <WiFi.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <sdkconfig.h>
+
+void beginVeille() {
+#if CONFIG_PM_ENABLE
+  esp_pm_config_esp32c3_t pm = {};
+  pm.max_freq_mhz = 160;
+  pm.min_freq_mhz = 40;   // 40 MHz = XTAL, la fréquence la plus basse compatible WiFi
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+  pm.light_sleep_enable = true;
+#endif
+  esp_pm_configure(&pm);
+#endif
+}
+
+void activeModemSleep() {
+  // Radio coupée entre les beacons DTIM, réveil sur trafic
+  WiFi.setSleep(WIFI_PS_MIN_MODEM);
+}
+
+void dormirLeger(unsigned long dureeMs, const int *pins, int nbPins) {
+  // Réveil sur niveau bas des boutons : ce mode remplace temporairement le
+  // front configuré par attachInterrupt, le front perdu est rattrapé par
+  // updateBoutons() au réveil
+  for (int i = 0; i < nbPins; i++) {
+    gpio_wakeup_enable((gpio_num_t)pins[i], GPIO_INTR_LOW_LEVEL);
+  }
+  esp_sleep_enable_gpio_wakeup();
+  esp_sleep_enable_timer_wakeup((uint64_t)dureeMs * 1000ULL);
+
+  esp_light_sleep_start();
+
+  for (int i = 0; i < nbPins; i++) {
+    gpio_wakeup_disable((gpio_num_t)pins[i]);
+    gpio_set_intr_type((gpio_num_t)pins[i], GPIO_INTR_ANYEDGE);
+  }
+}
@@ -0,0 +1,221 @@
+// Implémentations d'origine remplacées par les optimisations du firmware,
+// reprises de l'historique pour le mode --avant-apres du banc : chacune est
+// rendue et chronométrée contre la version actuelle sur le même état.
+// Seul change ce que l'optimisation a changé ; le reste (drawArrow, polices)
+// est celui du firmware. Inclus par banc_ecrans.cpp après main.cpp.
+#pragma once
+
+namespace avant {
+
+// [user-026] Éditeurs écrits à la main avant les tables FieldDesc/LabelDesc,
+// valeurs formatées par concaténation de String, températures en float
+void drawDate() {
+  u8g2.setFont(u8g2_font_fub11_tr);
+  u8g2.drawStr(30, 11, "DateProg");
+
+  String sday = (day < 10 ? "0" : "") + String(day);
+  u8g2.drawStr(22, 35, sday.c_str());
+  if (menuIndex==1) drawArrow(22,35,11,2);
+  u8g2.drawStr(42, 35, "/");
+  String smonth = (month < 10 ? "0" : "") + String(month);
+  u8g2.drawStr(49, 35, smonth.c_str());
+  if (menuIndex==2) drawArrow(49,35,11,2);
+  u8g2.drawStr(69, 35, "/");
+  String syear = String(year);
+  u8g2.drawStr(76, 35, syear.c_str());
+  if (menuIndex==3) drawArrow(76,35,11,4);
+
+  String shour = (hour < 10 ? "0" : "") + String(hour);
+  u8g2.drawStr(40, 57, shour.c_str());
+  if (menuIndex==4) drawArrow(40,57,11,2);
+  u8g2.drawStr(60, 57, ":");
+  String sminute = (minute < 10 ? "0" : "") + String(minute);
+  u8g2.drawStr(66, 57, sminute.c_str());
+  if (menuIndex==5) drawArrow(66,57,11,2);
+
+  u8g2.setFont(u8g2_font_open_iconic_check_1x_t);
+  u8g2.drawGlyph(100, 57, 0x0040);
+}
+
+void drawTemp() {
+  float progTempDayF = progTempDayTemp / 100.0f, progTempNightF = progTempNightTemp / 100.0f;
+  u8g2.setFont(u8g2_font_fub11_tr);
+  u8g2.drawStr(30, 11, "TempProg");
+
+  u8g2.drawStr(0, 35, "D_");
+  String sprogHourDayTemp = (progHourDayTemp < 10 ? "0" : "") + String(progHourDayTemp);
+  u8g2.drawStr(24, 35, sprogHourDayTemp.c_str());
+  if (menuIndex==1) drawArrow(24,35,11,2);
+  u8g2.drawStr(44, 35, ":");
+  String sProgMinuteDayTemp = (progMinuteDayTemp < 10 ? "0" : "") + String(progMinuteDayTemp);
+  u8g2.drawStr(51, 35, sProgMinuteDayTemp.c_str());
+  if (menuIndex==2) drawArrow(51,35,11,2);
+  u8g2.drawStr(71, 35, "=");
+  String sprogTempDayTemp = (progTempDayF < 9.9 ? "0" : "") + String(progTempDayF,1);
+  u8g2.drawStr(88, 35, sprogTempDayTemp.c_str());
+  if (menuIndex==3) drawArrow(88,35,11,4);
+
+  u8g2.drawStr(0, 57, "N_");
+  String sprogHourNightTemp = (progHourNightTemp < 10 ? "0" : "") + String(progHourNightTemp);
+  u8g2.drawStr(24, 57, sprogHourNightTemp.c_str());
+  if (menuIndex==4) drawArrow(24,57,11,2);
+  u8g2.drawStr(44, 57, ":");
+  String sProgMinuteNightTemp = (progMinuteNightTemp < 10 ? "0" : "") + String(progMinuteNightTemp);
+  u8g2.drawStr(51, 57, sProgMinuteNightTemp.c_str());
+  if (menuIndex==5) drawArrow(51,57,11,2);
+  u8g2.drawStr(71, 57, "=");
+  String sprogTempNightTemp = (progTempNightF < 9.9 ? "0" : "") + String(progTempNightF,1);
+  u8g2.drawStr(88, 57, sprogTempNightTemp.c_str());
+  if (menuIndex==6) drawArrow(88,57,11,4);
+}
+
+// [user-029] Températures en float : accueil formaté par sprintf("%.1f"),
+// le reste de l'écran est celui du firmware
+void drawAccueil() {
+  u8g2.setFont(u8g2_font_ncenB08_tr);
+  u8g2.drawStr(0, 8, dateStr);
+
+  char tempStrAct[16];
+  sprintf(tempStrAct, "%.1f", tempAct / 100.0f);
+  u8g2.setFont(u8g2_font_fub25_tr);
+  u8g2.drawStr(25, 45, tempStrAct);
+  u8g2.setFont(u8g2_font_fub11_tr);
+  u8g2.drawStr(93, 27, "o");
+
+  char tempStrCible[16];
+  sprintf(tempStrCible, "%.1f", tempCible / 100.0f);
+  u8g2.setFont(u8g2_font_t0_12_tf);
+  u8g2.drawStr(95, HAUTEUR_ECRAN, tempStrCible);
+  u8g2.setFont(u8g2_font_tiny5_tf);
+  u8g2.drawStr(120, 59, "o");
+  if (manualTemp) {
+    u8g2.setFont(u8g2_font_open_iconic_thing_1x_t);
+    u8g2.drawGlyph(86, 65, 0x004f);
+  }
+
+  if (superviseurDefaut() != DefautAucun) {
+    u8g2.setFont(u8g2_font_fub11_tr);
+    u8g2.drawStr(4, 62, "!");
+  } else if (superviseurRelais()) {
+    u8g2.setFont(u8g2_font_open_iconic_embedded_2x_t);
+    u8g2.drawGlyph(0, HAUTEUR_ECRAN, 0x0043);
+  }
+
+  drawWiFiIcon(u8g2, 120, 10, rssi);
+  if (saveMsgUntil && ((long)saveMsgUntil - (long)millis()) > 0) {
+    u8g2.setFont(u8g2_font_fub11_tr);
+    u8g2.drawStr(25, HAUTEUR_ECRAN, "Saved !");
+  } else if (saveMsgUntil) {
+    saveMsgUntil = 0;
+  }
+}
+
+// [user-029] Consigne du programme en float, courbe en S par cos()
+float smoothStep(float startTemp, float endTemp, int startMinute, int endMinute, int nowMinute) {
+  if (nowMinute < startMinute) return endTemp;
+  if (nowMinute > endMinute)   return endTemp;
+
+  float ratio = float(nowMinute - startMinute) / float(endMinute - startMinute);
+  float sCurve = (1 - cos(ratio * PI)) / 2.0;
+  return startTemp + sCurve * (endTemp - startTemp);
+}
+
+float getTempCible(int minuteNow) {
+  float progTempDayF = progTempDay / 100.0f, progTempNightF = progTempNight / 100.0f;
+  int minuteDay   = progHourDay   * 60 + progMinuteDay;
+  int minuteNight = progHourNight * 60 + progMinuteNight;
+
+  if (minuteDay < minuteNight) {
+    if (minuteNow >= minuteDay && minuteNow < minuteNight) {
+      return smoothStep(progTempNightF, progTempDayF,
+                        minuteDay, minuteDay + fadeDuration, minuteNow);
+    } else {
+      return smoothStep(progTempDayF, progTempNightF,
+                        minuteNight, minuteNight + fadeDuration, minuteNow);
+    }
+  } else {
+    if (minuteNow >= minuteDay || minuteNow < minuteNight) {
+      return smoothStep(progTempNightF, progTempDayF,
+                        minuteDay, (minuteDay + fadeDuration) % (24*60), minuteNow);
+    } else {
+      return smoothStep(progTempDayF, progTempNightF,
+                        minuteNight, (minuteNight + fadeDuration) % (24*60), minuteNow);
+    }
+  }
+}
+
+// [user-030] Icône WiFi tracée degré par degré (cos/sin), flèches point par point
+void drawWiFiArc(Profil::Ecran &u8g2, int x, int y, int r, int startAngle, int endAngle) {
+  for (int a = startAngle; a <= endAngle; a++) {
+    float rad = a * 3.14159 / 180.0;
+    int px = x + r * cos(rad);
+    int py = y - r * sin(rad);
+    u8g2.drawPixel(px, py);
+  }
+}
+
+void drawWiFiIcon(Profil::Ecran &u8g2, int x, int y, long rssi) {
+  if (rssi != 0 && rssi > -86)
+  {
+    u8g2.drawPixel(x-1, y-1);
+    u8g2.drawPixel(x,   y-1);
+    u8g2.drawPixel(x-2, y);
+    u8g2.drawPixel(x-1, y);
+    u8g2.drawPixel(x,   y);
+    u8g2.drawPixel(x+1, y);
+    u8g2.drawPixel(x-1, y+1);
+    u8g2.drawPixel(x,   y+1);
+  }
+  if (rssi != 0 && rssi > -79)
+  {
+    drawWiFiArc(u8g2, x, y, 4, 40, 140);
+  }
+  if (rssi != 0 && rssi > -74)
+  {
+    drawWiFiArc(u8g2, x, y, 7, 40, 140);
+  }
+  if (rssi != 0 && rssi > -64)
+  {
+    drawWiFiArc(u8g2, x, y, 10, 40, 140);
+  }
+}
+
+void drawArrow(int x, int y, int fontSize, int nbCharacter) {
+  int y_margeHaut, y_margeBas;
+  if (fontSize==11) {
+  	x = x + 9 * ( nbCharacter / 2 );
+  	y_margeHaut = -15;
+  	y_margeBas = 3;
+  } else if (fontSize==8) {
+  	x = x + 3;
+  	y_margeHaut = -12;
+  	y_margeBas = 5;
+  } else {
+  	x = x + 9 * ( nbCharacter / 2 );
+  	y_margeHaut = -18;
+  	y_margeBas = 3;
+  }
+  for (int dx=-3; dx<=3; dx++) {
+    u8g2.drawPixel(x+dx, y+y_margeHaut);
+  }
+  for (int dx=-2; dx<=2; dx++) {
+    u8g2.drawPixel(x+dx, y+y_margeHaut-1);
+  }
+  for (int dx=-1; dx<=1; dx++) {
+    u8g2.drawPixel(x+dx, y+y_margeHaut-2);
+  }
+  u8g2.drawPixel(x, y+y_margeHaut-3);
+
+  for (int dx=-3; dx<=3; dx++) {
+    u8g2.drawPixel(x+dx, y+y_margeBas);
+  }
+  for (int dx=-2; dx<=2; dx++) {
+    u8g2.drawPixel(x+dx, y+y_margeBas+1);
+  }
+  for (int dx=-1; dx<=1; dx++) {
+    u8g2.drawPixel(x+dx, y+y_margeBas+2);
+  }
+  u8g2.drawPixel(x, y+y_margeBas+3);
+}
+
+}  // namespace avant
@@ -0,0 +1,466 @@
+// Banc d'écrans sur l'hôte : rend chaque écran et sous-état du firmware
+// dans le tampon U8g2 (128x64) à partir de données représentatives, le
+// compare au pixel près aux images de référence golden/<cas>.pbm et
+// chronomètre son dessin (meilleur de N rendus, clearBuffer compris).
+// Échec si une image diffère ou si un rendu dépasse sa référence de
+// golden/temps.txt d'un facteur --seuil (et d'au moins --marge µs).
+//
+// Le firmware est inclus tel quel : le banc règle ses variables globales
+// puis appelle screens[menuState].draw(), comme loop(). Les sous-états qui
+// touchent au réseau (VersionCheck, VersionUpgrade, VersionPairs) ne sont
+// pas rendus. Les temps de référence ne valent que pour la machine qui
+// les a écrits : --sans-temps ailleurs, ou --maj pour les reprendre.
+//
+// --avant-apres rend et chronomètre chaque implémentation d'origine
+// (avant.h) contre celle du firmware sur le même état : temps avant/après
+// et pixels différents (échec si une image attendue identique diffère).
+//
+//   tools/banc_ecrans/banc_ecrans.sh                  # compare
+//   tools/banc_ecrans/banc_ecrans.sh --maj            # écrit les références
+//   tools/banc_ecrans/banc_ecrans.sh --seuil 1.2 menu_5 wifi_scan_7
+//   tools/banc_ecrans/banc_ecrans.sh --avant-apres
+#include "../../src/main.cpp"
+#include "avant.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <vector>
+
+static const int LARGEUR = 128;
+static const int HAUTEUR = 64;
+static const int TAILLE_IMAGE = LARGEUR * HAUTEUR / 8;
+
+struct Cas {
+  std::string nom;
+  std::function<void()> prepare;
+};
+
+// Implémentation d'origine contre celle du firmware ; image : les deux
+// rendus doivent être identiques au pixel près
+struct Comparaison {
+  std::string nom;
+  std::function<void()> prepare;
+  std::function<void()> avant;
+  std::function<void()> apres;
+  bool image;
+};
+
+// Réseaux du scan : noms courts, longs (plus larges que l'écran), accents exclus
+static const char *const ssidsScan[] = {
+  "Livebox-3F2A", "Freebox_Maison_Etage_Superieur_5GHz", "SFR-9c0e", "iPhone de Camille",
+  "Bbox-Atelier", "TP-Link_Extender_Garage_2.4GHz_Invites", "Wokwi-GUEST", "x"
+};
+
+// État commun à tous les cas : 19/10 08:30, 21.5 °C pour 22.0 °C, relais
+// ouvert, WiFi associé (-60 dBm), consommation sur deux jours
+static void etatBase() {
+  hoteMicros = 1000000000LL;
+  rtc.adjust(DateTime(2026, 10, 19, 8, 30, 0));
+  beginHorlogeRapide(rtc, -1, 0);
+
+  menuState = Accueil;
+  menuIndex = 0;
+  tempAct = 2150;
+  tempCible = 2200;
+  manualTemp = false;
+  rssi = -60;
+  saveMsgUntil = 0;
+  snprintf(dateStr, sizeof(dateStr), "%02d/%02d %02d:%02d:%02d", 19, 10, 8, 30, 0);
+  beginSuperviseur(PIN_RELAY);
+  superviseurMesure(tempAct);
+  superviseurDemande(false);
+
+  day = 19; month = 10; year = 2026; hour = 8; minute = 30;
+  progHourDay = 9; progMinuteDay = 30; progTempDay = 2550;
+  progHourNight = 19; progMinuteNight = 0; progTempNight = 2050;
+  enterTemp();
+
+  wifiState = WifiMain;
+  charIndex = 0;
+  wifiSSIDTemp = "";
+  wifiPassTemp = "";
+  WiFi.etatHote = WL_CONNECTED;
+  WiFi.rssiHote = rssi;
+  WiFi.ssidsHote.assign(std::begin(ssidsScan), std::end(ssidsScan));
+  wifiCount = (int)WiFi.ssidsHote.size();
+
+  versionState = VersionMain;
+  currentVersion = "0.2.1";
+  latestVersion = "0.2.2";
+
+  // Relais fermé 0 à 60 min selon l'heure, sur les 32 dernières heures
+  conso.reset(25);
+  uint32_t t = DateTime(2026, 10, 18, 0, 0, 0).unixtime();
+  for (int h = 0; h <= 32; h++) {
+    conso.avance(t + h * 3600, true, (uint32_t)((h * 37) % 61) * 60000);
+  }
+  tendance.reset();
+}
+
+// Mesures toutes les 2 s jusqu'à l'heure du banc, sur heures heures : consigne
+// jour/nuit du programme, relais à hystérésis ; pas de mesure entre
+// trouDebut et trouFin (heures avant la fin)
+static void remplitTendance(int heures, int trouDebut = 0, int trouFin = 0) {
+  uint32_t fin = DateTime(2026, 10, 19, 8, 30, 0).unixtime();
+  centi_t temp = 2100;
+  bool relais = false;
+  for (uint32_t t = fin - heures * 3600; t <= fin; t += 2) {
+    uint32_t ilYa = (fin - t) / 3600;
+    if (ilYa < (uint32_t)trouDebut && ilYa >= (uint32_t)trouFin) continue;
+    int minuteJour = (t % 86400) / 60;
+    centi_t cible = tempCibleProgramme(minuteJour, 9 * 60 + 30, 2550, 19 * 60, 2050, 120);
+    relais = relais ? temp < cible + 30 : temp < cible - 30;
+    temp += relais ? 1 : -1;
+    tendance.ajoute(t, temp, cible, relais);
+  }
+}
+
+static std::vector<Cas> listeCas() {
+  std::vector<Cas> l;
+  auto ajoute = [&](const std::string &nom, std::function<void()> f) { l.push_back({nom, f}); };
+
+  // Accueil
+  ajoute("accueil", [] {});
+  ajoute("accueil_negatif", [] { tempAct = -1250; tempCible = 500; superviseurMesure(tempAct); });
+  ajoute("accueil_negatif_petit", [] { tempAct = -50; superviseurMesure(tempAct); });
+  ajoute("accueil_chaud", [] { tempAct = 4990; tempCible = 5000; superviseurMesure(tempAct); });
+  ajoute("accueil_manuel", [] { manualTemp = true; tempCible = 2450; });
+  ajoute("accueil_relais", [] { superviseurDemande(true); });
+  ajoute("accueil_surchauffe", [] { superviseurDemande(true); superviseurMesure(6000); tempAct = 6000; });
+  ajoute("accueil_sauve", [] { saveMsgUntil = millis() + 1000; });
+  const long niveaux[] = {0, -50, -70, -80, -90};
+  for (long r : niveaux) {
+    ajoute("accueil_rssi" + std::to_string(-r), [r] { rssi = r; });
+  }
+
+  // Menu : toutes les entrées, défilement compris
+  for (int i = 1; i <= nbMenuItems; i++) {
+    ajoute("menu_" + std::to_string(i), [i] { menuState = Menu; menuIndex = i; });
+  }
+
+  // Éditeurs : chaque champ sélectionné
+  for (int i = 1; i <= dateEditor.nbFields; i++) {
+    ajoute("date_" + std::to_string(i), [i] { menuState = Date; menuIndex = i; });
+  }
+  ajoute("date_bornes", [] { menuState = Date; menuIndex = 3; day = 1; month = 1; year = 9999; hour = 0; minute = 0; });
+  for (int i = 1; i <= tempEditor.nbFields; i++) {
+    ajoute("temp_" + std::to_string(i), [i] { menuState = Temp; menuIndex = i; });
+  }
+  ajoute("temp_bornes", [] {
+    menuState = Temp; menuIndex = 6;
+    progTempDayTemp = 5000; progTempNightTemp = 0; progHourNightTemp = 23; progMinuteNightTemp = 59;
+  });
+
+  // WiFi
+  for (int i = 1; i <= 4; i++) {
+    ajoute("wifi_" + std::to_string(i), [i] { menuState = Wifi; wifiState = WifiMain; menuIndex = i; });
+  }
+  for (int i = 0; i < (int)(sizeof(ssidsScan) / sizeof(ssidsScan[0])); i++) {
+    ajoute("wifi_scan_" + std::to_string(i), [i] { menuState = Wifi; wifiState = WifiScan; menuIndex = i; });
+  }
+  ajoute("wifi_scan_vide", [] { menuState = Wifi; wifiState = WifiScan; menuIndex = 0; WiFi.ssidsHote.clear(); });
+  ajoute("wifi_ssid_vide", [] { menuState = Wifi; wifiState = WifiSSID; });
+  ajoute("wifi_ssid", [] { menuState = Wifi; wifiState = WifiSSID; wifiSSIDTemp = "Livebox"; charIndex = 30; });
+  ajoute("wifi_ssid_long", [] {
+    menuState = Wifi; wifiState = WifiSSID;
+    wifiSSIDTemp = "Freebox_Maison_Etage_Superieur_5GHz"; charIndex = sizeof(charSet) - 2;
+  });
+  ajoute("wifi_pass", [] { menuState = Wifi; wifiState = WifiPassword; wifiPassTemp = "m0t.de-passe"; charIndex = 5; });
+  ajoute("wifi_pass_long", [] {
+    menuState = Wifi; wifiState = WifiPassword;
+    wifiPassTemp = "Un$mot&de@passe*beaucoup.trop-long_0123456789"; charIndex = 62;
+  });
+
+  // Version
+  ajoute("version", [] { menuState = Version; menuIndex = 1; });
+  ajoute("version_hors_ligne", [] { menuState = Version; menuIndex = 1; WiFi.etatHote = 0; });
+  ajoute("version_maj", [] { menuState = Version; menuIndex = 1; versionState = VersionUpdate; });
+  ajoute("version_maj_longue", [] {
+    menuState = Version; menuIndex = 1; versionState = VersionUpdate;
+    currentVersion = "10.20.30"; latestVersion = "10.20.31";
+  });
+
+  // Statistiques
+  ajoute("stats", [] { menuState = Stats; menuIndex = 5; });
+  ajoute("stats_vide", [] { menuState = Stats; menuIndex = 5; conso.reset(25); });
+  ajoute("stats_pleine", [] {
+    menuState = Stats; menuIndex = 5;
+    conso.reset(2000);
+    uint32_t t = DateTime(2026, 10, 12, 0, 0, 0).unixtime();
+    for (int h = 0; h <= 7 * 24 + 8; h++) conso.avance(t + h * 3600, true, 3600000);
+  });
+
+  // Tendance
+  ajoute("tendance", [] { menuState = TendanceEcran; menuIndex = 6; remplitTendance(26); });
+  ajoute("tendance_vide", [] { menuState = TendanceEcran; menuIndex = 6; });
+  ajoute("tendance_debut", [] { menuState = TendanceEcran; menuIndex = 6; remplitTendance(0); });
+  ajoute("tendance_trou", [] { menuState = TendanceEcran; menuIndex = 6; remplitTendance(26, 12, 3); });
+  return l;
+}
+
+// Résultats des calculs chronométrés sans image, gardés par volatile
+static volatile float puitsFlottant;
+static volatile centi_t puitsCenti;
+
+static std::vector<Comparaison> listeComparaisons() {
+  std::vector<Comparaison> l;
+  auto ajoute = [&](const std::string &nom, std::function<void()> prepare,
+                    std::function<void()> av, std::function<void()> ap, bool image) {
+    l.push_back({nom, prepare, av, ap, image});
+  };
+
+  // [user-026] éditeurs décrits par tables
+  for (int i = 1; i <= dateEditor.nbFields; i++) {
+    ajoute("editeur_date_" + std::to_string(i), [i] { menuIndex = i; }, avant::drawDate, drawDate, true);
+  }
+  for (int i = 1; i <= tempEditor.nbFields; i++) {
+    ajoute("editeur_temp_" + std::to_string(i), [i] { menuIndex = i; }, avant::drawTemp, drawTemp, true);
+  }
+
+  // [user-029] températures en centièmes : accueil sans printf flottant,
+  // consigne du programme par table au lieu de cos() (1440 minutes, pas
+  // d'image : l'écart au cosinus est vérifié par le commit)
+  ajoute("accueil_format", [] {}, avant::drawAccueil, drawAccueil, true);
+  ajoute("accueil_format_negatif", [] { tempAct = -1250; tempCible = 500; }, avant::drawAccueil, drawAccueil, true);
+  ajoute("accueil_format_manuel", [] { manualTemp = true; tempCible = 2450; }, avant::drawAccueil, drawAccueil, true);
+  ajoute("consigne_24h", [] {}, [] {
+    for (int m = 0; m < 24 * 60; m++) puitsFlottant = avant::getTempCible(m);
+  }, [] {
+    Programme p = programme();
+    for (int m = 0; m < 24 * 60; m++) {
+      puitsCenti = tempCibleProgramme(m, p.minuteDay, p.tempDay, p.minuteNight, p.tempNight, p.fadeDuration);
+    }
+  }, false);
+
+  // [user-030] sprites XBM : icône WiFi de l'accueil à chaque niveau,
+  // flèches des éditeurs (police 11, 2 et 4 caractères) et du menu WiFi (8)
+  const long niveaux[] = {-50, -70, -76, -80};
+  for (long r : niveaux) {
+    ajoute("icone_wifi_rssi" + std::to_string(-r), [] {},
+           [r] { avant::drawWiFiIcon(u8g2, 120, 10, r); }, [r] { drawWiFiIcon(u8g2, 120, 10, r); }, true);
+  }
+  ajoute("fleches_11_2", [] {}, [] { avant::drawArrow(22, 35, 11, 2); }, [] { drawArrow(22, 35, 11, 2); }, true);
+  ajoute("fleches_11_4", [] {}, [] { avant::drawArrow(76, 35, 11, 4); }, [] { drawArrow(76, 35, 11, 4); }, true);
+  ajoute("fleches_8", [] {}, [] { avant::drawArrow(10, 39, 8, 1); }, [] { drawArrow(10, 39, 8, 1); }, true);
+  return l;
+}
+
+// Image au format PBM binaire (P4), 1 = pixel allumé
+static std::vector<uint8_t> image() {
+  std::vector<uint8_t> img(TAILLE_IMAGE, 0);
+  const uint8_t *tampon = u8g2.getBufferPtr();
+  for (int y = 0; y < HAUTEUR; y++) {
+    for (int x = 0; x < LARGEUR; x++) {
+      if ((tampon[(y / 8) * LARGEUR + x] >> (y % 8)) & 1) {
+        img[y * (LARGEUR / 8) + x / 8] |= 0x80 >> (x % 8);
+      }
+    }
+  }
+  return img;
+}
+
+static bool ecritPbm(const std::string &chemin, const std::vector<uint8_t> &img) {
+  std::ofstream f(chemin, std::ios::binary);
+  f << "P4\n" << LARGEUR << " " << HAUTEUR << "\n";
+  f.write((const char *)img.data(), img.size());
+  return (bool)f;
+}
+
+static bool litPbm(const std::string &chemin, std::vector<uint8_t> &img) {
+  std::ifstream f(chemin, std::ios::binary);
+  std::string magique;
+  int l = 0, h = 0;
+  if (!(f >> magique >> l >> h) || magique != "P4" || l != LARGEUR || h != HAUTEUR) return false;
+  f.get();
+  img.assign(TAILLE_IMAGE, 0);
+  return (bool)f.read((char *)img.data(), img.size());
+}
+
+static int pixelsDifferents(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b) {
+  int n = 0;
+  for (int i = 0; i < TAILLE_IMAGE; i++) n += __builtin_popcount(a[i] ^ b[i]);
+  return n;
+}
+
+static void dessine(const Cas &c) {
+  etatBase();
+  c.prepare();
+  u8g2.clearBuffer();
+  screens[menuState].draw();
+}
+
+// Meilleur temps en µs de n rendus successifs du même état, après n/4
+// rendus de chauffe : le bruit de la machine (autres processus, fréquence
+// du processeur) ne fait qu'ajouter du temps, le minimum est le plus stable
+static double chronometre(int n, const std::function<void()> &draw) {
+  for (int i = 0; i < n / 4; i++) {
+    u8g2.clearBuffer();
+    draw();
+  }
+  double meilleur = 1e12;
+  for (int i = 0; i < n; i++) {
+    auto debut = std::chrono::steady_clock::now();
+    u8g2.clearBuffer();
+    draw();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - debut).count();
+    meilleur = std::min(meilleur, us);
+  }
+  return meilleur;
+}
+
+static double chronometre(int n) {
+  return chronometre(n, [] { screens[menuState].draw(); });
+}
+
+// Mode --avant-apres : 1 si une image attendue identique diffère
+static int avantApres(int repetitions, const std::vector<std::string> &filtre) {
+  int diffs = 0, n = 0;
+  double totalAvant = 0, totalApres = 0;
+  for (const Comparaison &c : listeComparaisons()) {
+    if (!filtre.empty() && std::find(filtre.begin(), filtre.end(), c.nom) == filtre.end()) continue;
+    etatBase();
+    c.prepare();
+    u8g2.clearBuffer();
+    c.avant();
+    std::vector<uint8_t> imgAvant = image();
+    u8g2.clearBuffer();
+    c.apres();
+    std::vector<uint8_t> imgApres = image();
+    double av = chronometre(repetitions, c.avant);
+    double ap = chronometre(repetitions, c.apres);
+    std::string etat = "-";
+    if (c.image) {
+      int p = pixelsDifferents(imgAvant, imgApres);
+      etat = p ? "DIFF " + std::to_string(p) + " pixels" : "image identique";
+      diffs += p != 0;
+    }
+    printf("%-24s avant %8.2f us  apres %8.2f us  x%5.2f  %s\n", c.nom.c_str(), av, ap,
+           ap > 0 ? av / ap : 0.0, etat.c_str());
+    totalAvant += av;
+    totalApres += ap;
+    n++;
+  }
+  printf("%d comparaisons : avant %.1f us, apres %.1f us au total, %d images differentes\n",
+         n, totalAvant, totalApres, diffs);
+  return diffs ? 1 : 0;
+}
+
+static std::map<std::string, double> litTemps(const std::string &chemin) {
+  std::map<std::string, double> t;
+  std::ifstream f(chemin);
+  std::string ligne;
+  while (std::getline(f, ligne)) {
+    if (ligne.empty() || ligne[0] == '#') continue;
+    std::istringstream l(ligne);
+    std::string nom;
+    double us;
+    if (l >> nom >> us) t[nom] = us;
+  }
+  return t;
+}
+
+static void usage() {
+  fprintf(stderr,
+          "banc_ecrans [--maj] [--golden DIR] [--sortie DIR] [--repetitions N]\n"
+          "            [--seuil F] [--marge US] [--sans-temps] [cas...]\n"
+          "banc_ecrans --avant-apres [--repetitions N] [comparaison...]\n");
+}
+
+int main(int argc, char **argv) {
+  std::string golden = "tools/banc_ecrans/golden";
+  std::string sortie = ".pio/banc_ecrans";
+  int repetitions = 200;
+  double seuil = 1.5;
+  double marge = 5;
+  bool maj = false, avecTemps = true, comparaisons = false;
+  std::vector<std::string> filtre;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    bool suivant = i + 1 < argc;
+    if (a == "--maj") maj = true;
+    else if (a == "--sans-temps") avecTemps = false;
+    else if (a == "--avant-apres") comparaisons = true;
+    else if (a == "--golden" && suivant) golden = argv[++i];
+    else if (a == "--sortie" && suivant) sortie = argv[++i];
+    else if (a == "--repetitions" && suivant) repetitions = std::max(1, atoi(argv[++i]));
+    else if (a == "--seuil" && suivant) seuil = atof(argv[++i]);
+    else if (a == "--marge" && suivant) marge = atof(argv[++i]);
+    else if (a[0] != '-') filtre.push_back(a);
+    else { usage(); return 2; }
+  }
+
+  u8g2.begin();
+  if (comparaisons) return avantApres(repetitions, filtre);
+  std::filesystem::create_directories(sortie);
+  if (maj) std::filesystem::create_directories(golden);
+  std::map<std::string, double> references = litTemps(golden + "/temps.txt");
+  std::vector<std::pair<std::string, double>> temps;
+  int diffs = 0, lents = 0, manquants = 0, rendus = 0;
+
+  for (const Cas &c : listeCas()) {
+    if (!filtre.empty() && std::find(filtre.begin(), filtre.end(), c.nom) == filtre.end()) continue;
+    rendus++;
+    dessine(c);
+    std::vector<uint8_t> img = image();
+    double us = chronometre(repetitions);
+    temps.push_back({c.nom, us});
+
+    std::string ref = golden + "/" + c.nom + ".pbm";
+    std::string etat = "ok";
+    if (maj) {
+      if (!ecritPbm(ref, img)) { fprintf(stderr, "écriture impossible : %s\n", ref.c_str()); return 2; }
+      etat = "maj";
+    } else {
+      std::vector<uint8_t> attendu;
+      if (!litPbm(ref, attendu)) {
+        etat = "SANS REFERENCE";
+        manquants++;
+        ecritPbm(sortie + "/" + c.nom + ".pbm", img);
+      } else if (int n = pixelsDifferents(img, attendu)) {
+        char msg[48];
+        snprintf(msg, sizeof(msg), "DIFF %d pixels", n);
+        etat = msg;
+        diffs++;
+        std::vector<uint8_t> x(TAILLE_IMAGE);
+        for (int i = 0; i < TAILLE_IMAGE; i++) x[i] = img[i] ^ attendu[i];
+        ecritPbm(sortie + "/" + c.nom + ".pbm", img);
+        ecritPbm(sortie + "/" + c.nom + ".diff.pbm", x);
+      }
+    }
+
+    char reference[24] = "-";
+    auto r = references.find(c.nom);
+    if (r != references.end()) {
+      snprintf(reference, sizeof(reference), "%.1f", r->second);
+      if (!maj && avecTemps && us > r->second * seuil && us > r->second + marge) {
+        etat = etat == "ok" ? "LENT" : etat + ", LENT";
+        lents++;
+      }
+    }
+    printf("%-24s %8.1f us  (ref %6s)  %s\n", c.nom.c_str(), us, reference, etat.c_str());
+  }
+
+  if (maj) {
+    // Les temps sont fusionnés : un filtre ne met à jour que ses cas
+    for (auto &t : temps) references[t.first] = t.second;
+    std::ofstream f(golden + "/temps.txt");
+    f << "# meilleur temps en µs d'un rendu (clearBuffer + draw), machine de référence\n";
+    for (auto &t : references) {
+      char ligne[64];
+      snprintf(ligne, sizeof(ligne), "%s %.1f\n", t.first.c_str(), t.second);
+      f << ligne;
+    }
+    printf("%d images et temps de référence écrits dans %s\n", rendus, golden.c_str());
+    return 0;
+  }
+
+  printf("%d cas : %d différences, %d sans référence, %d plus lents que x%.2f\n",
+         rendus, diffs, manquants, lents, seuil);
+  if (diffs || manquants) printf("images obtenues (et .diff.pbm) dans %s\n", sortie.c_str());
+  return diffs || manquants || lents ? 1 : 0;
+}
@@ -0,0 +1,54 @@
+#!/bin/sh
+# Construit et lance le banc d'écrans (banc_ecrans.cpp) depuis la racine du dépôt.
+# La partie C de U8g2 est prise dans les bibliothèques de PlatformIO
+# (pio pkg install), ou dans le dossier src de U8g2 donné par U8G2_SRC.
+# Les arguments sont passés au banc : --maj, --seuil F, --sans-temps, cas...
+# Les images de référence ne valent que pour la version de U8g2 fixée dans
+# platformio.ini : --maj note cette version dans golden/u8g2.version, la
+# comparaison prévient si la bibliothèque utilisée en diffère.
+set -e
+cd "$(dirname "$0")/../.."
+U8G2_SRC=${U8G2_SRC:-.pio/libdeps/seeed_xiao_esp32c3/U8g2/src}
+SORTIE=.pio/banc_ecrans
+if [ ! -f "$U8G2_SRC/clib/u8g2.h" ]; then
+  echo "U8g2 introuvable dans $U8G2_SRC (pio pkg install, ou U8G2_SRC=...)" >&2
+  exit 2
+fi
+mkdir -p "$SORTIE/obj"
+
+GOLDEN=tools/banc_ecrans/golden
+MAJ=
+prec=
+for a in "$@"; do
+  [ "$prec" = "--golden" ] && GOLDEN=$a
+  [ "$a" = "--maj" ] && MAJ=1
+  prec=$a
+done
+VERSION=$(sed -n 's/^version=//p' "$U8G2_SRC/../library.properties" 2>/dev/null || true)
+if [ -n "$MAJ" ]; then
+  mkdir -p "$GOLDEN"
+  echo "${VERSION:-inconnue}" > "$GOLDEN/u8g2.version"
+elif [ ! -f "$GOLDEN/u8g2.version" ]; then
+  echo "pas de références dans $GOLDEN : les créer avec --maj et la version de U8g2 de platformio.ini" >&2
+elif [ "$(cat "$GOLDEN/u8g2.version")" != "${VERSION:-inconnue}" ]; then
+  echo "attention : références faites avec U8g2 $(cat "$GOLDEN/u8g2.version"), banc construit avec ${VERSION:-une version inconnue}" >&2
+fi
+
+# U8g2 compilée une fois par dossier source, sans ses propres avertissements
+if [ ! -f "$SORTIE/obj/libu8g2.a" ] || [ "$(cat "$SORTIE/obj/source" 2>/dev/null)" != "$U8G2_SRC" ]; then
+  rm -f "$SORTIE"/obj/*.o "$SORTIE/obj/libu8g2.a"
+  for c in "$U8G2_SRC"/clib/*.c; do
+    gcc -O2 -w -c "$c" -I"$U8G2_SRC/clib" -o "$SORTIE/obj/$(basename "$c" .c).o"
+  done
+  ar rcs "$SORTIE/obj/libu8g2.a" "$SORTIE"/obj/*.o
+  echo "$U8G2_SRC" > "$SORTIE/obj/source"
+fi
+
+# Firmware (main.cpp est inclus par le banc) et environnement hôte, avec
+# avertissements ; les en-têtes de U8g2 sont pris comme en-têtes système
+SOURCES=$(ls src/*.cpp | grep -v '^src/main.cpp$')
+g++ -std=gnu++17 -O2 -Wall -Wextra -Itools/banc_ecrans/hote -isystem "$U8G2_SRC" -Iinclude -include Arduino.h \
+  tools/banc_ecrans/banc_ecrans.cpp tools/banc_ecrans/hote/hote.cpp $SOURCES \
+  "$SORTIE/obj/libu8g2.a" -o "$SORTIE/banc_ecrans"
+
+"$SORTIE/banc_ecrans" --sortie "$SORTIE" "$@"
@@ -0,0 +1,55 @@
+// Boucle du firmware sur l'hôte, pour un profil de carte (include/profil.h)
+// choisi à la compilation : setup() puis loop() pendant une heure de temps
+// simulé (environnement du banc d'écrans, tools/banc_ecrans/hote), WiFi
+// associé, un appui toutes les 10 minutes sur les profils à boutons pour
+// rallumer l'écran. Chaque loop() est chronométré en temps réel de l'hôte ;
+// les attentes du firmware n'avancent que le temps simulé.
+// Affiche une ligne "boucle ..." lue par tools/taille_profils.py --hote.
+// Les durées sont celles de l'hôte, pas de l'ESP32-C3 : elles ne valent
+// que pour comparer les profils entre eux.
+//
+//   tools/taille_profils.py --hote       # construit et lance chaque profil
+#include "../../src/main.cpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+static const int64_t DUREE_US = 3600LL * 1000000;
+static const int64_t APPUI_US = 600LL * 1000000;
+
+int main() {
+  hoteMicros = 1000000;
+  rtc.adjust(DateTime(2026, 10, 19, 8, 30, 0));
+  WiFi.etatHote = WL_CONNECTED;
+  WiFi.rssiHote = -60;
+  setup();
+
+  std::vector<uint32_t> durees;
+  int64_t prochainAppui = hoteMicros + APPUI_US;
+  while (hoteMicros < DUREE_US) {
+    if (Profil::BOUTONS && hoteMicros >= prochainAppui) {
+      // Comme un appui vu par loop() : réveil de l'écran sans action
+      derniereActivite = millis();
+      if (!ecranAllume) {
+        u8g2.setPowerSave(0);
+        ecranAllume = true;
+      }
+      prochainAppui += APPUI_US;
+    }
+    int64_t avant = hoteMicros;
+    auto debut = std::chrono::steady_clock::now();
+    loop();
+    auto fin = std::chrono::steady_clock::now();
+    durees.push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(fin - debut).count());
+    if (hoteMicros == avant) hoteMicros += 1000;   // itération sans attente : 1 ms simulée
+  }
+
+  std::sort(durees.begin(), durees.end());
+  uint64_t total = 0;
+  for (uint32_t d : durees) total += d;
+  printf("boucle iterations %zu moyenne_ns %llu mediane_ns %u p99_ns %u max_ns %u\n",
+         durees.size(), (unsigned long long)(total / durees.size()), durees[durees.size() / 2],
+         durees[durees.size() * 99 / 100], durees.back());
+  return 0;
+}
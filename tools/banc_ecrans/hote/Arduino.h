@@ -0,0 +1,122 @@
+// Environnement Arduino/ESP32 minimal pour compiler le firmware sur l'hôte
+// (tools/banc_ecrans) ; définitions dans hote.cpp, horloge pilotée par le banc.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+using std::min; using std::max;
+typedef uint8_t byte;
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define OUTPUT_OPEN_DRAIN 0x12
+#define taskYIELD() do {} while (0)
+#define CHANGE 3
+#define FALLING 4
+#define RISING 5
+#define PI 3.14159265358979
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define F(x) x
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+#define PROGMEM
+#define D0 0
+#define D1 1
+#define D2 2
+#define D3 3
+#define D7 7
+#define D8 8
+#define D9 9
+#define D10 10
+// Temps simulé en µs, avancé par delay() et par le banc
+extern int64_t hoteMicros;
+unsigned long millis(); unsigned long micros(); void delay(unsigned long); void delayMicroseconds(unsigned);
+void pinMode(int,int); void digitalWrite(int,int); int digitalRead(int);
+void attachInterrupt(int, void(*)(), int); int digitalPinToInterrupt(int); void detachInterrupt(int);
+unsigned sleep(unsigned);
+long random(long); long random(long,long);
+void yield();
+class __FlashStringHelper;
+class String : public std::string { public:
+  String(){} String(const char*s):std::string(s?s:""){} String(const std::string&s):std::string(s){}
+  String(char c):std::string(1,c){} String(int v):std::string(std::to_string(v)){} String(unsigned v):std::string(std::to_string(v)){}
+  String(long v):std::string(std::to_string(v)){} String(unsigned long v):std::string(std::to_string(v)){}
+  String(float v,int d=2):String((double)v,d){} String(double v,int d=2){char b[32];snprintf(b,sizeof b,"%.*f",d,v);assign(b);}
+  String(int v, unsigned char):std::string(std::to_string(v)){}
+  void remove(unsigned i){erase(i);} void remove(unsigned i,unsigned n){erase(i,n);}
+  int toInt() const {return atoi(c_str());} float toFloat() const {return atof(c_str());}
+  int indexOf(char c, unsigned from=0) const {auto p=find(c,from);return p==npos?-1:(int)p;}
+  int indexOf(const char* c, unsigned from=0) const {auto p=find(c,from);return p==npos?-1:(int)p;}
+  String substring(unsigned a) const {return String(substr(a));} String substring(unsigned a,unsigned b) const {return String(substr(a,b-a));}
+  void trim(){} bool startsWith(const String&s) const {return rfind(s,0)==0;} bool equals(const String&s) const {return *this==s;} bool equalsIgnoreCase(const String&s) const {return *this==s;}
+  void toLowerCase(){} void toUpperCase(){} bool isEmpty() const {return empty();}
+  String& operator+=(const String&s){append(s);return *this;} String& operator+=(const char*s){append(s);return *this;} String& operator+=(char c){push_back(c);return *this;}
+  String& operator+=(int v){append(std::to_string(v));return *this;}
+  String& operator+=(unsigned v){append(std::to_string(v));return *this;}
+  String& operator+=(long v){append(std::to_string(v));return *this;}
+  String& operator+=(unsigned long v){append(std::to_string(v));return *this;}
+  char charAt(unsigned i) const {return at(i);}
+  void reserve(unsigned n){std::string::reserve(n);}
+  bool concat(const char*s){append(s);return true;}
+};
+inline String operator+(const String&a,const String&b){return String(std::string(a)+std::string(b));}
+inline String operator+(const String&a,const char*b){return String(std::string(a)+b);}
+inline String operator+(const char*a,const String&b){return String(a+std::string(b));}
+inline String operator+(const String&a,char b){return String(std::string(a)+b);}
+class Print { public:
+  virtual size_t write(uint8_t)=0; virtual size_t write(const uint8_t*b,size_t n){for(size_t i=0;i<n;i++)write(b[i]);return n;}
+  size_t print(const char*){return 0;} size_t print(const String&){return 0;} size_t print(int,int=10){return 0;} size_t print(unsigned,int=10){return 0;} size_t print(long,int=10){return 0;} size_t print(unsigned long,int=10){return 0;} size_t print(double,int=2){return 0;} size_t print(char){return 0;}
+  size_t println(const char*){return 0;} size_t println(const String&){return 0;} size_t println(int,int=10){return 0;} size_t println(unsigned,int=10){return 0;}size_t println(long,int=10){return 0;} size_t println(unsigned long,int=10){return 0;} size_t println(double,int=2){return 0;} size_t println(){return 0;} size_t println(char){return 0;}
+  size_t printf(const char*,...){return 0;}
+};
+class Stream : public Print { public: virtual int available(){return 0;} virtual int read(){return -1;} virtual int peek(){return -1;} size_t write(uint8_t){return 1;}
+  size_t readBytes(uint8_t*,size_t){return 0;} size_t readBytes(char*,size_t){return 0;} using Print::write; void setTimeout(unsigned long){}
+  String readStringUntil(char){return String();}
+};
+class HardwareSerial : public Stream { public: void begin(unsigned long){} operator bool(){return true;} int availableForWrite(){return 128;} void flush(){} void setTxBufferSize(size_t){} void setRxBufferSize(size_t){} };
+extern HardwareSerial Serial;
+class IPAddress { public: IPAddress(){} IPAddress(uint32_t){} IPAddress(uint8_t,uint8_t,uint8_t,uint8_t){} String toString() const {return String();} uint8_t operator[](int)const{return 0;} operator uint32_t() const {return 0;} };
+// FreeRTOS / ESP32 core
+typedef int BaseType_t; typedef unsigned UBaseType_t; typedef uint32_t TickType_t;
+typedef void* QueueHandle_t; typedef void* TaskHandle_t; typedef void* SemaphoreHandle_t;
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define portMAX_DELAY 0xffffffff
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(x) (x)
+#define portYIELD_FROM_ISR(...) ((void)0)
+typedef struct { int x; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(m) (void)(m)
+#define portEXIT_CRITICAL(m) (void)(m)
+#define portENTER_CRITICAL_ISR(m) (void)(m)
+#define portEXIT_CRITICAL_ISR(m) (void)(m)
+QueueHandle_t xQueueCreate(UBaseType_t, UBaseType_t);
+BaseType_t xQueueSend(QueueHandle_t, const void*, TickType_t);
+BaseType_t xQueueSendFromISR(QueueHandle_t, const void*, BaseType_t*);
+BaseType_t xQueueReceive(QueueHandle_t, void*, TickType_t);
+BaseType_t xQueuePeek(QueueHandle_t, void*, TickType_t);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t);
+BaseType_t xTaskCreate(void(*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*);
+BaseType_t xTaskCreatePinnedToCore(void(*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*, int);
+void vTaskDelay(TickType_t); void vTaskDelayUntil(TickType_t*, TickType_t); TickType_t xTaskGetTickCount();
+void vTaskSuspendAll(); BaseType_t xTaskResumeAll();
+SemaphoreHandle_t xSemaphoreCreateMutex(); BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t); BaseType_t xSemaphoreGive(SemaphoreHandle_t);
+SemaphoreHandle_t xSemaphoreCreateBinary(); BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t, BaseType_t*);
+void attachInterruptArg(uint8_t, void(*)(void*), void*, int);
+#include <time.h>
+int64_t esp_timer_get_time();
+void configTzTime(const char*, const char*, const char* = nullptr, const char* = nullptr);
+bool getLocalTime(struct tm*, uint32_t = 5000);
+class EspClass { public: void restart(){} uint64_t getEfuseMac(){return 0;} uint32_t getFreeHeap(){return 0;} uint32_t getCycleCount(){return 0;} uint32_t getSketchSize(){return 0;} uint32_t getFreeSketchSpace(){return 0;} uint32_t getMinFreeHeap(){return 0;} String getSketchMD5(){return String();} };
+extern EspClass ESP;
+inline uint32_t getCpuFrequencyMhz(){return 160;}
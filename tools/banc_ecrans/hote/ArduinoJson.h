@@ -0,0 +1,10 @@
+#pragma once
+#include <Arduino.h>
+struct JsonVariant { JsonVariant operator[](const char*) const {return {};} JsonVariant operator[](const String&) const {return {};} JsonVariant operator[](int) const {return {};}
+ String operator|(const char*d) const {return String(d);} int operator|(int d) const {return d;} long operator|(long d) const {return d;} unsigned operator|(unsigned d) const {return d;} float operator|(float d) const {return d;} bool operator|(bool d) const {return d;} unsigned long operator|(unsigned long d) const {return d;}
+ template<class T> T as() const {return T();} template<class T> bool is() const {return false;} bool isNull() const {return true;} template<class T> JsonVariant& operator=(const T&){return *this;} size_t size() const {return 0;}};
+struct JsonArray { JsonVariant *begin() const {return nullptr;} JsonVariant *end() const {return nullptr;} };
+struct JsonDocument : JsonVariant {};
+struct DeserializationError { operator bool() const {return false;} const char* c_str() const {return "";} };
+template<class T> DeserializationError deserializeJson(JsonDocument&, const T&){return {};}
+template<class T> size_t serializeJson(const JsonDocument&, T&){return 0;}
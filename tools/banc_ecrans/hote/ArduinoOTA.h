@@ -0,0 +1,5 @@
+#pragma once
+#include <Arduino.h>
+#include <functional>
+class ArduinoOTAClass { public: void begin(){} void handle(){} ArduinoOTAClass& onStart(std::function<void()>){return *this;} ArduinoOTAClass& onEnd(std::function<void()>){return *this;} void setHostname(const char*){} };
+extern ArduinoOTAClass ArduinoOTA;
@@ -0,0 +1,10 @@
+#pragma once
+#include <OneWire.h>
+#define DEVICE_DISCONNECTED_C -127
+#define DEVICE_DISCONNECTED_RAW -7040
+typedef uint8_t DeviceAddress[8];
+class DallasTemperature { public: DallasTemperature(OneWire*){} void begin(){} void setResolution(uint8_t){} bool setResolution(const uint8_t*,uint8_t,bool=false){return true;} uint8_t getResolution(){return 12;} void setWaitForConversion(bool){}
+ struct request_t { bool result; unsigned long timestamp; operator bool(){return result;} };
+ request_t requestTemperatures(){return {true,0};} float getTempCByIndex(uint8_t){return 0;} int32_t getTemp(const uint8_t*){return 0;} bool getAddress(uint8_t*,uint8_t){return true;} bool isConversionComplete(){return true;} int16_t millisToWaitForConversion(uint8_t){return 750;} int16_t millisToWaitForConversion(){return 750;} static float rawToCelsius(int32_t r){return r*0.0078125f;}
+ void setCheckForConversion(bool){} void setAutoSaveScratchPad(bool){}
+};
@@ -0,0 +1,4 @@
+#pragma once
+#include <WiFi.h>
+#define HTTP_CODE_OK 200
+class HTTPClient { public: bool begin(WiFiClient&,const String&){return true;} bool begin(const String&){return true;} int GET(){return 0;} int POST(const String&){return 0;} int POST(uint8_t*,size_t){return 0;} String getString(){return String();} void end(){} void useHTTP10(bool){} int getSize(){return 0;} WiFiClient* getStreamPtr(){return nullptr;} WiFiClient& getStream(){static WiFiClient c; return c;} void addHeader(const String&,const String&){} void setTimeout(uint16_t){} void setConnectTimeout(int32_t){} void setReuse(bool){} };
@@ -0,0 +1,5 @@
+#pragma once
+#include <HTTPClient.h>
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+class UpdateClass { public: bool begin(size_t){return true;} bool setMD5(const char*){return true;} void abort(){} size_t writeStream(Stream&){return 0;} size_t write(uint8_t*,size_t n){return n;} bool end(bool=false){return true;} const char* errorString(){return "";} String md5String(){return String();} bool hasError(){return false;} };
+extern UpdateClass Update;
@@ -0,0 +1,3 @@
+#pragma once
+#include <Arduino.h>
+class OneWire { public: OneWire(int){} };
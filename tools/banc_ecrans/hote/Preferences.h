@@ -0,0 +1,8 @@
+#pragma once
+#include <Arduino.h>
+class Preferences { public: bool begin(const char*,bool=false){return true;} void end(){}
+ int32_t getInt(const char*,int32_t d=0){return d;} float getFloat(const char*,float d=0){return d;} bool getBool(const char*,bool d=false){return d;} String getString(const char*,String d=String()){return d;}
+ int16_t getShort(const char*,int16_t d=0){return d;} uint32_t getUInt(const char*,uint32_t d=0){return d;} uint64_t getULong64(const char*,uint64_t d=0){return d;} uint16_t getUShort(const char*,uint16_t d=0){return d;}
+ size_t getBytes(const char*,void*,size_t){return 0;} size_t getBytesLength(const char*){return 0;} bool isKey(const char*){return false;}
+ size_t putInt(const char*,int32_t){return 4;} size_t putFloat(const char*,float){return 4;} size_t putBool(const char*,bool){return 1;} size_t putString(const char*,const String&){return 1;} size_t putString(const char*,const char*){return 1;}
+ bool clear(){return true;} size_t putShort(const char*,int16_t){return 2;} size_t putUInt(const char*,uint32_t){return 4;} size_t putULong64(const char*,uint64_t){return 8;} size_t putUShort(const char*,uint16_t){return 2;} size_t putBytes(const char*,const void*,size_t n){return n;} bool remove(const char*){return true;}};
@@ -0,0 +1,16 @@
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+#include <time.h>
+class TimeSpan { public: int32_t s; TimeSpan(int32_t v=0):s(v){} TimeSpan(int16_t j,int8_t h,int8_t m,int8_t sec):s(((j*24+h)*60+m)*60+sec){} int32_t totalseconds() const {return s;} };
+// Heure locale naïve en secondes depuis 1970 (comme RTClib sans fuseau)
+class DateTime { uint32_t t; struct tm c; void decompose(){time_t v=t; gmtime_r(&v,&c);}
+ public: DateTime(uint32_t v=0):t(v){decompose();}
+ DateTime(uint16_t a,uint8_t mo,uint8_t j,uint8_t h=0,uint8_t mi=0,uint8_t s=0){struct tm x={}; x.tm_year=a-1900; x.tm_mon=mo-1; x.tm_mday=j; x.tm_hour=h; x.tm_min=mi; x.tm_sec=s; t=(uint32_t)timegm(&x); decompose();}
+ DateTime(const char*,const char*):t(0){decompose();}
+ uint16_t year() const {return c.tm_year+1900;} uint8_t month() const {return c.tm_mon+1;} uint8_t day() const {return c.tm_mday;} uint8_t hour() const {return c.tm_hour;} uint8_t minute() const {return c.tm_min;} uint8_t second() const {return c.tm_sec;} uint32_t unixtime() const {return t;} uint8_t dayOfTheWeek() const {return c.tm_wday;}
+ DateTime operator+(const TimeSpan&d) const {return DateTime(t+d.s);} TimeSpan operator-(const DateTime&o) const {return TimeSpan((int32_t)(t-o.t));} bool isValid() const {return true;}};
+enum Ds3231SqwPinMode { DS3231_OFF=0x1C, DS3231_SquareWave1Hz=0x00 };
+// Le RTC garde l'heure réglée (adjust), sans avancer : le banc fixe l'heure
+class RTC_DS3231 { DateTime t; public: bool begin(TwoWire* =nullptr){return true;} bool lostPower(){return false;} void adjust(const DateTime&d){t=d;} DateTime now(){return t;} void writeSqwPinMode(Ds3231SqwPinMode){} float getTemperature(){return 0;} };
+class TwoWire;
@@ -0,0 +1,50 @@
+// U8g2 sur l'hôte : la partie C de la bibliothèque (src/clib) dessine dans
+// le tampon plein écran, l'envoi à l'afficheur est un rappel vide. Seules
+// les méthodes utilisées par le firmware sont reprises de U8g2lib.h.
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+#include "clib/u8g2.h"
+
+class U8G2 {
+protected:
+  u8g2_t u8g2;
+public:
+  u8g2_t *getU8g2() { return &u8g2; }
+  bool begin() { u8g2_InitDisplay(&u8g2); u8g2_ClearDisplay(&u8g2); u8g2_SetPowerSave(&u8g2, 0); return true; }
+  void setBusClock(uint32_t f) { u8g2.u8x8.bus_clock = f; }
+  void setPowerSave(uint8_t p) { u8g2_SetPowerSave(&u8g2, p); }
+  void clearBuffer() { u8g2_ClearBuffer(&u8g2); }
+  void sendBuffer() { u8g2_SendBuffer(&u8g2); }
+  void updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th) { u8g2_UpdateDisplayArea(&u8g2, tx, ty, tw, th); }
+  uint8_t *getBufferPtr() { return u8g2_GetBufferPtr(&u8g2); }
+  uint8_t getBufferTileWidth() { return u8g2_GetBufferTileWidth(&u8g2); }
+  uint8_t getBufferTileHeight() { return u8g2_GetBufferTileHeight(&u8g2); }
+  void setFont(const uint8_t *f) { u8g2_SetFont(&u8g2, f); }
+  void setDrawColor(uint8_t c) { u8g2_SetDrawColor(&u8g2, c); }
+  void setBitmapMode(uint8_t m) { u8g2_SetBitmapMode(&u8g2, m); }
+  u8g2_uint_t drawStr(u8g2_uint_t x, u8g2_uint_t y, const char *s) { return u8g2_DrawStr(&u8g2, x, y, s); }
+  u8g2_uint_t drawGlyph(u8g2_uint_t x, u8g2_uint_t y, uint16_t g) { return u8g2_DrawGlyph(&u8g2, x, y, g); }
+  u8g2_uint_t getStrWidth(const char *s) { return u8g2_GetStrWidth(&u8g2, s); }
+  void drawBox(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h) { u8g2_DrawBox(&u8g2, x, y, w, h); }
+  void drawHLine(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w) { u8g2_DrawHLine(&u8g2, x, y, w); }
+  void drawVLine(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t h) { u8g2_DrawVLine(&u8g2, x, y, h); }
+  void drawPixel(u8g2_uint_t x, u8g2_uint_t y) { u8g2_DrawPixel(&u8g2, x, y); }
+  void drawXBMP(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h, const uint8_t *b) { u8g2_DrawXBMP(&u8g2, x, y, w, h, b); }
+};
+
+class U8G2_SH1106_128X64_NONAME_F_HW_I2C : public U8G2 {
+public:
+  U8G2_SH1106_128X64_NONAME_F_HW_I2C(const u8g2_cb_t *rotation, uint8_t reset = U8X8_PIN_NONE) {
+    (void)reset;
+    u8g2_Setup_sh1106_i2c_128x64_noname_f(&u8g2, rotation, u8x8_byte_empty, u8x8_dummy_cb);
+  }
+};
+
+class U8G2_SSD1306_128X64_NONAME_F_HW_I2C : public U8G2 {
+public:
+  U8G2_SSD1306_128X64_NONAME_F_HW_I2C(const u8g2_cb_t *rotation, uint8_t reset = U8X8_PIN_NONE) {
+    (void)reset;
+    u8g2_Setup_ssd1306_i2c_128x64_noname_f(&u8g2, rotation, u8x8_byte_empty, u8x8_dummy_cb);
+  }
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#define WL_CONNECTED 3
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+typedef enum { WIFI_AUTH_OPEN = 0, WIFI_AUTH_WEP, WIFI_AUTH_WPA_PSK, WIFI_AUTH_WPA2_PSK } wifi_auth_mode_t;
+typedef int wl_status_t;
+enum wifi_ps_type_t { WIFI_PS_NONE, WIFI_PS_MIN_MODEM, WIFI_PS_MAX_MODEM };
+enum WiFiEvent_t { ARDUINO_EVENT_WIFI_STA_GOT_IP, ARDUINO_EVENT_WIFI_STA_DISCONNECTED };
+class Client : public Stream { public: virtual int connect(const char*,uint16_t){return 0;} virtual void stop(){} virtual uint8_t connected(){return 0;} operator bool(){return true;} int read(uint8_t*,size_t){return 0;} using Stream::read; size_t write(uint8_t){return 1;} using Print::write;};
+class WiFiClient : public Client { public: void setTimeout(uint32_t){} int connect(IPAddress,uint16_t){return 0;} using Client::connect; void setNoDelay(bool){} IPAddress remoteIP(){return IPAddress();}};
+class WiFiServer { public: WiFiServer(uint16_t){} void begin(){} WiFiClient available(){return WiFiClient();} WiFiClient accept(){return WiFiClient();} void setNoDelay(bool){} };
+class WiFiUDP : public Stream { public: uint8_t begin(uint16_t){return 1;} int beginPacket(IPAddress,uint16_t){return 1;} int beginPacket(const char*,uint16_t){return 1;} int endPacket(){return 1;} size_t write(uint8_t){return 1;} size_t write(const uint8_t*,size_t n){return n;} int parsePacket(){return 0;} int read(uint8_t*,size_t){return 0;} int read(char*,size_t){return 0;} using Stream::read; IPAddress remoteIP(){return IPAddress();} uint16_t remotePort(){return 0;} void stop(){} uint8_t beginMulticast(IPAddress,uint16_t){return 1;} };
+// État réglé par le banc : association et résultat du scan
+class WiFiClass { public: wl_status_t etatHote = 0; long rssiHote = 0; std::vector<String> ssidsHote;
+ wl_status_t begin(const String&,const String&){return etatHote;} wl_status_t status(){return etatHote;} long RSSI(){return rssiHote;} int16_t scanNetworks(bool=false){return (int16_t)ssidsHote.size();} int16_t scanComplete(){return (int16_t)ssidsHote.size();} void scanDelete(){} String SSID(){return String();} String SSID(int i){return i >= 0 && i < (int)ssidsHote.size() ? ssidsHote[i] : String();}
+ int32_t RSSI(int){return 0;} wifi_auth_mode_t encryptionType(int){return WIFI_AUTH_OPEN;} IPAddress localIP(){return IPAddress();} IPAddress broadcastIP(){return IPAddress();} IPAddress subnetMask(){return IPAddress();} IPAddress gatewayIP(){return IPAddress();} String macAddress(){return String();} void macAddress(uint8_t*){} bool setSleep(bool){return true;} bool setSleep(wifi_ps_type_t){return true;} bool disconnect(bool=false){return true;} bool mode(int){return true;} bool setAutoReconnect(bool){return true;} bool isConnected(){return false;}
+ int onEvent(std::function<void(WiFiEvent_t)>){return 0;} void setHostname(const char*){} String getHostname(){return String();} };
+#define WIFI_STA 1
+extern WiFiClass WiFi;
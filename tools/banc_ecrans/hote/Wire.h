@@ -0,0 +1,5 @@
+#pragma once
+#include <Arduino.h>
+class TwoWire : public Stream { public: bool begin(int=-1,int=-1,uint32_t=0){return true;} void setClock(uint32_t){} uint32_t getClock(){return 0;} void end(){}
+ void beginTransmission(uint8_t){} uint8_t endTransmission(bool=true){return 0;} uint8_t requestFrom(uint8_t,uint8_t){return 0;} void setTimeOut(uint16_t){} uint16_t getTimeOut(){return 0;} size_t write(uint8_t){return 1;} using Print::write;};
+extern TwoWire Wire;
@@ -0,0 +1,6 @@
+#pragma once
+typedef int gpio_num_t; typedef int esp_err_t;
+enum { GPIO_INTR_DISABLE, GPIO_INTR_POSEDGE, GPIO_INTR_NEGEDGE, GPIO_INTR_ANYEDGE, GPIO_INTR_LOW_LEVEL, GPIO_INTR_HIGH_LEVEL };
+typedef int gpio_int_type_t;
+esp_err_t gpio_wakeup_enable(gpio_num_t, gpio_int_type_t); esp_err_t gpio_wakeup_disable(gpio_num_t); esp_err_t gpio_set_intr_type(gpio_num_t, gpio_int_type_t);
+int gpio_get_level(gpio_num_t); esp_err_t gpio_set_level(gpio_num_t, uint32_t); esp_err_t gpio_hold_en(gpio_num_t);
@@ -0,0 +1,4 @@
+#pragma once
+#ifndef RTC_NOINIT_ATTR
+#define RTC_NOINIT_ATTR
+#endif
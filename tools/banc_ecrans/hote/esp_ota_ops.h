@@ -0,0 +1,4 @@
+#pragma once
+#include "esp_partition.h"
+const esp_partition_t *esp_ota_get_running_partition(void);
+const esp_partition_t *esp_ota_get_boot_partition(void);
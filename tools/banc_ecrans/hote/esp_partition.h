@@ -0,0 +1,6 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+typedef int esp_err_t;
+typedef struct { uint32_t address; uint32_t size; } esp_partition_t;
+esp_err_t esp_partition_read(const esp_partition_t*, size_t, void*, size_t);
@@ -0,0 +1,9 @@
+#pragma once
+typedef int esp_err_t;
+typedef struct { int max_freq_mhz; int min_freq_mhz; bool light_sleep_enable; } esp_pm_config_esp32c3_t;
+esp_err_t esp_pm_configure(const void*);
+typedef void* esp_pm_lock_handle_t;
+typedef enum { ESP_PM_CPU_FREQ_MAX, ESP_PM_APB_FREQ_MAX, ESP_PM_NO_LIGHT_SLEEP } esp_pm_lock_type_t;
+esp_err_t esp_pm_lock_create(esp_pm_lock_type_t, int, const char*, esp_pm_lock_handle_t*);
+esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t);
+esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t);
@@ -0,0 +1,8 @@
+#pragma once
+#include <esp_idf_version.h>
+typedef int esp_err_t;
+typedef struct { uint32_t timeout_ms; uint32_t idle_core_mask; bool trigger_panic; } esp_task_wdt_config_t;
+esp_err_t esp_task_wdt_init(uint32_t, bool);
+esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t*);
+esp_err_t esp_task_wdt_add(TaskHandle_t);
+esp_err_t esp_task_wdt_reset();
@@ -0,0 +1,118 @@
+// Définitions de l'environnement hôte du banc d'écrans : temps simulé,
+// FreeRTOS et ESP-IDF réduits à des appels sans effet (aucune tâche ne
+// tourne), objets globaux du cœur Arduino.
+#include <Arduino.h>
+#include <Wire.h>
+#include <WiFi.h>
+#include <ArduinoOTA.h>
+#include <HTTPUpdate.h>
+#include <esp_timer.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <esp_sntp.h>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+#include <esp_partition.h>
+#include <esp_ota_ops.h>
+#include <mdns.h>
+#include <driver/gpio.h>
+#include <mbedtls/sha256.h>
+
+int64_t hoteMicros = 0;
+
+HardwareSerial Serial;
+EspClass ESP;
+TwoWire Wire;
+WiFiClass WiFi;
+ArduinoOTAClass ArduinoOTA;
+UpdateClass Update;
+
+// Temps
+unsigned long millis() { return (unsigned long)(hoteMicros / 1000); }
+unsigned long micros() { return (unsigned long)hoteMicros; }
+int64_t esp_timer_get_time() { return hoteMicros; }
+void delay(unsigned long ms) { hoteMicros += (int64_t)ms * 1000; }
+void delayMicroseconds(unsigned us) { hoteMicros += us; }
+unsigned sleep(unsigned s) { delay(s * 1000UL); return 0; }
+void yield() {}
+long random(long max) { return max > 0 ? rand() % max : 0; }
+long random(long min, long max) { return max > min ? min + rand() % (max - min) : min; }
+void configTzTime(const char*, const char*, const char*, const char*) {}
+bool getLocalTime(struct tm*, uint32_t) { return false; }
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t) {}
+
+// Broches : entrées au repos (boutons relâchés, tirage haut)
+void pinMode(int, int) {}
+void digitalWrite(int, int) {}
+int digitalRead(int) { return HIGH; }
+void attachInterrupt(int, void(*)(), int) {}
+void attachInterruptArg(uint8_t, void(*)(void*), void*, int) {}
+int digitalPinToInterrupt(int pin) { return pin; }
+void detachInterrupt(int) {}
+esp_err_t gpio_wakeup_enable(gpio_num_t, gpio_int_type_t) { return ESP_OK; }
+esp_err_t gpio_wakeup_disable(gpio_num_t) { return ESP_OK; }
+esp_err_t gpio_set_intr_type(gpio_num_t, gpio_int_type_t) { return ESP_OK; }
+int gpio_get_level(gpio_num_t) { return 1; }
+esp_err_t gpio_set_level(gpio_num_t, uint32_t) { return ESP_OK; }
+esp_err_t gpio_hold_en(gpio_num_t) { return ESP_OK; }
+
+// FreeRTOS : files toujours vides (une attente bornée dure tout son délai),
+// sémaphores toujours libres
+static BaseType_t fileVide(TickType_t t) { if (t != portMAX_DELAY) delay(t); return pdFALSE; }
+QueueHandle_t xQueueCreate(UBaseType_t, UBaseType_t) { static int file; return &file; }
+BaseType_t xQueueSend(QueueHandle_t, const void*, TickType_t) { return pdTRUE; }
+BaseType_t xQueueSendFromISR(QueueHandle_t, const void*, BaseType_t*) { return pdTRUE; }
+BaseType_t xQueueReceive(QueueHandle_t, void*, TickType_t t) { return fileVide(t); }
+BaseType_t xQueuePeek(QueueHandle_t, void*, TickType_t t) { return fileVide(t); }
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t) { return 0; }
+BaseType_t xTaskCreate(void(*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*) { return pdPASS; }
+BaseType_t xTaskCreatePinnedToCore(void(*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*, int) { return pdPASS; }
+void vTaskDelay(TickType_t t) { delay(t); }
+void vTaskDelayUntil(TickType_t*, TickType_t t) { delay(t); }
+TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+void vTaskSuspendAll() {}
+BaseType_t xTaskResumeAll() { return pdFALSE; }
+SemaphoreHandle_t xSemaphoreCreateMutex() { static int mutex; return &mutex; }
+SemaphoreHandle_t xSemaphoreCreateBinary() { static int binaire; return &binaire; }
+BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t, BaseType_t*) { return pdTRUE; }
+esp_err_t esp_task_wdt_init(uint32_t, bool) { return ESP_OK; }
+esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t*) { return ESP_OK; }
+esp_err_t esp_task_wdt_add(TaskHandle_t) { return ESP_OK; }
+esp_err_t esp_task_wdt_reset() { return ESP_OK; }
+
+// Énergie et démarrage
+esp_err_t esp_pm_configure(const void*) { return ESP_OK; }
+esp_err_t esp_pm_lock_create(esp_pm_lock_type_t, int, const char*, esp_pm_lock_handle_t *h) { *h = nullptr; return ESP_OK; }
+esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t) { return ESP_OK; }
+esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t) { return ESP_OK; }
+// Sommeil léger : jusqu'au réveil par la minuterie, aucun bouton n'est appuyé
+static uint64_t reveilUs = 0;
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t us) { reveilUs = us; return ESP_OK; }
+esp_err_t esp_sleep_enable_gpio_wakeup() { return ESP_OK; }
+esp_err_t esp_sleep_enable_wifi_wakeup() { return ESP_OK; }
+esp_err_t esp_light_sleep_start() { hoteMicros += (int64_t)reveilUs; return ESP_OK; }
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() { return ESP_SLEEP_WAKEUP_UNDEFINED; }
+esp_reset_reason_t esp_reset_reason(void) { return ESP_RST_POWERON; }
+const esp_partition_t *esp_ota_get_running_partition(void) { static esp_partition_t p = {0x10000, 0x140000}; return &p; }
+const esp_partition_t *esp_ota_get_boot_partition(void) { return esp_ota_get_running_partition(); }
+esp_err_t esp_partition_read(const esp_partition_t*, size_t, void *d, size_t n) { memset(d, 0xff, n); return ESP_OK; }
+
+// Réseau : pas de pairs
+esp_err_t mdns_service_add(const char*, const char*, const char*, uint16_t, mdns_txt_item_t*, size_t) { return ESP_OK; }
+esp_err_t mdns_service_txt_item_set(const char*, const char*, const char*, const char*) { return ESP_OK; }
+mdns_search_once_t *mdns_query_async_new(const char*, const char*, const char*, uint16_t, uint32_t, size_t) { return nullptr; }
+bool mdns_query_async_get_results(mdns_search_once_t*, uint32_t, mdns_result_t **r) { *r = nullptr; return true; }
+void mdns_query_async_delete(mdns_search_once_t*) {}
+void mdns_query_results_free(mdns_result_t*) {}
+
+// Empreintes : inutilisées par les écrans
+void mbedtls_sha256_init(mbedtls_sha256_context*) {}
+void mbedtls_sha256_free(mbedtls_sha256_context*) {}
+int mbedtls_sha256_starts_ret(mbedtls_sha256_context*, int) { return 0; }
+int mbedtls_sha256_update_ret(mbedtls_sha256_context*, const unsigned char*, size_t) { return 0; }
+int mbedtls_sha256_finish_ret(mbedtls_sha256_context*, unsigned char *s) { memset(s, 0, 32); return 0; }
+int mbedtls_sha256_starts(mbedtls_sha256_context*, int) { return 0; }
+int mbedtls_sha256_update(mbedtls_sha256_context*, const unsigned char*, size_t) { return 0; }
+int mbedtls_sha256_finish(mbedtls_sha256_context*, unsigned char *s) { memset(s, 0, 32); return 0; }
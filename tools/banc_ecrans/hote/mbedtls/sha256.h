@@ -0,0 +1,5 @@
+#pragma once
+typedef struct { int x; } mbedtls_sha256_context;
+void mbedtls_sha256_init(mbedtls_sha256_context*); void mbedtls_sha256_free(mbedtls_sha256_context*);
+int mbedtls_sha256_starts_ret(mbedtls_sha256_context*, int); int mbedtls_sha256_update_ret(mbedtls_sha256_context*, const unsigned char*, size_t); int mbedtls_sha256_finish_ret(mbedtls_sha256_context*, unsigned char*);
+int mbedtls_sha256_starts(mbedtls_sha256_context*, int); int mbedtls_sha256_update(mbedtls_sha256_context*, const unsigned char*, size_t); int mbedtls_sha256_finish(mbedtls_sha256_context*, unsigned char*);
@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_idf_version.h"
+typedef int esp_err_t;
+#define ESP_OK 0
+#define MDNS_TYPE_PTR 0x000C
+typedef struct { const char *key; const char *value; } mdns_txt_item_t;
+typedef struct { uint32_t addr; } esp_ip4_addr_t;
+typedef struct { union { esp_ip4_addr_t ip4; } u_addr; uint8_t type; } esp_ip_addr_t;
+typedef struct mdns_ip_addr_s { esp_ip_addr_t addr; struct mdns_ip_addr_s *next; } mdns_ip_addr_t;
+typedef struct mdns_result_s { struct mdns_result_s *next; char *instance_name; char *service_type; char *proto; char *hostname; uint16_t port; mdns_txt_item_t *txt; uint8_t *txt_value_len; size_t txt_count; mdns_ip_addr_t *addr; } mdns_result_t;
+typedef struct mdns_search_once_s mdns_search_once_t;
+esp_err_t mdns_service_add(const char*, const char*, const char*, uint16_t, mdns_txt_item_t*, size_t);
+esp_err_t mdns_service_txt_item_set(const char*, const char*, const char*, const char*);
+mdns_search_once_t *mdns_query_async_new(const char*, const char*, const char*, uint16_t, uint32_t, size_t);
+bool mdns_query_async_get_results(mdns_search_once_t*, uint32_t, mdns_result_t**);
+void mdns_query_async_delete(mdns_search_once_t*);
+void mdns_query_results_free(mdns_result_t*);
@@ -0,0 +1,2 @@
+#pragma once
+#define CONFIG_PM_ENABLE 1
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Cache local des images firmware (include/pairs.h).
+
+Télécharge une seule fois le manifeste et l'image d'une version depuis
+l'origine, vérifie MD5 (et SHA-256 s'il est publié) puis la sert en HTTP
+sur le réseau local, comme un appareil : GET /firmware-<version>.bin.
+Avec le module zeroconf, le cache s'annonce en _tapisfw._tcp (role=cache)
+et les appareils le préfèrent à leurs pairs ; sans zeroconf, il sert
+l'image sans être découvert.
+
+Exemples :
+  tools/cache_firmware.py                      # dernière version (latest)
+  tools/cache_firmware.py --canal stable --port 8080
+  tools/cache_firmware.py --image release/firmware-0.2.1.bin --version 0.2.1
+"""
+
+import argparse
+import hashlib
+import http.server
+import json
+import socket
+import sys
+import urllib.request
+
+MANIFESTE = ("https://raw.githubusercontent.com/djfab59/ESP32-C3-Tapis-Chauffant/"
+             "refs/heads/master/release/")
+SERVICE = "_tapisfw._tcp.local."
+
+
+def telecharge(url):
+    with urllib.request.urlopen(url, timeout=60) as r:
+        return r.read()
+
+
+def verifie(image, entree):
+    md5 = hashlib.md5(image).hexdigest()
+    if entree.get("md5") and md5 != entree["md5"].lower():
+        raise SystemExit("MD5 different du manifeste : %s" % md5)
+    sha = entree.get("sha256", "")
+    if sha and hashlib.sha256(image).hexdigest() != sha.lower():
+        raise SystemExit("SHA-256 different du manifeste")
+    return md5
+
+
+def annonce(version, md5, port):
+    """Annonce zeroconf ; None si le module n'est pas installé."""
+    try:
+        from zeroconf import ServiceInfo, Zeroconf
+    except ImportError:
+        print("zeroconf absent : pas d'annonce mDNS", file=sys.stderr)
+        return None
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.connect(("192.0.2.1", 9))          # adresse locale de la route par défaut
+    ip = s.getsockname()[0]
+    s.close()
+    info = ServiceInfo(SERVICE, "cache-%s.%s" % (socket.gethostname(), SERVICE),
+                       addresses=[socket.inet_aton(ip)], port=port,
+                       properties={"v": version, "md5": md5, "id": "ffffffff",
+                                   "role": "cache", "etat": ""})
+    zc = Zeroconf()
+    zc.register_service(info)
+    print("annonce %s sur %s:%d" % (SERVICE, ip, port))
+    return zc, info
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("--manifeste", default=MANIFESTE, help="URL du dossier release/")
+    ap.add_argument("--canal", choices=["latest", "stable"], default="latest")
+    ap.add_argument("--version", help="version servie (sinon celle du canal)")
+    ap.add_argument("--image", help="image locale au lieu de l'origine")
+    ap.add_argument("--port", type=int, default=8080)
+    args = ap.parse_args()
+
+    manifeste = json.loads(telecharge(args.manifeste + "version.json"))
+    version = args.version or manifeste[args.canal]
+    entree = manifeste["firmwares"][version]
+    if args.image:
+        with open(args.image, "rb") as f:
+            image = f.read()
+    else:
+        image = telecharge(args.manifeste + "firmware-%s.bin" % version)
+    md5 = verifie(image, entree)
+    print("version %s : %d octets, md5 %s" % (version, len(image), md5))
+
+    chemin = "/firmware-%s.bin" % version
+
+    class Gestion(http.server.BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.0"
+
+        def do_GET(self):
+            if self.path != chemin:
+                self.send_error(404)
+                return
+            self.send_response(200)
+            self.send_header("Content-Type", "application/octet-stream")
+            self.send_header("Content-Length", str(len(image)))
+            self.end_headers()
+            self.wfile.write(image)
+
+        def log_message(self, fmt, *a):
+            print("%s %s" % (self.client_address[0], fmt % a))
+
+    zc = annonce(version, md5, args.port)
+    serveur = http.server.ThreadingHTTPServer(("", args.port), Gestion)
+    try:
+        serveur.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if zc:
+            zc[0].unregister_service(zc[1])
+            zc[0].close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""Décodeur de la télémétrie binaire (include/telemetrie.h).
+
+Lit un flux série en direct (pyserial) ou une capture brute, découpe les
+trames COBS sur l'octet nul, vérifie le CRC-16/CCITT-FALSE et écrit :
+  --csv FICHIER        une ligne par trame ;
+  --colonnes DOSSIER   un fichier binaire petit-boutiste par colonne
+                       (numpy.fromfile(chemin, dtype)) et schema.json ;
+  --parquet FICHIER    si pyarrow est installé.
+Les lignes de log texte qui partagent le port sont écartées (ou affichées
+sur stderr avec --texte).
+
+Exemples :
+  tools/decode_telemetrie.py --port /dev/ttyACM0 --envoie "telemetrie 50" --csv trace.csv
+  tools/decode_telemetrie.py --capture trace.bin --colonnes trace/
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+TYPE_TELEMETRIE = 1
+FORMAT = "<BIhhhBbBIH"
+TAILLE = struct.calcsize(FORMAT)   # 20 octets
+
+# Colonnes : nom, type numpy, conversion depuis la trame décodée
+DEFAUTS = ["aucun", "mesure perimee", "surchauffe", "marche continue max"]
+COLONNES = [
+    ("ms",         "<u4", lambda t: t["ms"]),
+    ("raw",        "<i2", lambda t: t["raw"]),
+    ("temp_c",     "<f4", lambda t: t["temp"] / 100.0),
+    ("cible_c",    "<f4", lambda t: t["cible"] / 100.0),
+    ("relais",     "u1",  lambda t: t["etat"] & 0x01),
+    ("demande",    "u1",  lambda t: (t["etat"] >> 1) & 1),
+    ("manuel",     "u1",  lambda t: (t["etat"] >> 2) & 1),
+    ("ecran",      "u1",  lambda t: (t["etat"] >> 3) & 1),
+    ("defaut",     "u1",  lambda t: (t["etat"] >> 4) & 7),
+    ("wifi",       "u1",  lambda t: (t["etat"] >> 7) & 1),
+    ("rssi",       "i1",  lambda t: t["rssi"]),
+    ("resolution", "u1",  lambda t: t["resolution"]),
+    ("boucle_us",  "<u4", lambda t: t["boucleUs"]),
+]
+
+
+def crc16_ccitt(donnees):
+    crc = 0xFFFF
+    for o in donnees:
+        crc ^= o << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_decode(bloc):
+    """Décodage COBS ; None si le bloc n'est pas du COBS valide."""
+    res = bytearray()
+    i = 0
+    while i < len(bloc):
+        code = bloc[i]
+        if code == 0 or i + code > len(bloc):
+            return None
+        res += bloc[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(bloc):
+            res.append(0)
+    return bytes(res)
+
+
+def decode_trame(bloc):
+    brut = cobs_decode(bloc)
+    if brut is None or len(brut) != TAILLE or brut[0] != TYPE_TELEMETRIE:
+        return None
+    champs = struct.unpack(FORMAT, brut)
+    if crc16_ccitt(brut[:-2]) != champs[-1]:
+        return None
+    noms = ("type", "ms", "raw", "temp", "cible", "etat", "rssi", "resolution", "boucleUs", "crc")
+    return dict(zip(noms, champs))
+
+
+class Decodeur:
+    def __init__(self, texte=False):
+        self.tampon = bytearray()
+        self.trames = []
+        self.rejets = 0
+        self.texte = texte
+
+    def ajoute(self, donnees):
+        self.tampon += donnees
+        while True:
+            fin = self.tampon.find(b"\0")
+            if fin < 0:
+                return
+            bloc = bytes(self.tampon[:fin])
+            del self.tampon[:fin + 1]
+            if not bloc:
+                continue
+            # Une ligne de log peut précéder la trame dans le même bloc :
+            # on essaie les suffixes plausibles (trame COBS = TAILLE + 1 octets)
+            t = decode_trame(bloc[-(TAILLE + 1):])
+            if t is not None:
+                self.trames.append(t)
+                reste = bloc[:-(TAILLE + 1)]
+            else:
+                reste = bloc
+            if reste:
+                if self.texte:
+                    sys.stderr.write(reste.decode("utf-8", "replace"))
+                elif t is None:
+                    self.rejets += 1
+
+
+def ecrit_csv(chemin, trames):
+    with open(chemin, "w") as f:
+        f.write(",".join(nom for nom, _, _ in COLONNES) + "\n")
+        for t in trames:
+            valeurs = []
+            for nom, _, conv in COLONNES:
+                v = conv(t)
+                valeurs.append("%.2f" % v if isinstance(v, float) else str(v))
+            f.write(",".join(valeurs) + "\n")
+
+
+def ecrit_colonnes(dossier, trames):
+    os.makedirs(dossier, exist_ok=True)
+    codes = {"<u4": "I", "<i2": "h", "<f4": "f", "u1": "B", "i1": "b"}
+    schema = {"lignes": len(trames), "colonnes": []}
+    for nom, dtype, conv in COLONNES:
+        with open(os.path.join(dossier, nom + ".bin"), "wb") as f:
+            f.write(struct.pack("<%d%s" % (len(trames), codes[dtype]), *[conv(t) for t in trames]))
+        schema["colonnes"].append({"nom": nom, "dtype": dtype, "fichier": nom + ".bin"})
+    schema["defauts"] = DEFAUTS
+    with open(os.path.join(dossier, "schema.json"), "w") as f:
+        json.dump(schema, f, indent=2)
+
+
+def ecrit_parquet(chemin, trames):
+    try:
+        import pyarrow
+        import pyarrow.parquet
+    except ImportError:
+        sys.exit("decode_telemetrie: pyarrow absent, utiliser --colonnes")
+    table = pyarrow.table({nom: [conv(t) for t in trames] for nom, _, conv in COLONNES})
+    pyarrow.parquet.write_table(table, chemin)
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    source = p.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="port série (pyserial)")
+    source.add_argument("--capture", help="capture brute du port série")
+    p.add_argument("--baud", type=int, default=460800)
+    p.add_argument("--duree", type=float, default=0, help="durée de lecture du port (s), 0 = jusqu'à Ctrl-C")
+    p.add_argument("--envoie", action="append", default=[], help="commande envoyée à l'ouverture du port")
+    p.add_argument("--brut", help="copie brute du flux lu sur le port")
+    p.add_argument("--csv")
+    p.add_argument("--colonnes")
+    p.add_argument("--parquet")
+    p.add_argument("--texte", action="store_true", help="affiche les lignes de log sur stderr")
+    args = p.parse_args()
+
+    d = Decodeur(args.texte)
+    if args.capture:
+        with open(args.capture, "rb") as f:
+            d.ajoute(f.read())
+    else:
+        import time
+        import serial
+        copie = open(args.brut, "wb") if args.brut else None
+        with serial.Serial(args.port, args.baud, timeout=0.2) as port:
+            for cmd in args.envoie:
+                port.write((cmd + "\n").encode())
+            debut = time.time()
+            try:
+                while not args.duree or time.time() - debut < args.duree:
+                    donnees = port.read(4096)
+                    if copie:
+                        copie.write(donnees)
+                    d.ajoute(donnees)
+            except KeyboardInterrupt:
+                pass
+        if copie:
+            copie.close()
+
+    if args.csv:
+        ecrit_csv(args.csv, d.trames)
+    if args.colonnes:
+        ecrit_colonnes(args.colonnes, d.trames)
+    if args.parquet:
+        ecrit_parquet(args.parquet, d.trames)
+    sys.stderr.write("%d trames, %d blocs rejetés\n" % (len(d.trames), d.rejets))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,321 @@
+#!/usr/bin/env python3
+"""Serveur de manifeste et collecteur des rapports de déploiement.
+
+Sert release/version.json et les images firmware-*.bin en HTTP, reçoit
+les rapports POST des appareils (include/deploiement.h) et tient, par
+version, le compte des succès, échecs et retours à l'ancienne image. Dès
+que les échecs d'une version dépassent --seuil (après --minimum rapports),
+son entrée "rollout" passe à "halted": true : les appareils qui n'ont pas
+encore pris la version ne la prennent plus. Avec --ecrit, le manifeste
+modifié est réécrit sur disque (à publier ensuite si le parc lit le
+manifeste ailleurs, ce qui est le cas de release/ sur GitHub).
+
+Le mode simulation lance le serveur sur un port local et fait passer un
+parc d'appareils simulés : tirage de chaque appareil contre un manifeste
+de test, part du parc retenue comparée à la marge binomiale, cohortes et
+version minimale, puis arrêt du déploiement sous un taux d'échec donné.
+
+Exemples :
+  tools/deploiement.py serve --port 8266 --ecrit
+  tools/deploiement.py simule --appareils 1000 --pourcentage 10
+  tools/deploiement.py simule --sim-firmware ./sim_deploiement   # même tirage que le firmware ?
+"""
+
+import argparse
+import copy
+import json
+import math
+import os
+import random
+import subprocess
+import sys
+import threading
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+RACINE = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PORT = 8266
+TRANCHES = 10000
+M32 = 0xFFFFFFFF
+
+
+# ---------------------------------------------------------------------------
+# Tirage : même calcul que src/deploiement.cpp
+# ---------------------------------------------------------------------------
+
+def tranche(ident, version):
+    h = 2166136261
+    for o in ("%08x:%s" % (ident, version)).encode():
+        h = ((h ^ o) * 16777619) & M32
+    h ^= h >> 16
+    h = (h * 0x85EBCA6B) & M32
+    h ^= h >> 13
+    h = (h * 0xC2B2AE35) & M32
+    h ^= h >> 16
+    return h % TRANCHES
+
+
+def compare_versions(a, b):
+    def champs(v):
+        res = []
+        for c in v.split("."):
+            chiffres = ""
+            for x in c:
+                if not x.isdigit():
+                    break
+                chiffres += x
+            res.append(int(chiffres or 0))
+            if chiffres != c:
+                break                    # suffixe non numérique : ignoré
+        return res
+    x, y = champs(a), champs(b)
+    n = max(len(x), len(y))
+    x += [0] * (n - len(x))
+    y += [0] * (n - len(y))
+    return (x > y) - (x < y)
+
+
+def tranches_pourcentage(p):
+    if not p > 0:
+        return 0
+    if p >= 100:
+        return TRANCHES
+    return int(p * (TRANCHES // 100) + 0.5)
+
+
+def decide(manifeste, ident, actuelle, cible):
+    """'eligible', 'hors tranche', 'deploiement arrete' ou 'version trop ancienne'."""
+    regle = manifeste.get("rollout", {}).get(cible)
+    if regle is None:
+        return "eligible"
+    if regle.get("halted", False):
+        return "deploiement arrete"
+    mini = regle.get("min_version", "")
+    if mini and compare_versions(actuelle, mini) < 0:
+        return "version trop ancienne"
+    texte = "%08x" % ident
+    for nom in regle.get("cohorts", []):
+        if texte in (m.lower() for m in manifeste.get("cohorts", {}).get(nom, [])):
+            return "eligible"
+    if tranche(ident, cible) < tranches_pourcentage(regle.get("percent", 100)):
+        return "eligible"
+    return "hors tranche"
+
+
+# ---------------------------------------------------------------------------
+# Serveur
+# ---------------------------------------------------------------------------
+
+class Etat:
+    def __init__(self, manifeste, chemin, repertoire, seuil, minimum, ecrit, bavard):
+        self.manifeste = manifeste
+        self.chemin = chemin
+        self.repertoire = repertoire
+        self.seuil = seuil
+        self.minimum = minimum
+        self.ecrit = ecrit
+        self.bavard = bavard
+        self.comptes = {}            # version -> {"ok": n, "failed": n, "rollback": n}
+        self.verrou = threading.Lock()
+
+    def rapport(self, r):
+        with self.verrou:
+            vers = str(r.get("to", ""))
+            resultat = str(r.get("result", ""))
+            c = self.comptes.setdefault(vers, {"ok": 0, "failed": 0, "rollback": 0})
+            if resultat in c:
+                c[resultat] += 1
+            total = sum(c.values())
+            echecs = c["failed"] + c["rollback"]
+            regle = self.manifeste.setdefault("rollout", {}).get(vers)
+            arret = (regle is not None and not regle.get("halted", False) and
+                     total >= self.minimum and echecs > self.seuil * total)
+            if arret:
+                regle["halted"] = True
+                if self.ecrit:
+                    with open(self.chemin, "w") as f:
+                        json.dump(self.manifeste, f, indent=2)
+                        f.write("\n")
+            if self.bavard:
+                print("%s %s %s -> %s %s  [%s : %d ok, %d echecs, %d retours]%s" % (
+                    r.get("id", "?"), resultat, r.get("from", "?"), vers, r.get("error", ""),
+                    vers, c["ok"], c["failed"], c["rollback"],
+                    "  DEPLOIEMENT ARRETE" if arret else ""))
+            return arret
+
+
+def gestionnaire(etat):
+    class Gestionnaire(BaseHTTPRequestHandler):
+        def log_message(self, *args):
+            pass
+
+        def repond(self, code, corps=b"", type_="application/json"):
+            self.send_response(code)
+            self.send_header("Content-Type", type_)
+            self.send_header("Content-Length", str(len(corps)))
+            self.end_headers()
+            self.wfile.write(corps)
+
+        def do_GET(self):
+            chemin = self.path.split("?")[0].rsplit("/", 1)[-1]
+            if chemin == "version.json":
+                with etat.verrou:
+                    corps = json.dumps(etat.manifeste).encode()
+                self.repond(200, corps)
+            elif chemin.startswith("firmware-") and chemin.endswith(".bin") and etat.repertoire:
+                fichier = os.path.join(etat.repertoire, chemin)
+                if not os.path.isfile(fichier):
+                    self.repond(404)
+                    return
+                with open(fichier, "rb") as f:
+                    self.repond(200, f.read(), "application/octet-stream")
+            else:
+                self.repond(404)
+
+        def do_POST(self):
+            if not self.path.startswith("/rapport"):
+                self.repond(404)
+                return
+            n = int(self.headers.get("Content-Length", 0))
+            try:
+                r = json.loads(self.rfile.read(n) if n else b"{}")
+            except ValueError:
+                self.repond(400)
+                return
+            etat.rapport(r)
+            self.repond(204)
+    return Gestionnaire
+
+
+def demarre(etat, port):
+    serveur = ThreadingHTTPServer(("", port), gestionnaire(etat))
+    threading.Thread(target=serveur.serve_forever, daemon=True).start()
+    return serveur
+
+
+# ---------------------------------------------------------------------------
+# Simulation
+# ---------------------------------------------------------------------------
+
+def appareil(base, ident, actuelle, echec):
+    """Un appareil : lit le manifeste, décide, « installe » et rapporte."""
+    with urllib.request.urlopen(base + "/version.json", timeout=5) as rep:
+        manifeste = json.load(rep)
+    cible = manifeste["latest"]
+    decision = decide(manifeste, ident, actuelle, cible)
+    if decision != "eligible":
+        return decision
+    resultat = "failed" if echec else "ok"
+    corps = json.dumps({"id": "%08x" % ident, "from": actuelle, "to": cible,
+                        "result": resultat, "error": "SHA256 FAIL" if echec else ""}).encode()
+    req = urllib.request.Request(manifeste["report"], data=corps, method="POST",
+                                 headers={"Content-Type": "application/json"})
+    urllib.request.urlopen(req, timeout=5).close()
+    return decision
+
+
+def simule(args):
+    alea = random.Random(args.graine)
+    ids = alea.sample(range(1 << 32), args.appareils)
+    cohorte = ids[:5]
+    anciens = set(ids[5:5 + args.appareils // 20])      # 5 % du parc sous min_version
+    manifeste_test = {
+        "latest": "0.3.0",
+        "stable": "0.2.1",
+        "cohorts": {"labo": ["%08x" % i for i in cohorte]},
+        "rollout": {"0.3.0": {"percent": args.pourcentage, "cohorts": ["labo"],
+                              "min_version": "0.2.0", "halted": False}},
+        "firmwares": {},
+    }
+    ok = True
+
+    if args.sim_firmware:
+        entree = "".join("%08x\n" % i for i in ids)
+        sortie = subprocess.run([args.sim_firmware, "--tranches", "0.3.0"], input=entree,
+                                capture_output=True, text=True, check=True).stdout.split("\n")
+        differences = sum(1 for i, l in zip(ids, sortie) if int(l.split()[1]) != tranche(i, "0.3.0"))
+        print("tirage firmware / outil : %d differences sur %d" % (differences, len(ids)))
+        ok = differences == 0
+
+    # 1. Sans échec : part du parc retenue
+    etat = Etat(copy.deepcopy(manifeste_test), None, None, 1.0, 1, False, False)
+    serveur = demarre(etat, 0)
+    base = "http://127.0.0.1:%d" % serveur.server_address[1]
+    etat.manifeste["report"] = base + "/rapport"
+    decisions = {}
+    for i in ids:
+        d = appareil(base, i, "0.1.5" if i in anciens else "0.2.1", False)
+        decisions[d] = decisions.get(d, 0) + 1
+    serveur.shutdown()
+    soumis = args.appareils - len(cohorte) - len(anciens)
+    p = args.pourcentage / 100
+    attendu = soumis * p + len(cohorte)
+    marge = 4 * math.sqrt(soumis * p * (1 - p))
+    retenus = decisions.get("eligible", 0)
+    dedans = abs(retenus - attendu) <= marge
+    print("%d appareils, %g %% : %d retenus (attendu %.0f +- %.0f), %d hors tranche, "
+          "%d trop anciens  %s" % (args.appareils, args.pourcentage, retenus, attendu, marge,
+                                   decisions.get("hors tranche", 0),
+                                   decisions.get("version trop ancienne", 0),
+                                   "ok" if dedans else "ECHEC"))
+    ok = ok and dedans and decisions.get("version trop ancienne", 0) == len(anciens)
+
+    # 2. Image défectueuse : le déploiement s'arrête après une fraction du parc
+    etat = Etat(copy.deepcopy(manifeste_test), None, None, args.seuil, args.minimum, False, False)
+    serveur = demarre(etat, 0)
+    base = "http://127.0.0.1:%d" % serveur.server_address[1]
+    etat.manifeste["report"] = base + "/rapport"
+    tentatives = 0
+    for i in ids:
+        if appareil(base, i, "0.2.1", alea.random() < args.echecs) == "eligible":
+            tentatives += 1
+    serveur.shutdown()
+    arrete = etat.manifeste["rollout"]["0.3.0"]["halted"]
+    # Arrêt attendu dès que l'échantillon suffit : une poignée de rapports
+    # au-delà de --minimum, loin de la tranche entière
+    borne = 4 * args.minimum
+    print("image defectueuse (%.0f %% d'echecs) : arret %s apres %d installations sur %d "
+          "appareils (borne %d)  %s" % (args.echecs * 100, "oui" if arrete else "non", tentatives,
+                                        args.appareils, borne,
+                                        "ok" if arrete and tentatives <= borne else "ECHEC"))
+    ok = ok and arrete and tentatives <= borne
+    print("OK" if ok else "ECHEC")
+    return 0 if ok else 1
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    sous = ap.add_subparsers(dest="mode", required=True)
+    s = sous.add_parser("serve", help="sert le manifeste et collecte les rapports")
+    s.add_argument("--port", type=int, default=PORT)
+    s.add_argument("--manifeste", default=os.path.join(RACINE, "release", "version.json"))
+    s.add_argument("--ecrit", action="store_true", help="réécrit le manifeste à l'arrêt d'une version")
+    m = sous.add_parser("simule", help="parc simulé contre un manifeste de test")
+    m.add_argument("--appareils", type=int, default=1000)
+    m.add_argument("--pourcentage", type=float, default=10)
+    m.add_argument("--echecs", type=float, default=0.3, help="taux d'échec de l'image défectueuse")
+    m.add_argument("--graine", type=int, default=1)
+    m.add_argument("--sim-firmware", help="tools/sim_deploiement compilé, pour comparer le tirage")
+    for p in (s, m):
+        p.add_argument("--seuil", type=float, default=0.1, help="part d'échecs qui arrête la version")
+        p.add_argument("--minimum", type=int, default=10, help="rapports avant de juger")
+    args = ap.parse_args()
+
+    if args.mode == "simule":
+        sys.exit(simule(args))
+    with open(args.manifeste) as f:
+        manifeste = json.load(f)
+    etat = Etat(manifeste, args.manifeste, os.path.dirname(args.manifeste), args.seuil,
+                args.minimum, args.ecrit, True)
+    serveur = ThreadingHTTPServer(("", args.port), gestionnaire(etat))
+    print("manifeste %s sur le port %d, rapports sur /rapport" % (args.manifeste, args.port))
+    try:
+        serveur.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    for vers, c in sorted(etat.comptes.items()):
+        print("%s : %d ok, %d echecs, %d retours" % (vers, c["ok"], c["failed"], c["rollback"]))
+
+
+if __name__ == "__main__":
+    main()
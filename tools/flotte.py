@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""Agrégateur des balises d'état UDP du parc (include/balise.h).
+
+Écoute les balises diffusées sur le port 4210, garde le dernier état de
+chaque appareil dans une table en colonnes (array, quelques dizaines
+d'octets par appareil : des centaines d'appareils sans effort) et signale :
+  PERIME   aucune balise depuis 3 périodes (ou --perime secondes) ;
+  DEFAUT   défaut du superviseur de sécurité (surchauffe, mesure périmée,
+           marche continue max) ;
+  REDEM    redémarrage constaté (disponibilité en baisse) ;
+  PERTES   balises manquantes d'après les numéros de séquence.
+Avec --sonde, une sonde de découverte est diffusée au démarrage puis
+périodiquement : chaque appareil répond sans attendre sa période.
+
+Exemples :
+  tools/flotte.py --sonde 60
+  tools/flotte.py --sonde 0 --une-fois 5 --json parc.json
+"""
+
+import argparse
+import array
+import json
+import socket
+import struct
+import sys
+import time
+
+PORT = 4210
+TYPE_BALISE = 2
+SONDE = bytes([3])
+FORMAT = "<BBIH3BhhBbIHH"
+TAILLE = struct.calcsize(FORMAT)   # 25 octets
+DEFAUTS = ["", "mesure perimee", "surchauffe", "marche continue max"]
+REDEM_AFFICHE_S = 600              # durée du signalement d'un redémarrage
+
+
+def crc16_ccitt(donnees):
+    crc = 0xFFFF
+    for o in donnees:
+        crc ^= o << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def decode(paquet):
+    """Balise décodée (dict) ou None."""
+    if len(paquet) != TAILLE or paquet[0] != TYPE_BALISE:
+        return None
+    champs = struct.unpack(FORMAT, paquet)
+    if champs[-1] != crc16_ccitt(paquet[:-2]):
+        return None
+    (_, fmt, ident, seq, v0, v1, v2, temp, cible, etat, rssi, dispo, periode, _) = champs
+    if fmt != 1:
+        return None
+    return {"id": ident, "seq": seq, "version": (v0, v1, v2), "temp": temp, "cible": cible,
+            "etat": etat, "rssi": rssi, "dispo": dispo, "periode": periode}
+
+
+class Table:
+    """Dernier état par appareil, une colonne array par champ."""
+
+    COLONNES = [("id", "L"), ("ip", "L"), ("vu", "d"), ("seq", "H"), ("version", "L"),
+                ("temp", "h"), ("cible", "h"), ("etat", "B"), ("rssi", "b"), ("dispo", "L"),
+                ("periode", "H"), ("pertes", "L"), ("redem", "d"), ("balises", "L")]
+
+    def __init__(self):
+        self.col = {nom: array.array(t) for nom, t in self.COLONNES}
+        self.rang = {}
+
+    def __len__(self):
+        return len(self.rang)
+
+    def maj(self, b, ip, maintenant):
+        c = self.col
+        i = self.rang.get(b["id"])
+        if i is None:
+            i = self.rang[b["id"]] = len(self.rang)
+            for nom, _ in self.COLONNES:
+                c[nom].append(0)
+            c["id"][i] = b["id"]
+        else:
+            ecart = (b["seq"] - c["seq"][i]) & 0xFFFF
+            if b["dispo"] < c["dispo"][i]:
+                c["redem"][i] = maintenant
+            elif 1 < ecart < 0x8000:
+                c["pertes"][i] += ecart - 1
+        c["ip"][i] = struct.unpack("!L", socket.inet_aton(ip))[0]
+        c["vu"][i] = maintenant
+        v = b["version"]
+        c["version"][i] = (v[0] << 16) | (v[1] << 8) | v[2]
+        for nom in ("seq", "temp", "cible", "etat", "rssi", "dispo", "periode"):
+            c[nom][i] = b[nom]
+        c["balises"][i] += 1
+
+    def ligne(self, i, maintenant, perime):
+        c = self.col
+        etat = c["etat"][i]
+        periode = c["periode"][i]
+        age = maintenant - c["vu"][i]
+        limite = perime or (3 * periode if periode else 300)
+        alertes = []
+        if age > limite:
+            alertes.append("PERIME")
+        defaut = (etat >> 4) & 7
+        if defaut:
+            alertes.append("DEFAUT " + (DEFAUTS[defaut] if defaut < len(DEFAUTS) else str(defaut)))
+        if c["redem"][i] and maintenant - c["redem"][i] < REDEM_AFFICHE_S:
+            alertes.append("REDEM")
+        if c["pertes"][i]:
+            alertes.append("PERTES %d" % c["pertes"][i])
+        v = c["version"][i]
+        return {
+            "id": "%08x" % c["id"][i],
+            "ip": socket.inet_ntoa(struct.pack("!L", c["ip"][i])),
+            "version": "%d.%d.%d" % (v >> 16, (v >> 8) & 0xFF, v & 0xFF),
+            "temp": c["temp"][i] / 100.0,
+            "cible": c["cible"][i] / 100.0,
+            "relais": etat & 1,
+            "manuel": (etat >> 2) & 1,
+            "rssi": c["rssi"][i],
+            "dispo_s": c["dispo"][i],
+            "age_s": round(age, 1),
+            "alertes": alertes,
+        }
+
+    def lignes(self, maintenant, perime):
+        l = [self.ligne(i, maintenant, perime) for i in range(len(self.rang))]
+        # Appareils en alerte d'abord
+        l.sort(key=lambda r: (not r["alertes"], r["id"]))
+        return l
+
+
+def affiche(table, maintenant, perime, sortie=sys.stdout, efface=False):
+    lignes = table.lignes(maintenant, perime)
+    if efface:
+        sortie.write("\x1b[H\x1b[2J")
+    nb_alerte = sum(1 for r in lignes if r["alertes"])
+    sortie.write("%d appareils, %d en alerte\n" % (len(lignes), nb_alerte))
+    sortie.write("%-8s %-15s %-7s %6s %6s %2s %2s %5s %8s %6s  %s\n" %
+                 ("id", "ip", "version", "temp", "cible", "R", "M", "rssi", "dispo", "age", "alertes"))
+    for r in lignes:
+        sortie.write("%-8s %-15s %-7s %6.2f %6.2f %2d %2d %5d %8d %6.1f  %s\n" %
+                     (r["id"], r["ip"], r["version"], r["temp"], r["cible"], r["relais"],
+                      r["manuel"], r["rssi"], r["dispo_s"], r["age_s"], ", ".join(r["alertes"])))
+    sortie.flush()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("--port", type=int, default=PORT)
+    ap.add_argument("--sonde", type=float, default=0,
+                    help="période des sondes de découverte en s (0 : une seule au démarrage)")
+    ap.add_argument("--diffusion", default="255.255.255.255", help="adresse des sondes")
+    ap.add_argument("--perime", type=float, default=0,
+                    help="délai sans balise avant PERIME (défaut : 3 périodes de l'appareil)")
+    ap.add_argument("--rafraichit", type=float, default=2.0, help="affichage toutes les N s")
+    ap.add_argument("--une-fois", type=float, metavar="S",
+                    help="écoute S secondes, affiche la table et quitte")
+    ap.add_argument("--json", help="écrit la table en JSON à la sortie")
+    args = ap.parse_args()
+
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    s.setsockopt(socket.SOL_SOCKET, socket.SO_BROADCAST, 1)
+    s.bind(("", args.port))
+    s.settimeout(0.2)
+
+    table = Table()
+    debut = time.time()
+    prochaine_sonde = debut
+    prochain_affichage = debut + args.rafraichit
+    rejets = 0
+    try:
+        while True:
+            maintenant = time.time()
+            if prochaine_sonde is not None and maintenant >= prochaine_sonde:
+                try:
+                    s.sendto(SONDE, (args.diffusion, args.port))
+                except OSError as e:
+                    print("sonde: %s" % e, file=sys.stderr)
+                prochaine_sonde = maintenant + args.sonde if args.sonde > 0 else None
+            if args.une_fois is not None:
+                if maintenant - debut >= args.une_fois:
+                    break
+            elif maintenant >= prochain_affichage:
+                affiche(table, maintenant, args.perime, efface=sys.stdout.isatty())
+                prochain_affichage = maintenant + args.rafraichit
+            try:
+                paquet, (ip, _) = s.recvfrom(64)
+            except socket.timeout:
+                continue
+            if paquet == SONDE:
+                continue                     # nos sondes, ou celles d'un autre agrégateur
+            b = decode(paquet)
+            if b is None:
+                rejets += 1
+                continue
+            table.maj(b, ip, time.time())
+    except KeyboardInterrupt:
+        pass
+
+    maintenant = time.time()
+    affiche(table, maintenant, args.perime)
+    if rejets:
+        print("%d paquets rejetés" % rejets, file=sys.stderr)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(table.lignes(maintenant, args.perime), f, indent=1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""Génère include/icones.h : sprites XBM de l'icône WiFi et des flèches.
+
+Les pixels sont calculés avec exactement le même algorithme que l'ancien
+dessin pixel par pixel (drawWiFiArc / drawArrow), en double précision et
+troncature vers l'entier comme en C.
+
+Usage:
+  python3 tools/gen_icones.py           # régénère include/icones.h
+  python3 tools/gen_icones.py --verifie # compare l'en-tête existant au dessin de référence
+"""
+
+import math
+import os
+import re
+import sys
+
+RACINE = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SORTIE = os.path.join(RACINE, "include", "icones.h")
+
+# Position de l'icône sur l'écran d'accueil (drawWiFiIcon(u8g2, 120, 10, rssi))
+WIFI_X, WIFI_Y = 120, 10
+
+
+def trunc(v):
+    return int(v)  # troncature vers zéro, comme la conversion double -> int en C
+
+
+def pixels_wifi(niveau, x=WIFI_X, y=WIFI_Y):
+    """Pixels absolus dessinés par l'ancien drawWiFiIcon pour 0..3 arcs (+ point)."""
+    pts = {(x-1, y-1), (x, y-1), (x-2, y), (x-1, y), (x, y), (x+1, y), (x-1, y+1), (x, y+1)}
+    for r in (4, 7, 10)[:niveau]:
+        for a in range(40, 141):
+            rad = a * 3.14159 / 180.0
+            pts.add((trunc(x + r * math.cos(rad)), trunc(y - r * math.sin(rad))))
+    return pts
+
+
+def pixels_fleche(haut):
+    """Flèche 7x4 de drawArrow, origine en haut à gauche du sprite."""
+    largeurs = (1, 3, 5, 7) if haut else (7, 5, 3, 1)
+    return {(3 + dx, ligne) for ligne, l in enumerate(largeurs) for dx in range(-(l // 2), l // 2 + 1)}
+
+
+def boite(ensembles):
+    xs = [p[0] for e in ensembles for p in e]
+    ys = [p[1] for e in ensembles for p in e]
+    return min(xs), min(ys), max(xs) - min(xs) + 1, max(ys) - min(ys) + 1
+
+
+def xbm(pts, x0, y0, w, h):
+    octets = []
+    for j in range(h):
+        for k in range((w + 7) // 8):
+            b = 0
+            for bit in range(8):
+                if (x0 + k * 8 + bit, y0 + j) in pts:
+                    b |= 1 << bit  # XBM : bit de poids faible = pixel de gauche
+            octets.append(b)
+    return octets
+
+
+def decode(octets, w, h):
+    pts = set()
+    par_ligne = (w + 7) // 8
+    for j in range(h):
+        for i in range(w):
+            if octets[j * par_ligne + i // 8] >> (i % 8) & 1:
+                pts.add((i, j))
+    return pts
+
+
+def tableau(nom, octets):
+    lignes = []
+    for i in range(0, len(octets), 12):
+        lignes.append("  " + ", ".join("0x%02x" % b for b in octets[i:i + 12]))
+    return "static const unsigned char %s[] U8X8_PROGMEM = {\n%s\n};\n" % (nom, ",\n".join(lignes))
+
+
+def sprites():
+    wifi = [pixels_wifi(n) for n in range(4)]
+    x0, y0, w, h = boite(wifi)
+    res = {"wifi": (x0, y0, w, h, [xbm(p, x0, y0, w, h) for p in wifi])}
+    res["flecheHaut"] = (0, 0, 7, 4, [xbm(pixels_fleche(True), 0, 0, 7, 4)])
+    res["flecheBas"] = (0, 0, 7, 4, [xbm(pixels_fleche(False), 0, 0, 7, 4)])
+    return res
+
+
+def genere():
+    s = sprites()
+    x0, y0, w, h, wifi = s["wifi"]
+    out = [
+        "// Sprites XBM précalculés (dessin par drawXBMP)",
+        "// Généré par tools/gen_icones.py : ne pas modifier à la main",
+        "",
+        "#pragma once",
+        "",
+        "#include \"profil.h\"",
+        "",
+        "// Icône WiFi : point + 0 à 3 arcs, origine décalée du centre du point",
+        "// (identique à l'ancien dessin tant que le point est en x >= 8, y >= 10)",
+        "const int WIFI_ICON_W = %d;" % w,
+        "const int WIFI_ICON_H = %d;" % h,
+        "const int WIFI_ICON_DX = %d;" % (x0 - WIFI_X),
+        "const int WIFI_ICON_DY = %d;" % (y0 - WIFI_Y),
+        "",
+    ]
+    for n, octets in enumerate(wifi):
+        out.append(tableau("wifiIcon%d" % n, octets))
+    out.append("static const unsigned char *const wifiIcons[] = { wifiIcon0, wifiIcon1, wifiIcon2, wifiIcon3 };")
+    out.append("")
+    out.append("// Flèches de sélection (7x4)")
+    out.append("const int FLECHE_W = 7;")
+    out.append("const int FLECHE_H = 4;")
+    out.append("")
+    out.append(tableau("flecheHaut", s["flecheHaut"][4][0]))
+    out.append(tableau("flecheBas", s["flecheBas"][4][0]))
+    with open(SORTIE, "w") as f:
+        f.write("\n".join(out))
+    print("écrit", os.path.relpath(SORTIE, RACINE))
+
+
+def verifie():
+    """Compare pixel à pixel les tableaux de include/icones.h au dessin de référence."""
+    texte = open(SORTIE).read()
+    const = {m.group(1): int(m.group(2)) for m in re.finditer(r"const int (\w+) = (-?\d+);", texte)}
+    tabs = {m.group(1): [int(v, 16) for v in re.findall(r"0x[0-9a-f]{2}", m.group(2))]
+            for m in re.finditer(r"unsigned char (\w+)\[\] U8X8_PROGMEM = \{(.*?)\};", texte, re.S)}
+    erreurs = 0
+    w, h = const["WIFI_ICON_W"], const["WIFI_ICON_H"]
+    dx, dy = const["WIFI_ICON_DX"], const["WIFI_ICON_DY"]
+    for n in range(4):
+        attendu = pixels_wifi(n)
+        obtenu = {(WIFI_X + dx + i, WIFI_Y + dy + j) for i, j in decode(tabs["wifiIcon%d" % n], w, h)}
+        if attendu != obtenu:
+            erreurs += 1
+            print("wifiIcon%d: %d pixels différents" % (n, len(attendu ^ obtenu)))
+    for nom, haut in (("flecheHaut", True), ("flecheBas", False)):
+        if decode(tabs[nom], 7, 4) != pixels_fleche(haut):
+            erreurs += 1
+            print("%s: pixels différents" % nom)
+    print("OK" if erreurs == 0 else "%d sprite(s) en erreur" % erreurs)
+    return erreurs
+
+
+if __name__ == "__main__":
+    if "--verifie" in sys.argv:
+        sys.exit(1 if verifie() else 0)
+    genere()
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Génère include/tableau_page.h : page du tableau de bord compressée gzip.
+
+La page web/tableau.html est compressée une fois (gzip -9, sans date dans
+l'en-tête : la sortie ne dépend que de la page) et servie telle quelle par
+le firmware avec Content-Encoding: gzip. L'ETag est tiré du MD5 de la page
+compressée : il change avec elle, le navigateur revalide sinon par un 304.
+
+Usage:
+  python3 tools/gen_tableau.py           # régénère include/tableau_page.h
+  python3 tools/gen_tableau.py --verifie # l'en-tête correspond-il à la page ?
+"""
+
+import gzip
+import hashlib
+import os
+import sys
+
+RACINE = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PAGE = os.path.join(RACINE, "web", "tableau.html")
+SORTIE = os.path.join(RACINE, "include", "tableau_page.h")
+
+
+def genere():
+    with open(PAGE, "rb") as f:
+        page = f.read()
+    gz = gzip.compress(page, compresslevel=9, mtime=0)
+    etag = hashlib.md5(gz).hexdigest()[:12]
+    lignes = []
+    for i in range(0, len(gz), 16):
+        lignes.append("  " + ", ".join("0x%02x" % b for b in gz[i:i + 16]))
+    out = [
+        "// Page du tableau de bord (web/tableau.html), compressée gzip",
+        "// Généré par tools/gen_tableau.py : ne pas modifier à la main",
+        "// %d octets, %d compressés" % (len(page), len(gz)),
+        "",
+        "#pragma once",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "const char TABLEAU_PAGE_ETAG[] = \"\\\"%s\\\"\";" % etag,
+        "const size_t TABLEAU_PAGE_TAILLE = %d;" % len(gz),
+        "static const uint8_t TABLEAU_PAGE_GZ[] PROGMEM = {",
+        ",\n".join(lignes),
+        "};",
+        "",
+    ]
+    return "\n".join(out), len(page), len(gz)
+
+
+if __name__ == "__main__":
+    texte, brut, compresse = genere()
+    if "--verifie" in sys.argv:
+        actuel = open(SORTIE).read() if os.path.exists(SORTIE) else ""
+        if actuel != texte:
+            print("include/tableau_page.h ne correspond pas à web/tableau.html : relancer tools/gen_tableau.py")
+            sys.exit(1)
+        print("OK")
+        sys.exit(0)
+    with open(SORTIE, "w") as f:
+        f.write(texte)
+    print("écrit %s (%d -> %d octets)" % (os.path.relpath(SORTIE, RACINE), brut, compresse))
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Provisionnement WiFi d'appareils branchés en USB (include/improv.h).
+
+Protocole Improv Serial : pour chaque port, demande l'identité de
+l'appareil (nom, version), envoie SSID et mot de passe en un seul paquet
+puis attend le résultat de la connexion d'essai et l'adresse du tableau de
+bord. Les identifiants ne sont sauvegardés par l'appareil que si la
+connexion aboutit ; sinon il revient à son réseau précédent.
+Tous les ports sont traités en parallèle : un banc de dix appareils prend
+le temps d'un seul. Code de sortie non nul si un appareil a échoué.
+
+Exemples :
+  tools/provisionne.py --ssid Maison /dev/ttyACM0
+  tools/provisionne.py --ssid Atelier --tous --csv banc.csv
+"""
+
+import argparse
+import csv
+import getpass
+import json
+import sys
+import threading
+import time
+
+import serial
+import serial.tools.list_ports
+
+BAUD = 460800
+VID_ESPRESSIF = 0x303A               # USB série intégré de l'ESP32-C3
+ENTETE = b"IMPROV"
+VERSION = 1
+ETAT, ERREUR, COMMANDE, RESULTAT = 1, 2, 3, 4
+RPC_WIFI, RPC_ETAT, RPC_INFO = 1, 2, 3
+ETATS = {2: "pret", 3: "connexion", 4: "connecte"}
+ERREURS = {1: "paquet invalide", 2: "commande inconnue", 3: "echec de connexion",
+           0xFF: "erreur inconnue"}
+INFO_S = 3                           # délai de réponse à une commande simple
+CONNEXION_S = 30                     # l'appareil abandonne après 20 s
+
+
+def paquet(type_, donnees):
+    corps = ENTETE + bytes([VERSION, type_, len(donnees)]) + donnees
+    return corps + bytes([sum(corps) & 0xFF]) + b"\n"
+
+
+def commande(rpc, *chaines):
+    donnees = b"".join(bytes([len(c)]) + c for c in (s.encode("utf-8") for s in chaines))
+    return paquet(COMMANDE, bytes([rpc, len(donnees)]) + donnees)
+
+
+def chaines_resultat(donnees):
+    """(rpc, [chaînes]) d'un résultat RPC, ou None s'il est incohérent."""
+    if len(donnees) < 2 or donnees[1] != len(donnees) - 2:
+        return None
+    res, i = [], 2
+    while i < len(donnees):
+        n = donnees[i]
+        res.append(donnees[i + 1:i + 1 + n].decode("utf-8", "replace"))
+        i += 1 + n
+    return donnees[0], res
+
+
+class Lecteur:
+    """Paquets Improv extraits du flux série, journal texte ignoré."""
+
+    def __init__(self, port):
+        self.port = port
+        self.tampon = b""
+
+    def suivant(self, echeance):
+        """(type, données) du prochain paquet valide, None à l'échéance."""
+        while True:
+            i = self.tampon.find(ENTETE)
+            if i >= 0 and len(self.tampon) >= i + 9:
+                n = self.tampon[i + 8]
+                if len(self.tampon) >= i + 10 + n:
+                    corps = self.tampon[i:i + 9 + n]
+                    somme = self.tampon[i + 9 + n]
+                    self.tampon = self.tampon[i + 10 + n:]
+                    if corps[6] == VERSION and sum(corps) & 0xFF == somme:
+                        return corps[7], corps[9:]
+                    continue
+            elif i < 0:
+                self.tampon = self.tampon[-(len(ENTETE) - 1):]   # en-tête à cheval
+            reste = echeance - time.time()
+            if reste <= 0:
+                return None
+            self.port.timeout = min(reste, 0.2)
+            self.tampon += self.port.read(max(1, self.port.in_waiting))
+
+
+def attend(lecteur, rpc, delai):
+    """Attend le résultat de rpc : (chaînes, None) ou (None, erreur)."""
+    echeance = time.time() + delai
+    while True:
+        p = lecteur.suivant(echeance)
+        if p is None:
+            return None, "pas de reponse"
+        type_, donnees = p
+        if type_ == ERREUR and donnees and donnees[0] != 0:
+            return None, ERREURS.get(donnees[0], "erreur %d" % donnees[0])
+        if type_ == RESULTAT:
+            r = chaines_resultat(donnees)
+            if r and r[0] == rpc:
+                return r[1], None
+
+
+def provisionne(nom_port, args, res):
+    ligne = {"port": nom_port, "nom": "", "version": "", "resultat": "", "adresse": ""}
+    res.append(ligne)
+    try:
+        # DTR/RTS au repos : ouvrir le port ne doit pas redémarrer l'appareil
+        port = serial.Serial()
+        port.port = nom_port
+        port.baudrate = args.baud
+        port.dtr = False
+        port.rts = False
+        port.open()
+    except serial.SerialException as e:
+        ligne["resultat"] = "port: %s" % e
+        return
+    with port:
+        lecteur = Lecteur(port)
+        port.write(commande(RPC_INFO))
+        info, erreur = attend(lecteur, RPC_INFO, INFO_S)
+        if info is None:
+            ligne["resultat"] = "info: %s" % erreur
+            return
+        ligne["version"] = info[1] if len(info) > 1 else ""
+        ligne["nom"] = info[3] if len(info) > 3 else info[0]
+        port.write(commande(RPC_WIFI, args.ssid, args.mot_de_passe))
+        adresse, erreur = attend(lecteur, RPC_WIFI, CONNEXION_S)
+        if adresse is None:
+            ligne["resultat"] = erreur
+            return
+        ligne["resultat"] = "ok"
+        ligne["adresse"] = adresse[0] if adresse else ""
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("ports", nargs="*", help="ports série (ex. /dev/ttyACM0 COM5)")
+    ap.add_argument("--tous", action="store_true", help="tous les ports USB Espressif branchés")
+    ap.add_argument("--ssid", required=True)
+    ap.add_argument("--mot-de-passe", help="demandé au clavier s'il est omis")
+    ap.add_argument("--baud", type=int, default=BAUD)
+    ap.add_argument("--csv", help="écrit le résultat en CSV")
+    ap.add_argument("--json", help="écrit le résultat en JSON")
+    args = ap.parse_args()
+
+    ports = list(args.ports)
+    if args.tous:
+        ports += [p.device for p in serial.tools.list_ports.comports()
+                  if p.vid == VID_ESPRESSIF and p.device not in ports]
+    if not ports:
+        ap.error("aucun port (donner les ports ou --tous)")
+    if len(args.ssid.encode("utf-8")) > 32:
+        ap.error("SSID de plus de 32 octets")
+    if args.mot_de_passe is None:
+        args.mot_de_passe = getpass.getpass("Mot de passe WiFi : ")
+    if len(args.mot_de_passe.encode("utf-8")) > 64:
+        ap.error("mot de passe de plus de 64 octets")
+
+    res = []
+    fils = [threading.Thread(target=provisionne, args=(p, args, res)) for p in ports]
+    debut = time.time()
+    for f in fils:
+        f.start()
+    for f in fils:
+        f.join()
+    res.sort(key=lambda l: l["port"])
+
+    print("%-16s %-16s %-8s %-20s %s" % ("PORT", "NOM", "VERSION", "RESULTAT", "ADRESSE"))
+    for l in res:
+        print("%-16s %-16s %-8s %-20s %s" % (l["port"], l["nom"], l["version"], l["resultat"],
+                                             l["adresse"]))
+    echecs = sum(1 for l in res if l["resultat"] != "ok")
+    print("%d appareil(s), %d echec(s), %.1f s" % (len(res), echecs, time.time() - debut))
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            w = csv.DictWriter(f, fieldnames=list(res[0].keys()))
+            w.writeheader()
+            w.writerows(res)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(res, f, indent=2)
+    sys.exit(1 if echecs else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,504 @@
+// Rejeu hôte de programmes et de régulation sur une trace enregistrée
+// Entrée : CSV de tools/decode_telemetrie.py (colonnes ms, temp_c, relais),
+// ou tout CSV avec ces en-têtes. La trace est ramenée à un pas de 1 s, un
+// modèle du premier ordre du tapis est ajusté dessus
+//   dT/dt = a + b.T + c.relais
+// et le résidu seconde par seconde (charge posée, courant d'air, variation
+// d'ambiante...) est conservé. Chaque variante rejoue la trace avec le code
+// du firmware (tempCibleProgramme/smoothStep, Prechauffe, Thermostat,
+// Securite) : sa propre décision de relais pilote le modèle, et les
+// perturbations réelles sont réinjectées. La variante de base, réglée comme
+// l'appareil enregistré, reproduit donc la trace à l'erreur de modèle près.
+// Limite : l'ambiante est supposée constante ; sa dérive jour/nuit passe
+// dans le résidu et dégrade le R2 affiché, pas la fidélité de la base.
+//
+//   g++ -std=gnu++17 -O2 -pthread -Iinclude tools/rejeu.cpp src/controle.cpp src/prechauffe.cpp src/securite.cpp src/conso.cpp -o rejeu
+//   ./rejeu trace.csv --debut 14:32 --variante "doux:fondu=180" --variante "tiede:tjour=24.5,tnuit=19.5" -j 8
+//
+// Clés d'une variante (les autres reprennent la base, réglée par --base) :
+//   jour=HH:MM nuit=HH:MM tjour=°C tnuit=°C fondu=min prechauffe=0|1
+//   vchauffe=c/h vrefroid=c/h retardjour=min retardnuit=min
+// Le fichier --variantes contient une variante "nom:cles" par ligne.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "controle.h"
+#include "prechauffe.h"
+#include "securite.h"
+#include "conso.h"
+
+const uint32_t FENETRE_AJUSTEMENT_S = 300;  // pente mesurée par fenêtre de 5 min
+const uint32_t TROU_MAX_S = 120;            // trous de trace signalés au-delà
+// Saut plus rapide que le tapis ne peut chauffer ou refroidir : perturbation
+const uint32_t SAUT_FENETRE_S = 10;
+const float SAUT_MAX = 0.3f;
+
+struct Variante {
+  std::string nom;
+  Programme p;
+  bool prechauffe;
+  int16_t vitesseChauffe, vitesseRefroid, retard[2];
+};
+
+struct Trace {
+  std::vector<float> temp;       // °C, une valeur par seconde
+  std::vector<uint8_t> relais;
+  uint32_t trous;
+};
+
+struct Modele {
+  double a, b, c;                // dT/dt en °C/s
+  double r2;
+  double derivee(double t, bool relais) const { return a + b * t + c * relais; }
+};
+
+struct Resultat {
+  double erreurRms;              // mesure - consigne programmée (°C)
+  double erreurMoy;              // écart absolu moyen
+  double depassement;            // dépassement max au-dessus de la consigne
+  uint32_t cycles;               // fermetures du relais
+  uint32_t secondesOn;
+  uint32_t coupuresSecurite;     // demandes refusées par Securite
+  // Base uniquement : fidélité à la trace
+  double ecartTrace;             // RMS simulé - enregistré
+  double accordRelais;           // part des secondes où le relais est identique
+};
+
+// ---- Lecture ----
+
+static int colonne(const std::vector<std::string> &entetes, const char *nom) {
+  for (size_t i = 0; i < entetes.size(); i++)
+    if (entetes[i] == nom) return (int)i;
+  return -1;
+}
+
+static std::vector<std::string> decoupe(const char *ligne) {
+  std::vector<std::string> champs;
+  std::string champ;
+  for (const char *c = ligne; *c && *c != '\n' && *c != '\r'; c++) {
+    if (*c == ',') {
+      champs.push_back(champ);
+      champ.clear();
+    } else {
+      champ += *c;
+    }
+  }
+  champs.push_back(champ);
+  return champs;
+}
+
+static bool litTrace(const char *chemin, Trace &tr) {
+  FILE *f = fopen(chemin, "r");
+  if (!f) {
+    perror(chemin);
+    return false;
+  }
+  char ligne[512];
+  if (!fgets(ligne, sizeof(ligne), f)) {
+    fclose(f);
+    return false;
+  }
+  std::vector<std::string> entetes = decoupe(ligne);
+  int cMs = colonne(entetes, "ms"), cTemp = colonne(entetes, "temp_c"), cRelais = colonne(entetes, "relais");
+  if (cMs < 0 || cTemp < 0 || cRelais < 0) {
+    fprintf(stderr, "%s: colonnes ms, temp_c et relais requises\n", chemin);
+    fclose(f);
+    return false;
+  }
+
+  // Rééchantillonnage à 1 s : interpolation linéaire de la température,
+  // relais maintenu jusqu'à l'échantillon suivant (exclu)
+  bool premier = true;
+  uint32_t ms0 = 0, msPrec = 0;
+  double tempPrec = 0;
+  bool relaisPrec = false;
+  tr.trous = 0;
+  while (fgets(ligne, sizeof(ligne), f)) {
+    std::vector<std::string> ch = decoupe(ligne);
+    if ((int)ch.size() <= cMs || (int)ch.size() <= cTemp || (int)ch.size() <= cRelais) continue;
+    uint32_t ms = (uint32_t)strtoul(ch[cMs].c_str(), nullptr, 10);
+    double temp = atof(ch[cTemp].c_str());
+    bool relais = atoi(ch[cRelais].c_str()) != 0;
+    if (premier) {
+      ms0 = msPrec = ms;
+      tempPrec = temp;
+      relaisPrec = relais;
+      premier = false;
+    }
+    if (ms < msPrec) continue;   // redémarrage de l'appareil : on ignore le reste
+    if (ms - msPrec > TROU_MAX_S * 1000) tr.trous++;
+    for (uint32_t s = (uint32_t)tr.temp.size(); (uint64_t)s * 1000 + ms0 <= ms; s++) {
+      uint32_t t = ms0 + s * 1000;
+      double k = ms > msPrec ? (double)(t - msPrec) / (ms - msPrec) : 1.0;
+      if (k < 0) k = 0;
+      tr.temp.push_back((float)(tempPrec + (temp - tempPrec) * k));
+      tr.relais.push_back(t == ms ? relais : relaisPrec);
+    }
+    msPrec = ms;
+    tempPrec = temp;
+    relaisPrec = relais;
+  }
+  fclose(f);
+  return tr.temp.size() > 2 * FENETRE_AJUSTEMENT_S;
+}
+
+// ---- Modèle ----
+
+struct Fenetre {
+  double x[3];                   // 1, température moyenne, taux de marche
+  double y;                      // pente (°C/s)
+};
+
+// Moindres carrés y = a + b.T + c.marche
+static bool moindresCarres(const std::vector<Fenetre> &fs, Modele &m) {
+  double a[3][4] = {}, sy = 0, syy = 0;
+  uint32_t n = 0;
+  for (const Fenetre &f : fs) {
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) a[i][j] += f.x[i] * f.x[j];
+      a[i][3] += f.x[i] * f.y;
+    }
+    sy += f.y;
+    syy += f.y * f.y;
+    n++;
+  }
+  double v[3] = {a[0][3], a[1][3], a[2][3]};
+  // Élimination de Gauss 3x3
+  for (int i = 0; i < 3; i++) {
+    int piv = i;
+    for (int k = i + 1; k < 3; k++)
+      if (fabs(a[k][i]) > fabs(a[piv][i])) piv = k;
+    if (fabs(a[piv][i]) < 1e-12) return false;
+    for (int j = 0; j < 4; j++) {
+      double t = a[i][j];
+      a[i][j] = a[piv][j];
+      a[piv][j] = t;
+    }
+    for (int k = 0; k < 3; k++) {
+      if (k == i) continue;
+      double f = a[k][i] / a[i][i];
+      for (int j = i; j < 4; j++) a[k][j] -= f * a[i][j];
+    }
+  }
+  m.a = a[0][3] / a[0][0];
+  m.b = a[1][3] / a[1][1];
+  m.c = a[2][3] / a[2][2];
+  // Part de variance expliquée
+  double sse = syy - (m.a * v[0] + m.b * v[1] + m.c * v[2]);
+  double sst = syy - sy * sy / n;
+  m.r2 = sst > 0 ? 1 - sse / sst : 0;
+  return true;
+}
+
+// Ajustement sur des fenêtres de 5 min : pente (régression linéaire dans
+// la fenêtre, robuste à la quantification) en fonction de la température
+// moyenne et du taux de marche. Les fenêtres contenant un saut (charge
+// posée, sonde touchée) fausseraient le modèle et sont écartées ; elles
+// restent dans le résidu réinjecté au rejeu.
+static bool ajuste(const Trace &tr, Modele &m, uint32_t &ecartees) {
+  std::vector<Fenetre> fs;
+  const double w = FENETRE_AJUSTEMENT_S, milieu = (w - 1) / 2;
+  ecartees = 0;
+  for (size_t d = 0; d + FENETRE_AJUSTEMENT_S < tr.temp.size(); d += FENETRE_AJUSTEMENT_S) {
+    double tMoy = 0, marche = 0, cov = 0, var = 0;
+    bool saut = false;
+    for (size_t i = d; i < d + FENETRE_AJUSTEMENT_S; i++) {
+      tMoy += tr.temp[i];
+      marche += tr.relais[i];
+      if (i >= SAUT_FENETRE_S && fabsf(tr.temp[i] - tr.temp[i - SAUT_FENETRE_S]) > SAUT_MAX) saut = true;
+    }
+    if (saut) {
+      ecartees++;
+      continue;
+    }
+    tMoy /= w;
+    for (size_t i = d; i < d + FENETRE_AJUSTEMENT_S; i++) {
+      double k = (double)(i - d) - milieu;
+      cov += k * (tr.temp[i] - tMoy);
+      var += k * k;
+    }
+    fs.push_back({{1, tMoy, marche / w}, cov / var});
+  }
+  if (!moindresCarres(fs, m)) return false;
+  // Le tapis doit refroidir vers l'ambiante et chauffer relais fermé
+  return m.b < 0 && m.c > 0;
+}
+
+// ---- Variantes ----
+
+static bool litHeure(const char *s, int &minute) {
+  int h, m = 0;
+  if (sscanf(s, "%d:%d", &h, &m) < 1 || h < 0 || h > 23 || m < 0 || m > 59) return false;
+  minute = h * 60 + m;
+  return true;
+}
+
+static centi_t centi(const char *s) {
+  return (centi_t)lround(atof(s) * 100);
+}
+
+static bool appliqueCles(Variante &v, const std::string &cles) {
+  size_t debut = 0;
+  while (debut < cles.size()) {
+    size_t fin = cles.find(',', debut);
+    if (fin == std::string::npos) fin = cles.size();
+    std::string kv = cles.substr(debut, fin - debut);
+    debut = fin + 1;
+    size_t eg = kv.find('=');
+    if (eg == std::string::npos) {
+      fprintf(stderr, "variante %s: '%s' sans valeur\n", v.nom.c_str(), kv.c_str());
+      return false;
+    }
+    std::string cle = kv.substr(0, eg);
+    const char *val = kv.c_str() + eg + 1;
+    bool ok = true;
+    if (cle == "jour") ok = litHeure(val, v.p.minuteDay);
+    else if (cle == "nuit") ok = litHeure(val, v.p.minuteNight);
+    else if (cle == "tjour") v.p.tempDay = centi(val);
+    else if (cle == "tnuit") v.p.tempNight = centi(val);
+    else if (cle == "fondu") v.p.fadeDuration = atoi(val);
+    else if (cle == "prechauffe") v.prechauffe = atoi(val) != 0;
+    else if (cle == "vchauffe") v.vitesseChauffe = (int16_t)atoi(val);
+    else if (cle == "vrefroid") v.vitesseRefroid = (int16_t)atoi(val);
+    else if (cle == "retardjour") v.retard[TransitionJour] = (int16_t)atoi(val);
+    else if (cle == "retardnuit") v.retard[TransitionNuit] = (int16_t)atoi(val);
+    else ok = false;
+    if (!ok) {
+      fprintf(stderr, "variante %s: '%s' invalide\n", v.nom.c_str(), kv.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool ajouteVariante(std::vector<Variante> &vs, const Variante &base, const std::string &spec) {
+  Variante v = base;
+  size_t dp = spec.find(':');
+  // "nom:cles" ; le ':' d'une heure n'est pas un séparateur de nom
+  if (dp == std::string::npos || spec.find('=') < dp) {
+    v.nom = "v" + std::to_string(vs.size());
+    if (!appliqueCles(v, spec)) return false;
+  } else {
+    v.nom = spec.substr(0, dp);
+    if (!appliqueCles(v, spec.substr(dp + 1))) return false;
+  }
+  vs.push_back(v);
+  return true;
+}
+
+// ---- Rejeu ----
+
+static Resultat rejoue(const Variante &v, const Trace &tr, const Modele &m, int debutS, bool base) {
+  Resultat r = {};
+  Securite sec;
+  sec.reset();
+  Prechauffe pc;
+  pc.reset();
+  Thermostat th;
+  th.reset();
+  pc.vitesseChauffe = v.vitesseChauffe;
+  pc.vitesseRefroid = v.vitesseRefroid;
+  pc.retard[TransitionJour] = v.retard[TransitionJour];
+  pc.retard[TransitionNuit] = v.retard[TransitionNuit];
+
+  double t = tr.temp[0];
+  bool relais = false;
+  double sommeErr2 = 0, sommeErr = 0, sommeTrace2 = 0;
+  uint32_t accord = 0;
+  size_t n = tr.temp.size() - 1;
+
+  for (size_t s = 0; s < n; s++) {
+    uint32_t ms = (uint32_t)(s * 1000);
+    int minute = (int)(((debutS + s) / 60) % 1440);
+    centi_t mesure = (centi_t)lround(t * 100);
+    centi_t programme = tempCibleProgramme(minute, v.p.minuteDay, v.p.tempDay,
+                                           v.p.minuteNight, v.p.tempNight, v.p.fadeDuration);
+    centi_t cible = v.prechauffe ? pc.consigne(minute, v.p) : programme;
+
+    // Comme loop() : mesure et demande au superviseur, puis apprentissage
+    sec.mesure(mesure, ms);
+    sec.demande = th.decide(mesure, cible, ms);
+    bool nouveau = sec.decide(ms);
+    if (sec.demande && !nouveau) r.coupuresSecurite++;
+    if (nouveau && !relais) r.cycles++;
+    relais = nouveau;
+    if (v.prechauffe) {
+      pc.echantillon(mesure, relais, ms);
+      pc.suivi(minute, mesure, v.p);
+    }
+
+    double err = (mesure - programme) / 100.0;
+    sommeErr2 += err * err;
+    sommeErr += fabs(err);
+    if (err > r.depassement) r.depassement = err;
+    r.secondesOn += relais;
+    if (base) {
+      double e = t - tr.temp[s];
+      sommeTrace2 += e * e;
+      accord += relais == (bool)tr.relais[s];
+    }
+
+    // Modèle + perturbation réelle de cette seconde
+    double residu = (tr.temp[s + 1] - tr.temp[s]) - m.derivee(tr.temp[s], tr.relais[s]);
+    t += m.derivee(t, relais) + residu;
+  }
+  r.erreurRms = sqrt(sommeErr2 / n);
+  r.erreurMoy = sommeErr / n;
+  r.ecartTrace = sqrt(sommeTrace2 / n);
+  r.accordRelais = 100.0 * accord / n;
+  return r;
+}
+
+// Mêmes indicateurs pour la trace enregistrée, contre le programme de base
+static Resultat mesureTrace(const Variante &v, const Trace &tr, int debutS) {
+  Resultat r = {};
+  double sommeErr2 = 0, sommeErr = 0;
+  size_t n = tr.temp.size() - 1;
+  bool relais = false;
+  for (size_t s = 0; s < n; s++) {
+    int minute = (int)(((debutS + s) / 60) % 1440);
+    centi_t programme = tempCibleProgramme(minute, v.p.minuteDay, v.p.tempDay,
+                                           v.p.minuteNight, v.p.tempNight, v.p.fadeDuration);
+    double err = tr.temp[s] - programme / 100.0;
+    sommeErr2 += err * err;
+    sommeErr += fabs(err);
+    if (err > r.depassement) r.depassement = err;
+    if (tr.relais[s] && !relais) r.cycles++;
+    relais = tr.relais[s];
+    r.secondesOn += relais;
+  }
+  r.erreurRms = sqrt(sommeErr2 / n);
+  r.erreurMoy = sommeErr / n;
+  return r;
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: rejeu TRACE.csv [--debut HH:MM[:SS]] [--watts W] [-j N]\n"
+          "             [--base cles] [--variante nom:cles]... [--variantes FICHIER]\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  const char *chemin = nullptr;
+  int debutS = 0;
+  bool debutDonne = false;
+  unsigned watts = CONSO_WATTS_DEFAUT;
+  unsigned nbThreads = std::thread::hardware_concurrency();
+  std::string cleBase;
+  std::vector<std::string> specs;
+
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    bool suivant = i + 1 < argc;
+    if (a == "--debut" && suivant) {
+      int h, m, s = 0;
+      if (sscanf(argv[++i], "%d:%d:%d", &h, &m, &s) < 2) usage();
+      debutS = (h * 60 + m) * 60 + s;
+      debutDonne = true;
+    } else if (a == "--watts" && suivant) {
+      watts = (unsigned)atoi(argv[++i]);
+    } else if (a == "-j" && suivant) {
+      nbThreads = (unsigned)atoi(argv[++i]);
+    } else if (a == "--base" && suivant) {
+      cleBase = argv[++i];
+    } else if (a == "--variante" && suivant) {
+      specs.push_back(argv[++i]);
+    } else if (a == "--variantes" && suivant) {
+      FILE *f = fopen(argv[++i], "r");
+      if (!f) {
+        perror(argv[i]);
+        return 1;
+      }
+      char ligne[256];
+      while (fgets(ligne, sizeof(ligne), f)) {
+        std::string l = ligne;
+        while (!l.empty() && (l.back() == '\n' || l.back() == '\r' || l.back() == ' ')) l.pop_back();
+        if (!l.empty() && l[0] != '#') specs.push_back(l);
+      }
+      fclose(f);
+    } else if (a[0] != '-' && !chemin) {
+      chemin = argv[i];
+    } else {
+      usage();
+    }
+  }
+  if (!chemin) usage();
+  if (nbThreads == 0) nbThreads = 1;
+
+  Trace tr;
+  if (!litTrace(chemin, tr)) {
+    fprintf(stderr, "%s: trace illisible ou trop courte\n", chemin);
+    return 1;
+  }
+  Modele m;
+  uint32_t ecartees;
+  if (!ajuste(tr, m, ecartees)) {
+    fprintf(stderr, "%s: modèle non identifiable (relais jamais commuté ?)\n", chemin);
+    return 1;
+  }
+
+  // Base : réglages d'usine du firmware, modifiés par --base
+  Variante base = {"base", {9 * 60 + 30, 2550, 19 * 60, 2050, 120}, true, 0, 0, {0, 0}};
+  if (!appliqueCles(base, cleBase)) return 1;
+  std::vector<Variante> vs;
+  vs.push_back(base);
+  for (const std::string &s : specs)
+    if (!ajouteVariante(vs, base, s)) return 1;
+
+  printf("Trace %s : %.1f h, %u trou(s) > %u s%s\n", chemin, tr.temp.size() / 3600.0,
+         tr.trous, TROU_MAX_S, debutDonne ? "" : ", debut suppose a 00:00 (--debut)");
+  printf("Modele : ambiante %.1f C, constante de temps %.0f min, gain relais %.1f C, R2 %.2f "
+         "(%u fenetre(s) perturbee(s) ecartee(s))\n",
+         -m.a / m.b, -1 / m.b / 60, -m.c / m.b, m.r2, ecartees);
+
+  // Variantes réparties sur les cœurs
+  std::vector<Resultat> res(vs.size());
+  std::atomic<size_t> prochaine(0);
+  auto debut = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned k = 0; k < nbThreads && k < vs.size(); k++) {
+    threads.emplace_back([&]() {
+      for (size_t i; (i = prochaine++) < vs.size();)
+        res[i] = rejoue(vs[i], tr, m, debutS, i == 0);
+    });
+  }
+  for (std::thread &t : threads) t.join();
+  double secondes = std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+
+  Consommation c;
+  c.reset((uint16_t)watts);
+  char kwh[16];
+  Resultat enr = mesureTrace(base, tr, debutS);
+  printf("Base : fidelite %.2f C RMS, relais identique %.1f %% du temps\n\n",
+         res[0].ecartTrace, res[0].accordRelais);
+  printf("%-16s %8s %8s %8s %7s %7s %9s %9s %6s\n",
+         "variante", "rms C", "moy C", "depas C", "cycles", "marche", "kWh", "dkWh", "secu");
+  formatKwh(kwh, sizeof(kwh), c.wattheures(enr.secondesOn));
+  printf("%-16s %8.3f %8.3f %8.2f %7u %6.1f%% %9s %9s %6s\n", "(enregistre)",
+         enr.erreurRms, enr.erreurMoy, enr.depassement, enr.cycles,
+         100.0 * enr.secondesOn / (tr.temp.size() - 1), kwh, "", "");
+  int32_t whBase = (int32_t)c.wattheures(res[0].secondesOn);
+  for (size_t i = 0; i < vs.size(); i++) {
+    const Resultat &r = res[i];
+    int32_t wh = (int32_t)c.wattheures(r.secondesOn);
+    char delta[16];
+    formatKwh(kwh, sizeof(kwh), (uint32_t)wh);
+    formatKwh(delta + 1, sizeof(delta) - 1, (uint32_t)abs(wh - whBase));
+    delta[0] = wh < whBase ? '-' : '+';
+    printf("%-16s %8.3f %8.3f %8.2f %7u %6.1f%% %9s %9s %6u\n", vs[i].nom.c_str(),
+           r.erreurRms, r.erreurMoy, r.depassement, r.cycles,
+           100.0 * r.secondesOn / (tr.temp.size() - 1), kwh, i ? delta : "", r.coupuresSecurite);
+  }
+  printf("\n%zu variante(s) sur %u thread(s) en %.2f s, %.0fx temps reel\n", vs.size(),
+         nbThreads < vs.size() ? nbThreads : (unsigned)vs.size(), secondes,
+         secondes > 0 ? vs.size() * (tr.temp.size() - 1) / secondes : 0);
+  return 0;
+}
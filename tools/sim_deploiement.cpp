@@ -0,0 +1,118 @@
+// Vérification hôte du tirage du déploiement progressif
+// 1000 identifiants d'appareils (aléatoires, puis consécutifs comme les
+// adresses MAC d'un même lot) sont tirés contre chaque pourcentage : la
+// part retenue doit rester dans la marge binomiale (4 écarts types), un
+// appareil retenu le reste quand le pourcentage monte, et les tranches de
+// deux versions sont indépendantes. Les règles (arrêt, version minimale,
+// cohortes) et la comparaison des versions sont vérifiées à part.
+//
+//   g++ -std=gnu++17 -O2 -Iinclude tools/sim_deploiement.cpp src/deploiement.cpp -o sim_deploiement
+//   ./sim_deploiement
+//   ./sim_deploiement --tranches 0.2.2 < ids.txt   # tranche de chaque id (hexadécimal)
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "deploiement.h"
+
+const int APPAREILS = 1000;
+
+static bool verifie(const char *nom, bool ok) {
+  if (!ok) printf("  ECHEC : %s\n", nom);
+  return ok;
+}
+
+// Part du parc retenue pour chaque pourcentage
+static bool distribution(const char *nom, const uint32_t *ids) {
+  const float pourcentages[] = {0, 0.5f, 1, 5, 10, 25, 50, 90, 100};
+  bool ok = true;
+  printf("%-12s", nom);
+  for (float p : pourcentages) {
+    RegleDeploiement r = {tranchesPourcentage(p), false, false, nullptr};
+    int retenus = 0;
+    for (int i = 0; i < APPAREILS; i++) {
+      if (decideDeploiement(ids[i], "0.2.1", "0.2.2", r) == DeploiementOui) retenus++;
+    }
+    double attendu = APPAREILS * p / 100;
+    double marge = 4 * sqrt(APPAREILS * (p / 100) * (1 - p / 100));
+    bool dedans = fabs(retenus - attendu) <= marge;
+    printf("  %g%%:%d", p, retenus);
+    ok = verifie("part retenue hors marge", dedans) && ok;
+  }
+  printf("\n");
+
+  // Un appareil retenu à p l'est encore à tout p' > p
+  for (int i = 0; i < APPAREILS; i++) {
+    bool avant = false;
+    for (uint16_t t = 0; t <= DEPLOIEMENT_TRANCHES; t += 250) {
+      RegleDeploiement r = {t, false, false, nullptr};
+      bool oui = decideDeploiement(ids[i], "0.2.1", "0.2.2", r) == DeploiementOui;
+      if (avant && !oui) return verifie("tirage non monotone", false);
+      avant = oui;
+    }
+  }
+
+  // Tranches de 10 % de deux versions : recouvrement attendu de 1 %
+  int communs = 0;
+  for (int i = 0; i < APPAREILS; i++) {
+    bool a = trancheDeploiement(ids[i], "0.2.2") < 1000;
+    bool b = trancheDeploiement(ids[i], "0.2.3") < 1000;
+    if (a && b) communs++;
+  }
+  printf("%-12s  recouvrement 10%% / 10%% : %d (attendu %d)\n", "", communs, APPAREILS / 100);
+  return verifie("tranches liées d'une version à l'autre", communs <= 3 * APPAREILS / 100) && ok;
+}
+
+static bool regles() {
+  bool ok = true;
+  ok = verifie("0.2.10 > 0.2.9", compareVersions("0.2.10", "0.2.9") > 0) && ok;
+  ok = verifie("0.2 == 0.2.0", compareVersions("0.2", "0.2.0") == 0) && ok;
+  ok = verifie("0.1.9 < 0.2", compareVersions("0.1.9", "0.2") < 0) && ok;
+  ok = verifie("1.0-rc1 == 1.0", compareVersions("1.0-rc1", "1.0") == 0) && ok;
+  ok = verifie("10 > 9", compareVersions("10", "9") > 0) && ok;
+
+  // Appareil hors de la tranche de 1 %
+  uint32_t id = 0;
+  while (trancheDeploiement(id, "0.3") < 100) id++;
+  RegleDeploiement r = {100, false, false, ""};
+  ok = verifie("hors tranche", decideDeploiement(id, "0.2.1", "0.3", r) == DeploiementHorsTranche) && ok;
+  r.cohorte = true;
+  ok = verifie("cohorte", decideDeploiement(id, "0.2.1", "0.3", r) == DeploiementOui) && ok;
+  r.versionMin = "0.2.2";
+  ok = verifie("version minimale", decideDeploiement(id, "0.2.1", "0.3", r) == DeploiementVersionMin) && ok;
+  r.versionMin = "0.2.1";
+  ok = verifie("version minimale atteinte", decideDeploiement(id, "0.2.1", "0.3", r) == DeploiementOui) && ok;
+  r.arrete = true;
+  ok = verifie("arrêt", decideDeploiement(id, "0.2.1", "0.3", r) == DeploiementArrete) && ok;
+  ok = verifie("pourcentages", tranchesPourcentage(-1) == 0 && tranchesPourcentage(0.01f) == 1 &&
+                                   tranchesPourcentage(12.5f) == 1250 && tranchesPourcentage(250) == 10000) && ok;
+  printf("regles %s\n", ok ? "ok" : "ECHEC");
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  if (argc == 3 && strcmp(argv[1], "--tranches") == 0) {
+    char ligne[32];
+    while (fgets(ligne, sizeof(ligne), stdin)) {
+      uint32_t id = (uint32_t)strtoul(ligne, nullptr, 16);
+      printf("%08lx %u\n", (unsigned long)id, trancheDeploiement(id, argv[2]));
+    }
+    return 0;
+  }
+
+  static uint32_t aleatoires[APPAREILS], consecutifs[APPAREILS], octetHaut[APPAREILS];
+  uint32_t x = 12345;
+  for (int i = 0; i < APPAREILS; i++) {
+    x = x * 1664525u + 1013904223u;
+    aleatoires[i] = x;
+    consecutifs[i] = 0x3c84a100u + i;
+    octetHaut[i] = 0x0027b0c4u + ((uint32_t)(i & 0xFF) << 24) + (uint32_t)(i >> 8);
+  }
+  bool ok = regles();
+  ok = distribution("aleatoires", aleatoires) && ok;
+  ok = distribution("consecutifs", consecutifs) && ok;
+  ok = distribution("octet haut", octetHaut) && ok;
+  printf(ok ? "OK\n" : "ECHEC\n");
+  return ok ? 0 : 1;
+}
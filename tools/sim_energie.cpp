@@ -0,0 +1,143 @@
+// Simulation hôte de la comptabilité énergétique (include/energie.h)
+// Reproduit l'ordonnancement de loop() : travail de l'itération, image
+// refaite à chaque seconde écran allumé, attente jusqu'à la prochaine
+// échéance (loopIdleMax écran allumé, étape suivante de la mesure écran
+// éteint), recouvrement avec la conversion DS18B20 comme compteEnergie().
+// Chaque cycle d'usage (écran allumé ou éteint, WiFi associé ou non,
+// appuis occasionnels) tourne une heure ; le temps éveillé par sous-système
+// et le courant moyen sont comparés à la boucle d'origine, qui tournait
+// sans attendre, écran toujours allumé.
+//
+//   g++ -std=gnu++17 -O2 -Iinclude tools/sim_energie.cpp src/capteur.cpp src/controle.cpp -o sim_energie
+//   ./sim_energie
+
+#include <stdio.h>
+#include "energie.h"
+#include "capteur.h"
+
+// Valeurs du firmware (src/main.cpp)
+const uint32_t LOOP_IDLE_MAX_MS = 50;
+const uint32_t ECRAN_TIMEOUT_MS = 60000;
+
+// Coûts d'une itération (ESP32-C3 160 MHz, bus I2C à 400 kHz)
+const uint32_t TRAVAIL_MS = 1;       // boucle sans image
+const uint32_t RENDU_MS = 25;        // dessin + envoi des 8 pages
+const uint32_t DUREE_MS = 3600000;
+
+struct Scenario {
+  const char *nom;
+  bool wifi;                 // associé
+  uint32_t appuiMs;          // un appui tous les appuiMs (0 : aucun)
+  bool ecranInitial;
+  uint8_t bits;              // résolution en régime
+  bool sansAttente;          // boucle d'origine : ni attente ni veille de l'écran
+};
+
+static void simule(const Scenario &sc, ModeleEnergie &e) {
+  e.reset();
+  uint32_t now = 0, requete = 0, derniereActivite = 0, derniereImage = UINT32_MAX;
+  bool conversion = true, ecran = sc.ecranInitial;
+
+  while (now < DUREE_MS) {
+    // Appui : l'écran se rallume
+    if (sc.appuiMs && now / sc.appuiMs != (now == 0 ? 1 : (now - 1) / sc.appuiMs)) {
+      ecran = true;
+      derniereActivite = now;
+    } else if (!sc.sansAttente && ecran && now - derniereActivite > ECRAN_TIMEOUT_MS) {
+      ecran = false;
+    }
+
+    // Étapes de la mesure, comme updateCapteur()
+    if (conversion && now - requete >= conversionMs(sc.bits)) {
+      conversion = false;
+    } else if (!conversion && now - requete >= periodeMs(sc.bits)) {
+      conversion = true;
+      requete = now;
+    }
+
+    // Travail de l'itération, image refaite quand la seconde change
+    uint32_t travail = TRAVAIL_MS;
+    if (ecran && now / 1000 != derniereImage) {
+      derniereImage = now / 1000;
+      travail += RENDU_MS;
+    }
+
+    // Attente jusqu'à la prochaine échéance
+    uint32_t fin = now + travail;
+    uint32_t attente = 0;
+    if (!sc.sansAttente) {
+      uint32_t depuis = fin - requete;
+      uint32_t echeance = conversion ? conversionMs(sc.bits) : periodeMs(sc.bits);
+      attente = ecran ? LOOP_IDLE_MAX_MS : (depuis < echeance ? echeance - depuis : 0);
+      if (ecran) {
+        uint32_t image = 1000 - fin % 1000;
+        if (image < attente) attente = image;
+      }
+    }
+    uint32_t duree = travail + attente;
+
+    // Comptabilité, comme compteEnergie()
+    e.avance(duree);
+    e.compte(SsCpu, travail);
+    if (ecran) e.compte(SsEcran, duree);
+    if (sc.wifi) e.compte(SsWifi, duree);
+    long convDebut = (long)requete - (long)now;
+    long convFin = convDebut + (long)conversionMs(sc.bits);
+    long debut = convDebut > 0 ? convDebut : 0;
+    long finIt = convFin < (long)duree ? convFin : (long)duree;
+    if (finIt > debut) e.compte(SsCapteur, finIt - debut);
+
+    now += duree;
+  }
+}
+
+static void affiche(const char *nom, const ModeleEnergie &e, uint32_t origineUA) {
+  printf("%-30s", nom);
+  const char *noms[NbSousSystemes] = {"CPU", "Ecran", "WiFi", "Capteur"};
+  for (int i = 0; i < NbSousSystemes; i++) {
+    uint16_t p = e.pourmilleActif((SousSysteme)i);
+    printf("  %s %3u.%u%%", noms[i], p / 10, p % 10);
+  }
+  uint32_t ua = e.courantMoyenUA();
+  printf("  -> %6lu uA  (%3lu%% de l'origine)\n", (unsigned long)ua,
+         (unsigned long)((uint64_t)ua * 100 / origineUA));
+}
+
+int main() {
+  const Scenario origine = {"origine (sans attente)", true, 0, true, 12, true};
+  const Scenario scenarios[] = {
+    // nom                              wifi   appui     écran  bits
+    {"ecran allume, WiFi",              true,  30000,    true,  12, false},
+    {"ecran allume, sans WiFi",         false, 30000,    true,  12, false},
+    {"1 appui / 15 min, WiFi",          true,  900000,   false, 12, false},
+    {"ecran eteint, WiFi",              true,  0,        false, 12, false},
+    {"ecran eteint, sans WiFi",         false, 0,        false, 12, false},
+    {"ecran eteint, WiFi, 10 bits",     true,  0,        false, 10, false},
+  };
+  const int n = sizeof(scenarios) / sizeof(scenarios[0]);
+
+  ModeleEnergie ref, e[n];
+  simule(origine, ref);
+  uint32_t origineUA = ref.courantMoyenUA();
+  affiche(origine.nom, ref, origineUA);
+  for (int i = 0; i < n; i++) {
+    simule(scenarios[i], e[i]);
+    affiche(scenarios[i].nom, e[i], origineUA);
+  }
+
+  // Critères : l'attente réduit le CPU éveillé écran allumé, l'écran éteint
+  // et l'absence de WiFi font baisser le courant, le capteur est compté
+  // pour sa durée de conversion
+  bool ok = e[0].pourmilleActif(SsCpu) < ref.pourmilleActif(SsCpu) / 4
+         && e[0].courantMoyenUA() < origineUA
+         && e[3].courantMoyenUA() < e[2].courantMoyenUA()
+         && e[2].courantMoyenUA() < e[0].courantMoyenUA()
+         && e[4].courantMoyenUA() < e[3].courantMoyenUA()
+         && e[4].pourmilleActif(SsCpu) < 20
+         && e[3].pourmilleActif(SsEcran) == 0;
+  uint32_t attendu = 1000 * conversionMs(12) / periodeMs(12);
+  uint32_t capteur = e[3].pourmilleActif(SsCapteur);
+  ok = ok && capteur + 5 >= attendu && capteur <= attendu + 5;
+  printf(ok ? "OK\n" : "ECHEC\n");
+  return ok ? 0 : 1;
+}
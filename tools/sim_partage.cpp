@@ -0,0 +1,278 @@
+// Simulation hôte du partage des images firmware sur le réseau local
+// Un parc d'appareils passe de la version 0.2.0 à 0.2.1 avec la politique de
+// include/pairs.h, dans l'ordonnancement du firmware : annonce "att" puis
+// recherche mDNS (résultats après PARTAGE_RECHERCHE_MS), téléchargement
+// depuis un pair (un client à la fois, sinon échec et nouvelle attente) ou
+// depuis l'origine (annonce "dl"), redémarrage puis annonce de la nouvelle
+// image après PARTAGE_DELAI_MS, ou dès la connexion WiFi pour l'appareil
+// qui l'a prise à l'origine. Chaque scénario vérifie que tout le parc
+// est mis à jour et que l'origine ne sert qu'un nombre borné d'images,
+// indépendant de la taille du parc.
+//
+//   g++ -std=gnu++17 -O2 -Iinclude tools/sim_partage.cpp src/pairs.cpp -o sim_partage
+//   ./sim_partage
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "pairs.h"
+
+// Valeurs du firmware (include/partage.h) et durées observées
+const uint32_t PAS_MS = 100;
+const uint32_t RECHERCHE_MS = 3000;       // PARTAGE_RECHERCHE_MS
+const uint32_t DELAI_ANNONCE_MS = 30000;  // PARTAGE_DELAI_MS
+const uint32_t ORIGINE_MS = 45000;        // ~1,2 Mo en TLS
+const uint32_t PAIR_MS = 10000;           // ~1,2 Mo en HTTP sur le réseau local
+const uint32_t ECHEC_MS = 5000;           // pair occupé : délai de l'HTTPClient
+const uint32_t REDEMARRAGE_MS = 8000;
+const uint32_t WIFI_MS = 3000;            // reconnexion avant l'annonce immédiate
+const uint32_t HORIZON_MS = 1800000;
+
+const char *ANCIENNE = "0.2.0";
+const char *NOUVELLE = "0.2.1";
+const char *MD5_ANCIEN = "f150d6927f62002b91948d467a4ce17a";
+const char *MD5_NOUVEAU = "81baa700bbf84f5eceb7922f4f2c6500";
+
+enum Phase { Repos, Attente, Recherche, Telechargement, Redemarrage, Fini };
+
+struct Appareil {
+  uint32_t id;
+  bool cache;
+  bool nouvelle;            // image exécutée
+  bool corrompue;           // annonce le bon MD5 mais sert une image fausse
+  bool annonce;             // enregistrement mDNS visible
+  uint32_t annonceMs;       // visible à partir de
+  EtatPair etat;
+  Phase phase;
+  uint32_t declencheMs;     // appui sur "Upgrade"
+  uint32_t prochaineMs;     // prochaine étape de la phase en cours
+  Election election;
+  Pair resultats[PAIRS_MAX];
+  int nbResultats;
+  Plan plan;
+  int essai;                // rang dans plan.ordre
+  int source;               // -1 : origine, -2 : aucun essai encore, sinon pair
+  bool essaiServi;          // le pair a accepté l'essai en cours
+  uint32_t occupeJusqua;    // sert un pair
+  bool plante;              // plante au milieu du téléchargement depuis l'origine
+  bool immediat;            // redémarre après l'origine : annonce sans délai
+};
+
+struct Scenario {
+  const char *nom;
+  int nb;
+  uint32_t etalementMs;     // déclenchements répartis sur cette durée
+  bool cache;               // un cache local sert déjà la nouvelle version
+  bool plantageMeneur;      // le premier téléchargement depuis l'origine plante
+  bool pairCorrompu;        // le premier appareil mis à jour sert une image fausse
+  int origineMax;
+};
+
+struct Resultat {
+  int origine;              // images servies par l'origine
+  int misAJour;
+  uint32_t dernierMs;       // dernière mise à jour terminée
+  int echecsVerif;
+};
+
+static uint32_t graine = 12345;
+static uint32_t aleatoire() {
+  graine = graine * 1103515245u + 12345u;
+  return graine >> 8;
+}
+
+static void enregistrement(const Appareil &a, int ip, Pair &p) {
+  memset(&p, 0, sizeof(p));
+  p.ip = (uint32_t)ip;
+  p.port = PARTAGE_PORT;
+  p.id = a.id;
+  p.cache = a.cache;
+  strcpy(p.version, a.nouvelle ? NOUVELLE : ANCIENNE);
+  strcpy(p.md5, a.nouvelle ? MD5_NOUVEAU : MD5_ANCIEN);
+  p.etat = a.etat;
+  if (a.etat != PairInactif) strcpy(p.versionEtat, NOUVELLE);
+}
+
+static Resultat joue(const Scenario &sc) {
+  graine = 12345;
+  std::vector<Appareil> parc(sc.nb + (sc.cache ? 1 : 0));
+  for (int i = 0; i < sc.nb; i++) {
+    Appareil &a = parc[i];
+    memset(&a, 0, sizeof(a));
+    a.id = 0x100000 + aleatoire() % 0xE00000;   // octets de MAC
+    a.annonce = true;
+    a.phase = Repos;
+    a.declencheMs = sc.etalementMs ? aleatoire() % sc.etalementMs : 0;
+  }
+  if (sc.cache) {
+    Appareil &c = parc[sc.nb];
+    memset(&c, 0, sizeof(c));
+    c.id = 0xFFFFFF;
+    c.cache = true;
+    c.nouvelle = true;
+    c.annonce = true;
+    c.phase = Fini;
+    c.declencheMs = UINT32_MAX;
+  }
+
+  Resultat r = {0, 0, 0, 0};
+  bool plantageFait = false, corruptionFaite = false;
+  for (uint32_t t = 0; t < HORIZON_MS; t += PAS_MS) {
+    for (int i = 0; i < (int)parc.size(); i++) {
+      Appareil &a = parc[i];
+      if (!a.annonce && t >= a.annonceMs && a.phase != Redemarrage) a.annonce = true;
+
+      switch (a.phase) {
+        case Repos:
+          if (t >= a.declencheMs) {
+            // VersionUpgrade : annonce "att" (immédiate) puis recherche
+            a.annonce = true;
+            a.etat = PairAttente;
+            commenceElection(a.election, t);
+            a.phase = Recherche;
+            a.prochaineMs = t + RECHERCHE_MS;
+          }
+          break;
+
+        case Attente:
+          if (t >= a.prochaineMs) {
+            a.phase = Recherche;
+            a.prochaineMs = t + RECHERCHE_MS;
+          }
+          break;
+
+        case Recherche: {
+          if (t < a.prochaineMs) break;
+          a.nbResultats = 0;
+          for (int j = 0; j < (int)parc.size(); j++) {
+            // Ordre des réponses mDNS variable
+            int k = (j + i) % parc.size();
+            if (!parc[k].annonce) continue;
+            Pair p;
+            enregistrement(parc[k], k, p);
+            recense(a.resultats, a.nbResultats, p, NOUVELLE);
+          }
+          a.plan = planifie(a.election, a.resultats, a.nbResultats, NOUVELLE, MD5_NOUVEAU, a.id, t);
+          if (a.plan.decision == SourceAttente) {
+            a.phase = Attente;
+            a.prochaineMs = t + a.plan.attenteMs;
+          } else if (a.plan.decision == SourceOrigine) {
+            a.etat = PairTelechargement;
+            a.source = -1;
+            r.origine++;
+            a.phase = Telechargement;
+            a.prochaineMs = t + ORIGINE_MS;
+            a.plante = sc.plantageMeneur && !plantageFait;
+            plantageFait = plantageFait || a.plante;
+          } else {
+            a.essai = -1;
+            a.source = -2;
+            a.phase = Telechargement;
+            a.prochaineMs = t;   // premier essai immédiat
+          }
+          break;
+        }
+
+        case Telechargement:
+          if (a.source == -1 && a.plante && t >= a.prochaineMs - ORIGINE_MS / 2) {
+            // Plantage à mi-parcours : redémarre sur l'ancienne image,
+            // l'utilisateur relance la mise à jour
+            a.plante = false;
+            a.etat = PairInactif;
+            a.annonce = false;
+            a.phase = Redemarrage;
+            a.prochaineMs = t + REDEMARRAGE_MS;
+            a.declencheMs = t + REDEMARRAGE_MS + 60000;
+            break;
+          }
+          if (t < a.prochaineMs) break;
+          if (a.source == -1) {
+            a.nouvelle = true;
+            a.immediat = true;
+          } else {
+            // Fin de l'essai en cours puis pair suivant
+            if (a.source >= 0 && a.essaiServi) {
+              if (parc[a.source].corrompue) {
+                r.echecsVerif++;
+                exclutPair(a.election, parc[a.source].id);
+              } else {
+                a.nouvelle = true;
+              }
+            }
+            if (!a.nouvelle) {
+              a.essai++;
+              if (a.essai >= a.plan.nb) {
+                // "PAIRS" : nouvelle attente, pas d'origine
+                a.phase = Attente;
+                a.prochaineMs = t + PARTAGE_REESSAI_MS;
+                break;
+              }
+              a.source = (int)a.resultats[a.plan.ordre[a.essai]].ip;
+              Appareil &p = parc[a.source];
+              a.essaiServi = p.annonce && p.occupeJusqua <= t;
+              if (a.essaiServi) {
+                p.occupeJusqua = t + PAIR_MS;   // un client à la fois
+                a.prochaineMs = t + PAIR_MS;
+              } else {
+                a.prochaineMs = t + ECHEC_MS;   // hors ligne ou occupé
+              }
+              break;
+            }
+          }
+          // Image vérifiée : redémarrage sur la nouvelle version
+          a.etat = PairInactif;
+          a.annonce = false;
+          a.phase = Redemarrage;
+          a.prochaineMs = t + REDEMARRAGE_MS;
+          a.declencheMs = UINT32_MAX;
+          if (sc.pairCorrompu && !corruptionFaite) {
+            a.corrompue = true;
+            corruptionFaite = true;
+          }
+          break;
+
+        case Redemarrage:
+          if (t >= a.prochaineMs) {
+            a.annonceMs = t + (a.immediat ? WIFI_MS : DELAI_ANNONCE_MS);
+            if (a.nouvelle) {
+              a.phase = Fini;
+              r.misAJour++;
+              r.dernierMs = t;
+            } else {
+              a.phase = Repos;
+            }
+          }
+          break;
+
+        case Fini:
+          break;
+      }
+    }
+  }
+  return r;
+}
+
+int main() {
+  const Scenario scenarios[] = {
+    // nom                       nb  étalement  cache  plante corrompu origineMax
+    {"declenchements etales",    20, 600000,   false, false, false, 1},
+    {"declenchement simultane",  20, 0,        false, false, false, 1},
+    {"grand parc simultane",     60, 0,        false, false, false, 1},
+    {"cache local",              20, 0,        true,  false, false, 0},
+    {"plantage du meneur",       20, 0,        false, true,  false, 2},
+    {"pair corrompu",            20, 0,        false, false, true,  2},
+  };
+
+  bool ok = true;
+  printf("%-26s %4s %8s %8s %10s %8s\n", "scenario", "parc", "origine", "a jour", "dernier s", "verif");
+  for (const Scenario &sc : scenarios) {
+    Resultat r = joue(sc);
+    bool bon = r.misAJour == sc.nb && r.origine <= sc.origineMax;
+    if (sc.pairCorrompu) bon = bon && r.echecsVerif > 0;
+    ok = ok && bon;
+    printf("%-26s %4d %8d %8d %10.0f %8d  %s\n", sc.nom, sc.nb, r.origine, r.misAJour,
+           r.dernierMs / 1000.0, r.echecsVerif, bon ? "ok" : "ECHEC");
+  }
+  printf(ok ? "OK\n" : "ECHEC\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+// Simulation hôte de la préchauffe prédictive (include/prechauffe.h)
+// Sans apprentissage, la consigne est comparée à tempCibleProgramme() sur
+// les 1440 minutes de plusieurs programmes. Puis un tapis chauffant
+// (premier ordre, lent devant fadeDuration), une sonde avec retard, bruit
+// et quantification 12 bits et le Thermostat du firmware tournent plusieurs
+// jours, Prechauffe appelé comme updatePrechauffe() : échantillon à chaque
+// mesure, suivi des transitions, consigne à chaque pas.
+// L'arrivée au plateau est relevée par la simulation elle-même, sur la
+// mesure, et comparée à celle de la courbe programmée d'origine.
+//
+//   g++ -std=gnu++17 -O2 -Iinclude tools/sim_prechauffe.cpp src/prechauffe.cpp src/controle.cpp -o sim_prechauffe
+//   ./sim_prechauffe
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "prechauffe.h"
+#include "controle.h"
+#include "capteur.h"
+
+// Modèle thermique (°C, s) : passer de 22 à 28 °C prend environ une heure,
+// bien plus que fadeDuration
+const double T_AMBIANTE = 16.0;
+const double TAU_TAPIS = 3600.0;
+const double GAIN_CHAUFFE = 16.0;   // élévation à l'équilibre relais fermé
+const double TAU_SONDE = 20.0;
+const double BRUIT = 0.02;
+
+const uint32_t PAS_MS = 1000;       // une mesure par seconde, comme le 12 bits
+const int JOURS = 12;
+const int JOURS_REGIME = 3;         // derniers jours : apprentissage terminé
+
+const int ARRIVEE_TOLERANCE = 5;    // arrivée mesurée à 5 min de l'arrivée programmée
+const int RETARD_STABLE = 2;        // variation du retard appris en régime (min)
+
+static const int MINUTES_JOUR = 24 * 60;
+
+static double gauss() {
+  double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+  return sqrt(-2.0 * log(u)) * cos(2 * M_PI * v);
+}
+
+static centi_t programmeOrigine(int minute, const Programme &p) {
+  return tempCibleProgramme(minute, p.minuteDay, p.tempDay, p.minuteNight, p.tempNight,
+                            p.fadeDuration);
+}
+
+// Sans apprentissage : consigne identique à tempCibleProgramme()
+static bool verifieSansApprentissage(const Programme &p) {
+  Prechauffe pc;
+  pc.reset();
+  for (int m = 0; m < MINUTES_JOUR; m++) {
+    centi_t a = pc.consigne(m, p), b = programmeOrigine(m, p);
+    if (a != b) {
+      printf("  minute %d : consigne %d, programme %d\n", m, a, b);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Minute où la courbe programmée d'origine entre dans la tolérance du
+// plateau, relevée sur la courbe elle-même
+static int arriveeProgrammee(Transition t, const Programme &p) {
+  int debut = t == TransitionJour ? p.minuteDay : p.minuteNight;
+  centi_t plateau = t == TransitionJour ? p.tempDay : p.tempNight;
+  for (int i = 0; i < MINUTES_JOUR; i++) {
+    int m = (debut + i) % MINUTES_JOUR;
+    if (abs(programmeOrigine(m, p) - plateau) <= PRECHAUFFE_TOLERANCE) return m;
+  }
+  return debut;
+}
+
+struct Journee {
+  int ecart[2];      // arrivée mesurée - arrivée programmée (min), ECART_INCONNU si absente
+  int16_t retard[2]; // retard appris en fin de journée
+};
+
+static void simule(const Programme &p, Journee *jours) {
+  srand(1);
+  double tapis = programmeOrigine(0, p) / 100.0, sonde = tapis;   // en régime à minuit
+  bool relais = false;
+  Thermostat thermostat;
+  thermostat.reset();
+  Prechauffe pc;
+  pc.reset();
+
+  int arrivee[2] = {arriveeProgrammee(TransitionJour, p), arriveeProgrammee(TransitionNuit, p)};
+  // Suivi propre à la simulation : transition en attente d'arrivée au plateau
+  bool attend[2] = {false, false};
+  int attenteDepuis[2] = {0, 0};
+
+  for (int jour = 0; jour < JOURS; jour++) {
+    Journee &j = jours[jour];
+    j.ecart[0] = j.ecart[1] = ECART_INCONNU;
+    for (uint32_t s = 0; s < 86400; s++) {
+      uint32_t ms = (uint32_t)jour * 86400000u + s * PAS_MS;
+      int minute = (int)(s / 60);
+      double dt = PAS_MS / 1000.0;
+      double equilibre = T_AMBIANTE + (relais ? GAIN_CHAUFFE : 0);
+      tapis += (equilibre - tapis) * dt / TAU_TAPIS;
+      sonde += (tapis - sonde) * dt / TAU_SONDE;
+      int32_t raw = (int32_t)lround((sonde + BRUIT * gauss()) * 128);
+      centi_t mesure = rawToCenti(masqueRaw(raw, 12));
+
+      // Comme loop() : consigne, décision du relais, apprentissage
+      centi_t cible = pc.consigne(minute, p);
+      relais = thermostat.decide(mesure, cible, ms);
+      pc.echantillon(mesure, relais, ms);
+      pc.suivi(minute, mesure, p);
+
+      // Arrivée mesurée : première minute dans la tolérance du plateau
+      // après le début de la rampe (apprise) de chaque transition
+      for (int t = TransitionJour; t <= TransitionNuit; t++) {
+        int debut, duree;
+        pc.rampe((Transition)t, p, debut, duree);
+        if (!attend[t] && minute == debut && s % 60 == 0) {
+          attend[t] = true;
+          attenteDepuis[t] = minute;
+        }
+        centi_t plateau = t == TransitionJour ? p.tempDay : p.tempNight;
+        if (attend[t] && abs(mesure - plateau) <= PRECHAUFFE_TOLERANCE) {
+          attend[t] = false;
+          int ecart = ((minute - arrivee[t]) % MINUTES_JOUR + MINUTES_JOUR) % MINUTES_JOUR;
+          if (ecart > MINUTES_JOUR / 2) ecart -= MINUTES_JOUR;
+          j.ecart[t] = ecart;
+        } else if (attend[t] && (minute - attenteDepuis[t] + MINUTES_JOUR) % MINUTES_JOUR > 600) {
+          attend[t] = false;
+        }
+      }
+    }
+    j.retard[0] = pc.retard[TransitionJour];
+    j.retard[1] = pc.retard[TransitionNuit];
+  }
+}
+
+int main() {
+  bool ok = true;
+
+  // Programmes : jour avant nuit, nuit avant jour (passage de minuit),
+  // fondu nul, jour plus froid que la nuit
+  const Programme programmes[] = {
+    // minuteDay  tempDay  minuteNight  tempNight  fadeDuration
+    {7 * 60,      2800,    21 * 60,     2200,      30},
+    {22 * 60,     2600,    6 * 60,      2000,      45},
+    {8 * 60 + 30, 2500,    20 * 60,     2100,      0},
+    {9 * 60,      1900,    23 * 60,     2400,      60},
+  };
+  for (const Programme &p : programmes) {
+    bool sans = verifieSansApprentissage(p);
+    printf("sans apprentissage %02d:%02d-%02d:%02d : %s\n", p.minuteDay / 60, p.minuteDay % 60,
+           p.minuteNight / 60, p.minuteNight % 60, sans ? "= tempCibleProgramme" : "DIFFERENT");
+    ok = ok && sans;
+  }
+
+  // Critères, sur les programmes suivis (écart jour/nuit de plus de
+  // PRECHAUFFE_ECART_MIN) : la chauffe arrive d'abord en retard (le tapis
+  // ne suit pas la rampe d'origine) ; en régime le retard appris ne bouge
+  // plus et la mesure arrive au plateau à l'heure programmée, à la
+  // tolérance près
+  for (int n = 0; n < 2; n++) {
+    const Programme &p = programmes[n];
+    Journee jours[JOURS];
+    simule(p, jours);
+    printf("programme %02d:%02d-%02d:%02d\n", p.minuteDay / 60, p.minuteDay % 60,
+           p.minuteNight / 60, p.minuteNight % 60);
+    printf("jour  ecart jour  ecart nuit  retard jour  retard nuit (min)\n");
+    for (int i = 0; i < JOURS; i++) {
+      printf("%4d  %10d  %10d  %11d  %11d\n", i + 1, jours[i].ecart[0], jours[i].ecart[1],
+             jours[i].retard[0], jours[i].retard[1]);
+    }
+    ok = ok && jours[0].ecart[TransitionJour] > ARRIVEE_TOLERANCE;
+    for (int i = JOURS - JOURS_REGIME; i < JOURS; i++) {
+      for (int t = TransitionJour; t <= TransitionNuit; t++) {
+        ok = ok && jours[i].ecart[t] != ECART_INCONNU && abs(jours[i].ecart[t]) <= ARRIVEE_TOLERANCE
+                && abs(jours[i].retard[t] - jours[i - 1].retard[t]) <= RETARD_STABLE;
+      }
+    }
+  }
+  printf(ok ? "OK\n" : "ECHEC\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+// Simulation hôte du superviseur de sécurité
+// Reproduit l'ordonnancement du firmware : loop() transmet une mesure à
+// chaque conversion et sa demande de chauffe, la tâche superviseur applique
+// les règles toutes les SUPERVISEUR_PERIODE_MS. Des blocages de la boucle,
+// une surchauffe, une sonde absente et une marche continue sont injectés ;
+// chaque scénario vérifie que le relais retombe dans la borne garantie.
+//
+//   g++ -std=gnu++17 -O2 -Iinclude tools/sim_superviseur.cpp src/securite.cpp -o sim_superviseur
+//   ./sim_superviseur
+
+#include <stdio.h>
+#include "securite.h"
+
+// Valeurs du firmware (include/superviseur.h, include/capteur.h)
+const uint32_t PERIODE_MS = 500;
+const uint32_t MESURE_MS = 762;       // 12 bits, cas le plus lent
+const uint32_t PAS_MS = 10;
+
+// Borne de réaction sur blocage : dernière mesure -> relais ouvert
+const uint32_t BORNE_BLOCAGE_MS = SECURITE_FRAICHEUR_MS + PERIODE_MS;
+
+struct Scenario {
+  const char *nom;
+  uint32_t dureeMs;
+  uint32_t blocageDebut, blocageFin;   // boucle figée (ni mesure ni demande)
+  uint32_t sondeAbsenteMs;             // plus de mesure valide à partir de
+  centi_t rampeTemp;                   // centièmes par seconde ajoutés à partir de 60 s
+};
+
+struct Resultat {
+  bool coupe;              // relais retombé pendant l'incident
+  uint32_t reactionMs;     // depuis la dernière mesure ou le franchissement
+  uint32_t coupuresHors;   // coupures hors incident (fausses alarmes)
+  uint32_t marcheMaxMs;    // plus longue marche continue
+};
+
+static Resultat joue(const Scenario &sc, uint32_t phaseSuperviseur) {
+  Securite s;
+  s.reset();
+  Resultat r = {false, 0, 0, 0};
+  uint32_t derniereMesure = 0, prochaineMesure = 0, incidentMs = 0, marcheDepuis = 0;
+  bool incident = false, relaisPrec = false;
+  centi_t temp = 2500;
+
+  for (uint32_t ms = 0; ms < sc.dureeMs; ms += PAS_MS) {
+    bool bloque = ms >= sc.blocageDebut && ms < sc.blocageFin;
+    if (ms >= 60000 && ms % 1000 == 0) temp += sc.rampeTemp;
+
+    // loop() : mesure puis demande, sauf pendant le blocage
+    if (!bloque && ms >= prochaineMesure) {
+      prochaineMesure = ms + MESURE_MS;
+      if (sc.sondeAbsenteMs == 0 || ms < sc.sondeAbsenteMs) {
+        s.mesure(temp, ms);
+        derniereMesure = ms;
+        s.decide(ms);
+      }
+      bool change = !s.demande;
+      s.demande = true;   // la régulation demande toujours de chauffer
+      if (change) s.decide(ms);
+    }
+    // Tâche superviseur
+    if (ms % PERIODE_MS == phaseSuperviseur) s.decide(ms);
+
+    // Début d'incident : blocage, sonde absente ou franchissement du seuil
+    if (!incident && (bloque || (sc.sondeAbsenteMs && ms >= sc.sondeAbsenteMs) ||
+                      temp >= SECURITE_TEMP_MAX)) {
+      incident = true;
+      incidentMs = temp >= SECURITE_TEMP_MAX ? ms : derniereMesure;
+    }
+
+    if (s.relais && !relaisPrec) marcheDepuis = ms;
+    if (s.relais && ms - marcheDepuis > r.marcheMaxMs) r.marcheMaxMs = ms - marcheDepuis;
+    if (!s.relais && relaisPrec) {
+      if (incident && !r.coupe) {
+        r.coupe = true;
+        r.reactionMs = ms - incidentMs;
+      } else if (!incident && ms > 10000) {
+        r.coupuresHors++;
+      }
+    }
+    relaisPrec = s.relais;
+  }
+  return r;
+}
+
+int main() {
+  const Scenario scenarios[] = {
+    // nom                      durée      blocage            absente  rampe
+    {"blocage 3 s (tolere)",    120000,    60000,  63000,     0,       0},
+    {"blocage 30 s",            120000,    60000,  90000,     0,       0},
+    {"blocage 10 min",          900000,    60000,  660000,    0,       0},
+    {"sonde absente",           120000,    0,      0,         60000,   0},
+    {"surchauffe",              300000,    0,      0,         0,       20},
+    {"marche continue",         4UL * 3600 * 1000, 0, 0,      0,       0},
+  };
+  bool ok = true;
+
+  for (const Scenario &sc : scenarios) {
+    // Pire cas sur toutes les phases de la tâche par rapport aux mesures
+    Resultat pire = {true, 0, 0, 0};
+    for (uint32_t phase = 0; phase < PERIODE_MS; phase += 50) {
+      Resultat r = joue(sc, phase);
+      pire.coupe = pire.coupe && r.coupe;
+      if (r.reactionMs > pire.reactionMs) pire.reactionMs = r.reactionMs;
+      if (r.coupuresHors > pire.coupuresHors) pire.coupuresHors = r.coupuresHors;
+      if (r.marcheMaxMs > pire.marcheMaxMs) pire.marcheMaxMs = r.marcheMaxMs;
+    }
+
+    bool attendu;
+    if (sc.blocageFin - sc.blocageDebut != 0 && sc.blocageFin - sc.blocageDebut < SECURITE_FRAICHEUR_MS) {
+      // Blocage court : pas de coupure intempestive
+      attendu = !pire.coupe && pire.coupuresHors == 0;
+    } else if (sc.rampeTemp) {
+      // Surchauffe : coupure à la mesure qui franchit le seuil
+      attendu = pire.coupe && pire.reactionMs <= MESURE_MS;
+    } else if (sc.dureeMs > SECURITE_MARCHE_MAX_MS) {
+      attendu = pire.marcheMaxMs <= SECURITE_MARCHE_MAX_MS + PERIODE_MS && pire.coupuresHors >= 1;
+    } else {
+      attendu = pire.coupe && pire.reactionMs <= BORNE_BLOCAGE_MS && pire.coupuresHors == 0;
+    }
+    ok = ok && attendu;
+    printf("%-24s coupe %-3s reaction %5u ms (borne %u)  coupures hors incident %u  marche max %lu s  %s\n",
+           sc.nom, pire.coupe ? "oui" : "non", pire.reactionMs, BORNE_BLOCAGE_MS,
+           pire.coupuresHors, (unsigned long)(pire.marcheMaxMs / 1000), attendu ? "ok" : "ECHEC");
+  }
+  printf(ok ? "OK\n" : "ECHEC\n");
+  return ok ? 0 : 1;
+}
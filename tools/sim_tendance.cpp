@@ -0,0 +1,163 @@
+// Vérification hôte des statistiques glissantes et de la courbe de tendance
+// Des séries de mesures (marche aléatoire, relais à hystérésis, cadence
+// irrégulière, trous de quelques minutes et de plus de 24 h, températures
+// négatives) alimentent Tendance ; à intervalles réguliers, chaque fenêtre
+// et chaque colonne de la courbe sont comparées à un recalcul complet sur
+// l'historique brut. Le coût par mesure des deux méthodes est affiché.
+//
+//   g++ -std=gnu++17 -O2 -Iinclude tools/sim_tendance.cpp src/tendance.cpp -o sim_tendance
+//   ./sim_tendance
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+#include "tendance.h"
+
+struct Mesure {
+  uint32_t temps;
+  centi_t temp, cible;
+  bool relais;
+};
+
+static Tendance tendance;   // environ 8 Ko : hors de la pile
+
+// Recalcul complet : mesures des cases [index - n, index]
+static StatsTendance reference(const std::vector<Mesure> &h, uint32_t dureeCase, uint32_t n) {
+  StatsTendance s = {0, INT16_MAX, INT16_MIN, 0, 0};
+  if (h.empty()) return {0, 0, 0, 0, 0};
+  uint32_t index = h.back().temps / dureeCase;
+  int64_t somme = 0;
+  uint32_t relais = 0;
+  for (size_t i = h.size(); i-- > 0;) {
+    uint32_t c = h[i].temps / dureeCase;
+    if (c + n < index) break;
+    s.mesures++;
+    somme += h[i].temp;
+    if (h[i].temp < s.min) s.min = h[i].temp;
+    if (h[i].temp > s.max) s.max = h[i].temp;
+    if (h[i].relais) relais++;
+  }
+  int64_t demi = s.mesures / 2;
+  s.moy = (centi_t)((somme >= 0 ? somme + demi : somme - demi) / (int64_t)s.mesures);
+  s.pourmilleRelais = (uint16_t)((uint64_t)relais * 1000 / s.mesures);
+  return s;
+}
+
+static bool compareStats(const char *nom, const StatsTendance &a, const StatsTendance &r, uint32_t t) {
+  if (a.mesures == r.mesures && a.min == r.min && a.max == r.max && a.moy == r.moy &&
+      a.pourmilleRelais == r.pourmilleRelais) {
+    return true;
+  }
+  printf("  %s t=%lu : mesures %lu/%lu min %d/%d max %d/%d moy %d/%d relais %u/%u\n", nom,
+         (unsigned long)t, (unsigned long)a.mesures, (unsigned long)r.mesures, a.min, r.min,
+         a.max, r.max, a.moy, r.moy, a.pourmilleRelais, r.pourmilleRelais);
+  return false;
+}
+
+static bool compareCourbe(const std::vector<Mesure> &h, uint32_t t) {
+  uint32_t index = h.back().temps / TENDANCE_COLONNE_S;
+  ColonneTendance attendu[TENDANCE_COLONNES];
+  for (int x = 0; x < TENDANCE_COLONNES; x++) attendu[x].vide();
+  for (size_t i = h.size(); i-- > 0;) {
+    uint32_t c = h[i].temps / TENDANCE_COLONNE_S;
+    if (c + TENDANCE_COLONNES <= index) break;
+    ColonneTendance &a = attendu[TENDANCE_COLONNES - 1 - (index - c)];
+    if (h[i].temp < a.actMin) a.actMin = h[i].temp;
+    if (h[i].temp > a.actMax) a.actMax = h[i].temp;
+    if (h[i].cible < a.cibleMin) a.cibleMin = h[i].cible;
+    if (h[i].cible > a.cibleMax) a.cibleMax = h[i].cible;
+  }
+  for (int x = 0; x < TENDANCE_COLONNES; x++) {
+    const ColonneTendance &c = tendance.courbe.colonne(x);
+    const ColonneTendance &a = attendu[x];
+    if (c.actMin != a.actMin || c.actMax != a.actMax || c.cibleMin != a.cibleMin ||
+        c.cibleMax != a.cibleMax) {
+      printf("  courbe t=%lu colonne %d : act %d..%d/%d..%d cible %d..%d/%d..%d\n",
+             (unsigned long)t, x, c.actMin, c.actMax, a.actMin, a.actMax, c.cibleMin,
+             c.cibleMax, a.cibleMin, a.cibleMax);
+      return false;
+    }
+  }
+  return true;
+}
+
+struct Scenario {
+  const char *nom;
+  uint32_t dureeS;
+  centi_t base;            // température de départ
+  uint32_t trouDebut, trouS;   // pas de mesure pendant trouS à partir de trouDebut
+  uint32_t pasMaxS;        // mesures espacées de 1 à pasMaxS s
+};
+
+static double secondes() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool joue(const Scenario &sc, unsigned graine) {
+  srand(graine);
+  tendance.reset();
+  std::vector<Mesure> h;
+  uint32_t t = 1767225600;   // 01/01/2026, temps local du firmware
+  const uint32_t fin = t + sc.dureeS;
+  centi_t temp = sc.base, cible = sc.base;
+  bool relais = false, ok = true;
+  uint32_t verifications = 0;
+  double incrementalS = 0, completS = 0;
+
+  while (t < fin && ok) {
+    t += 1 + rand() % sc.pasMaxS;
+    if (sc.trouS && t >= fin - sc.dureeS + sc.trouDebut && t < fin - sc.dureeS + sc.trouDebut + sc.trouS) {
+      continue;
+    }
+    // Consigne par paliers, mesure qui suit le relais avec du bruit
+    if (rand() % 3000 == 0) cible = (centi_t)(sc.base + (rand() % 800) - 400);
+    relais = relais ? temp < cible + 20 : temp < cible - 20;
+    temp = (centi_t)(temp + (relais ? 2 : -2) + (rand() % 7) - 3);
+
+    Mesure m = {t, temp, cible, relais};
+    h.push_back(m);
+    double d = secondes();
+    tendance.ajoute(t, temp, cible, relais);
+    StatsTendance heure = tendance.heure.stats();
+    StatsTendance jour = tendance.jour.stats();
+    incrementalS += secondes() - d;
+
+    if (h.size() % 97 == 0 || t >= fin) {
+      d = secondes();
+      StatsTendance refHeure = reference(h, TENDANCE_CASE_HEURE_S, TENDANCE_CASES_HEURE);
+      StatsTendance refJour = reference(h, TENDANCE_CASE_JOUR_S, TENDANCE_CASES_JOUR);
+      completS += secondes() - d;
+      ok = compareStats("1h", heure, refHeure, t) && compareStats("24h", jour, refJour, t) &&
+           compareCourbe(h, t);
+      verifications++;
+    }
+  }
+  StatsTendance j = tendance.jour.stats();
+  printf("%-24s %7zu mesures  %5lu verifications  %6.0f ns/mesure (recalcul %8.0f ns)"
+         "  24h %d..%d moy %d relais %u/1000  %s\n",
+         sc.nom, h.size(), (unsigned long)verifications, incrementalS * 1e9 / h.size(),
+         verifications ? completS * 1e9 / verifications : 0.0, j.min, j.max, j.moy,
+         j.pourmilleRelais, ok ? "ok" : "ECHEC");
+  return ok;
+}
+
+int main() {
+  const Scenario scenarios[] = {
+    // nom                       durée         base   trou début    durée     pas
+    {"3 jours continus",         3 * 86400,    2500,  0,            0,        2},
+    {"trou de 7 min",            2 * 86400,    2200,  30 * 3600,    420,      2},
+    {"trou de 30 h",             3 * 86400,    2500,  20 * 3600,    30 * 3600, 2},
+    {"temperatures negatives",   36 * 3600,    -500,  0,            0,        3},
+    {"mesures rares",            2 * 86400,    2000,  0,            0,        40},
+    {"demarrage",                90,           2500,  0,            0,        1},
+  };
+  bool ok = true;
+  unsigned graine = 1;
+  for (const Scenario &sc : scenarios) ok = joue(sc, graine++) && ok;
+  printf("memoire %zu octets\n", sizeof(Tendance));
+  printf(ok ? "OK\n" : "ECHEC\n");
+  return ok ? 0 : 1;
+}
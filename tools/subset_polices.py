@@ -0,0 +1,383 @@
+#!/usr/bin/env python3
+"""Sous-ensemble des polices U8g2 réellement dessinées par le firmware.
+
+Script PlatformIO (extra_scripts = pre:tools/subset_polices.py) ou outil
+autonome. Pour chaque police sélectionnée par setFont() dans src/*.cpp, on
+relève les glyphes dessinés :
+  - littéraux passés à drawStr() / getStrWidth(),
+  - codes passés à drawGlyph(),
+  - textes dynamiques : annotation obligatoire en fin de ligne
+      // glyphes: 0123456789.{espace}{charSet}{tableau:menuItems}{ascii}
+    {charSet}     caractères du tableau charSet
+    {tableau:NOM} littéraux de l'initialiseur du tableau NOM
+    {ascii}       caractères imprimables 32..126
+    {espace}      le caractère espace
+La police courante est la dernière setFont() de la fonction : une fonction
+qui dessine sans setFont() préalable est refusée.
+
+Les polices sont ensuite réduites à ces glyphes (format U8g2, table 8 bits
+reconstruite, partie unicode recopiée telle quelle) et écrites dans
+$BUILD_DIR/polices (polices_subset.c/.h), compilées à la place des polices
+complètes via -D POLICES_SUBSET. Le build échoue si un glyphe dessiné est
+absent de la police source ou si un texte dynamique n'est pas annoté.
+
+Usage autonome :
+  python3 tools/subset_polices.py --u8g2 chemin/u8g2_fonts.c [--sortie dossier]
+"""
+
+import os
+import re
+import sys
+
+RACINE = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+TAILLE_ENTETE = 23  # U8G2_FONT_DATA_STRUCT_SIZE
+
+
+class Erreur(Exception):
+    pass
+
+
+# ---------------------------------------------------------------------------
+# Littéraux C
+# ---------------------------------------------------------------------------
+
+RE_LITTERAL = re.compile(r'"((?:[^"\\]|\\.)*)"')
+
+ECHAPPEMENTS = {"n": 10, "t": 9, "r": 13, "a": 7, "b": 8, "f": 12, "v": 11,
+                "\\": 92, '"': 34, "'": 39, "?": 63}
+
+
+def decode_c(texte):
+    """Octets d'un littéral C (sans les guillemets)."""
+    res = bytearray()
+    i = 0
+    while i < len(texte):
+        c = texte[i]
+        if c != "\\":
+            res += c.encode("utf-8")
+            i += 1
+            continue
+        i += 1
+        c = texte[i]
+        if c in "01234567":
+            j = i
+            while j < len(texte) and j < i + 3 and texte[j] in "01234567":
+                j += 1
+            res.append(int(texte[i:j], 8) & 0xFF)
+            i = j
+        elif c == "x":
+            j = i + 1
+            while j < len(texte) and texte[j] in "0123456789abcdefABCDEF":
+                j += 1
+            res.append(int(texte[i + 1:j], 16) & 0xFF)
+            i = j
+        else:
+            res.append(ECHAPPEMENTS[c])
+            i += 1
+    return bytes(res)
+
+
+def litteraux(texte):
+    return [decode_c(m.group(1)) for m in RE_LITTERAL.finditer(texte)]
+
+
+def sans_commentaire(ligne):
+    """Retire le commentaire // d'une ligne (hors littéraux)."""
+    dans_chaine = False
+    i = 0
+    while i < len(ligne):
+        c = ligne[i]
+        if c == "\\" and dans_chaine:
+            i += 2
+            continue
+        if c == '"':
+            dans_chaine = not dans_chaine
+        elif not dans_chaine and ligne.startswith("//", i):
+            return ligne[:i], ligne[i + 2:]
+        i += 1
+    return ligne, ""
+
+
+def arguments(ligne, debut):
+    """Texte entre la parenthèse ouvrante en debut et sa fermante."""
+    niveau = 0
+    dans_chaine = False
+    i = debut
+    while i < len(ligne):
+        c = ligne[i]
+        if c == "\\" and dans_chaine:
+            i += 2
+            continue
+        if c == '"':
+            dans_chaine = not dans_chaine
+        elif not dans_chaine:
+            if c == "(":
+                niveau += 1
+            elif c == ")":
+                niveau -= 1
+                if niveau == 0:
+                    return ligne[debut + 1:i]
+        i += 1
+    raise Erreur("appel sur plusieurs lignes non supporté")
+
+
+def dernier_argument(args):
+    niveau = 0
+    dans_chaine = False
+    dernier = 0
+    for i, c in enumerate(args):
+        if c == '"':
+            dans_chaine = not dans_chaine
+        elif not dans_chaine:
+            if c in "([":
+                niveau += 1
+            elif c in ")]":
+                niveau -= 1
+            elif c == "," and niveau == 0:
+                dernier = i + 1
+    return args[dernier:].strip()
+
+
+# ---------------------------------------------------------------------------
+# Relevé des glyphes dans les sources
+# ---------------------------------------------------------------------------
+
+RE_FONCTION = re.compile(r"^[A-Za-z_][\w:<>,\s\*&]*\([^;]*\)\s*(const\s*)?\{\s*$")
+RE_SETFONT = re.compile(r"setFont\(\s*(u8g2_font_\w+)\s*\)")
+RE_APPEL = re.compile(r"\b(drawStr|getStrWidth|drawGlyph)\s*\(")
+RE_ANNOTATION = re.compile(r"glyphes:\s?(.*)$")
+
+
+def tableau(sources, nom):
+    """Littéraux de l'initialiseur 'nom[] = { ... };', 'nom = { ... };' ou 'nom[] = "...";'."""
+    motif = re.compile(r"\b%s\s*(\[\s*\w*\s*\])?\s*=\s*(\{.*?\}|\"(?:[^\"\\]|\\.)*\")\s*;" % re.escape(nom), re.S)
+    for _, texte in sources:
+        m = motif.search(texte)
+        if m:
+            return b"".join(litteraux(m.group(2)))
+    raise Erreur("tableau '%s' introuvable" % nom)
+
+
+def annotation(spec, sources):
+    res = bytearray()
+    i = 0
+    while i < len(spec):
+        if spec[i] == "{":
+            fin = spec.index("}", i)
+            mot = spec[i + 1:fin]
+            if mot == "espace":
+                res += b" "
+            elif mot == "ascii":
+                res += bytes(range(32, 127))
+            elif mot == "charSet":
+                res += tableau(sources, "charSet")
+            elif mot.startswith("tableau:"):
+                res += tableau(sources, mot[len("tableau:"):])
+            else:
+                raise Erreur("mot-clé d'annotation inconnu {%s}" % mot)
+            i = fin + 1
+        else:
+            res += spec[i].encode("utf-8")
+            i += 1
+    return bytes(res)
+
+
+def glyphes_utilises(sources):
+    """{police: set(codes)} pour l'ensemble des sources."""
+    polices = {}
+    for chemin, texte in sources:
+        police = None
+        for num, brut in enumerate(texte.splitlines(), 1):
+            ou = "%s:%d" % (os.path.relpath(chemin, RACINE), num)
+            if RE_FONCTION.match(brut):
+                police = None
+            code, commentaire = sans_commentaire(brut)
+            m = RE_SETFONT.search(code)
+            if m:
+                police = m.group(1)
+                polices.setdefault(police, set())
+            for appel in RE_APPEL.finditer(code):
+                if police is None:
+                    raise Erreur("%s: %s sans setFont() préalable dans la fonction" % (ou, appel.group(1)))
+                args = arguments(code, appel.end() - 1)
+                arg = dernier_argument(args) if appel.group(1) != "getStrWidth" else args.strip()
+                ann = RE_ANNOTATION.search(commentaire)
+                if appel.group(1) == "drawGlyph":
+                    try:
+                        polices[police].add(int(arg, 0))
+                    except ValueError:
+                        if not ann:
+                            raise Erreur("%s: drawGlyph dynamique sans annotation glyphes" % ou)
+                        polices[police].update(annotation(ann.group(1).rstrip(), sources))
+                    continue
+                lits = litteraux(arg)
+                if lits:
+                    for lit in lits:
+                        polices[police].update(lit)
+                elif ann:
+                    polices[police].update(annotation(ann.group(1).rstrip(), sources))
+                else:
+                    raise Erreur("%s: texte dynamique sans annotation '// glyphes: ...'" % ou)
+    return polices
+
+
+# ---------------------------------------------------------------------------
+# Format de police U8g2
+# ---------------------------------------------------------------------------
+
+def charge_police(u8g2_c, nom):
+    m = re.search(r"const uint8_t %s\[\d+\][^=]*=\s*((?:\"(?:[^\"\\]|\\.)*\"\s*)+);" % re.escape(nom), u8g2_c)
+    if not m:
+        raise Erreur("police %s introuvable dans u8g2_fonts.c" % nom)
+    return b"".join(litteraux(m.group(1)))
+
+
+def mot(data, i):
+    return (data[i] << 8) | data[i + 1]
+
+
+def sous_ensemble(data, codes):
+    """Police réduite aux glyphes 8 bits de 'codes' ; retourne (octets, manquants)."""
+    entete = bytearray(data[:TAILLE_ENTETE])
+    glyphes = data[TAILLE_ENTETE:]
+    pos_unicode = mot(entete, 21)
+
+    # Parcours de la liste 8 bits (encodage, saut, données)
+    gardes = []
+    presents = set()
+    p = 0
+    while glyphes[p + 1] != 0:
+        enc, saut = glyphes[p], glyphes[p + 1]
+        presents.add(enc)
+        if enc in codes:
+            gardes.append((enc, glyphes[p:p + saut]))
+        p += saut
+    fin_8bits = p
+    queue = glyphes[fin_8bits:]  # terminateur + partie unicode, recopiés tels quels
+
+    manquants = sorted(c for c in codes if c not in presents and c <= 255)
+    manquants += sorted(c for c in codes if c > 255)  # unicode non géré par drawStr
+
+    corps = bytearray()
+    pos_A = pos_a = None
+    for enc, octets in gardes:
+        if pos_A is None and enc >= ord("A"):
+            pos_A = len(corps)
+        if pos_a is None and enc >= ord("a"):
+            pos_a = len(corps)
+        corps += octets
+    if pos_A is None:
+        pos_A = len(corps)
+    if pos_a is None:
+        pos_a = len(corps)
+    delta = fin_8bits - len(corps)
+
+    entete[0] = len(gardes)
+    entete[17:19] = bytes([pos_A >> 8, pos_A & 0xFF])
+    entete[19:21] = bytes([pos_a >> 8, pos_a & 0xFF])
+    if pos_unicode >= fin_8bits:
+        pos_unicode -= delta
+    entete[21:23] = bytes([pos_unicode >> 8, pos_unicode & 0xFF])
+    return bytes(entete) + bytes(corps) + bytes(queue), manquants
+
+
+def ecrit_sorties(dossier, reduites):
+    os.makedirs(dossier, exist_ok=True)
+    c = ["// Généré par tools/subset_polices.py : ne pas modifier", "", "#include <stdint.h>", ""]
+    h = ["// Généré par tools/subset_polices.py : ne pas modifier", "",
+         "#pragma once", "", "#include <stdint.h>", "",
+         "#ifdef __cplusplus", 'extern "C" {', "#endif"]
+    for nom, octets in sorted(reduites.items()):
+        lignes = []
+        for i in range(0, len(octets), 16):
+            lignes.append("  " + ",".join("%d" % b for b in octets[i:i + 16]))
+        c.append("const uint8_t %s_sub[%d] = {\n%s\n};\n" % (nom, len(octets), ",\n".join(lignes)))
+        h.append("extern const uint8_t %s_sub[%d];" % (nom, len(octets)))
+    h += ["#ifdef __cplusplus", "}", "#endif", ""]
+    for nom in sorted(reduites):
+        h.append("#define %s %s_sub" % (nom, nom))
+    with open(os.path.join(dossier, "polices_subset.c"), "w") as f:
+        f.write("\n".join(c))
+    with open(os.path.join(dossier, "polices_subset.h"), "w") as f:
+        f.write("\n".join(h) + "\n")
+
+
+def genere(u8g2_fonts_c, dossier):
+    sources = []
+    src = os.path.join(RACINE, "src")
+    for nom in sorted(os.listdir(src)):
+        if nom.endswith((".cpp", ".c", ".h")):
+            chemin = os.path.join(src, nom)
+            with open(chemin, encoding="utf-8") as f:
+                sources.append((chemin, f.read()))
+
+    polices = glyphes_utilises(sources)
+    with open(u8g2_fonts_c, encoding="latin-1") as f:
+        u8g2_c = f.read()
+
+    reduites = {}
+    total_avant = total_apres = 0
+    erreurs = []
+    print("Polices (octets complet -> sous-ensemble):")
+    for nom in sorted(polices):
+        complete = charge_police(u8g2_c, nom)
+        reduite, manquants = sous_ensemble(complete, polices[nom])
+        if manquants:
+            erreurs.append("%s: glyphe(s) absent(s) de la police : %s" % (
+                nom, " ".join("0x%02x" % c for c in manquants)))
+        reduites[nom] = reduite
+        total_avant += len(complete)
+        total_apres += len(reduite)
+        print("  %-40s %6d -> %6d  (%+d, %d glyphes)" % (
+            nom, len(complete), len(reduite), len(reduite) - len(complete), reduite[0]))
+    print("  %-40s %6d -> %6d  (%+d)" % ("total", total_avant, total_apres, total_apres - total_avant))
+    if erreurs:
+        raise Erreur("\n".join(erreurs))
+    ecrit_sorties(dossier, reduites)
+
+
+# ---------------------------------------------------------------------------
+# Points d'entrée
+# ---------------------------------------------------------------------------
+
+def sans_ecran(env):
+    """Profil relais (-D TARGET_RELAIS) : ni U8g2 ni polices."""
+    flags = env.GetProjectOption("build_flags", "")
+    if isinstance(flags, (list, tuple)):
+        flags = " ".join(flags)
+    return re.search(r"-D\s*TARGET_RELAIS\b", flags) is not None
+
+
+def main_pio(env):
+    if sans_ecran(env):
+        return
+    u8g2 = os.path.join(env.subst("$PROJECT_LIBDEPS_DIR"), env.subst("$PIOENV"),
+                        "U8g2", "src", "clib", "u8g2_fonts.c")
+    if not os.path.isfile(u8g2):
+        # Les lib_deps sont installées avant les scripts : sans U8g2 ici,
+        # le firmware ne serait pas celui mesuré et vérifié glyphe par glyphe
+        sys.stderr.write("subset_polices: %s absent (lib_deps U8g2 ?)\n" % u8g2)
+        env.Exit(1)
+    dossier = os.path.join(env.subst("$BUILD_DIR"), "polices")
+    try:
+        genere(u8g2, dossier)
+    except Erreur as e:
+        sys.stderr.write("subset_polices: %s\n" % e)
+        env.Exit(1)
+    env.Append(CPPPATH=[dossier], CPPDEFINES=["POLICES_SUBSET"])
+    env.BuildSources(os.path.join("$BUILD_DIR", "polices_obj"), dossier)
+
+
+if __name__ == "__main__":
+    args = sys.argv[1:]
+    if "--u8g2" not in args:
+        sys.exit(__doc__)
+    u8g2 = args[args.index("--u8g2") + 1]
+    dossier = args[args.index("--sortie") + 1] if "--sortie" in args else os.path.join(RACINE, ".pio", "polices")
+    try:
+        genere(u8g2, dossier)
+    except Erreur as e:
+        sys.exit("subset_polices: %s" % e)
+else:
+    Import("env")  # noqa: F821 (fourni par PlatformIO/SCons)
+    main_pio(env)  # noqa: F821
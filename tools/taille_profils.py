@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+"""Taille du firmware pour chaque profil de carte (include/profil.h).
+
+Construit chaque environnement PlatformIO (pio run -e ENV), relève flash
+et RAM dans le rapport de PlatformIO, puis répartit le flash de l'image
+d'après firmware.map : U8g2 (bibliothèque), polices, sources du firmware
+(src/) et le reste (framework, bibliothèques). L'écart de chaque profil au
+premier est affiché.
+
+Le temps de boucle se mesure sur l'appareil : champ boucle_us de la
+télémétrie (tools/decode_telemetrie.py) ou commande série "trace" d'un
+build -D TRACE_BOUCLE.
+
+Sans PlatformIO, --hote construit chaque profil pour l'hôte avec
+l'environnement du banc d'écrans (tools/banc_ecrans/hote, U8g2 prise dans
+U8G2_SRC comme banc_ecrans.sh), en -Os et --gc-sections comme le firmware,
+puis lance tools/banc_ecrans/boucle.cpp : une heure simulée de loop(),
+durée moyenne et p99 d'une itération. Tailles x86-64 et durées de l'hôte :
+elles comparent les profils entre eux, pas l'image de l'ESP32-C3.
+
+Exemples :
+  tools/taille_profils.py                          # seeed_xiao_esp32c3, wokwi, relais
+  tools/taille_profils.py seeed_xiao_esp32c3 relais
+  tools/taille_profils.py --sans-build --json tailles.json
+  U8G2_SRC=chemin/U8g2/src tools/taille_profils.py --hote
+"""
+
+import argparse
+import configparser
+import glob
+import json
+import os
+import re
+import shlex
+import subprocess
+import sys
+
+RACINE = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PROFILS = ["seeed_xiao_esp32c3", "wokwi", "relais"]
+
+# "RAM:   [=         ]  12.3% (used 40312 bytes from 327680 bytes)"
+RE_RAPPORT = re.compile(r"^(RAM|Flash):.*\(used (\d+) bytes from (\d+) bytes\)")
+
+# Entrée de section d'un fichier .map GNU ld, sur une ligne ou deux :
+#  .text.u8g2_DrawStr
+#                 0x42001234       0x2c lib/libU8g2.a(u8g2_font.c.o)
+RE_ENTREE = re.compile(r"^ (\.\S+)?\s+0x[0-9a-fA-F]+\s+0x([0-9a-fA-F]+)\s+(\S+)$")
+RE_SECTION = re.compile(r"^ (\.\S+)$")
+
+# "boucle iterations 39575 moyenne_ns 8711 mediane_ns 2028 p99_ns 20145 max_ns 2622203"
+RE_BOUCLE = re.compile(r"^boucle iterations (\d+) moyenne_ns (\d+) mediane_ns (\d+) p99_ns (\d+)")
+
+# Sections de l'image en flash (code et constantes, données initialisées)
+SECTIONS_FLASH = (".text", ".literal", ".rodata", ".srodata", ".iram", ".data", ".sdata",
+                  ".dram1")
+CATEGORIES = ["U8g2", "polices", "firmware", "autres"]
+
+
+def categorie(objet):
+    if "polices" in objet or "u8g2_fonts" in objet:
+        return "polices"
+    if "U8g2" in objet:
+        return "U8g2"
+    if "/src/" in objet:
+        return "firmware"
+    return "autres"
+
+
+def repartition(chemin_map):
+    """Octets en flash par catégorie d'après firmware.map."""
+    res = dict.fromkeys(CATEGORIES, 0)
+    section = None
+    with open(chemin_map, errors="replace") as f:
+        for ligne in f:
+            ligne = ligne.rstrip("\n")
+            if ligne.startswith("Linker script and memory map"):
+                section = ""
+                continue
+            if section is None:
+                continue   # avant la carte : membres d'archives, sections rejetées
+            m = RE_SECTION.match(ligne)
+            if m:
+                section = m.group(1)
+                continue
+            m = RE_ENTREE.match(ligne)
+            if not m:
+                continue
+            nom = m.group(1) or section
+            taille = int(m.group(2), 16)
+            if taille and nom.startswith(SECTIONS_FLASH):
+                res[categorie(m.group(3))] += taille
+            section = ""
+    return res
+
+
+def construit(env):
+    """Rapport flash/RAM de PlatformIO pour l'environnement."""
+    sortie = subprocess.run(["pio", "run", "-e", env], cwd=RACINE, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT, universal_newlines=True)
+    if sortie.returncode != 0:
+        sys.stderr.write(sortie.stdout)
+        raise SystemExit("pio run -e %s : échec" % env)
+    return rapport(sortie.stdout)
+
+
+def rapport(texte):
+    res = {}
+    for ligne in texte.splitlines():
+        m = RE_RAPPORT.match(ligne.strip())
+        if m:
+            res[m.group(1).lower()] = int(m.group(2))
+            res[m.group(1).lower() + "_max"] = int(m.group(3))
+    return res
+
+
+def mesure(env, build):
+    dossier = os.path.join(RACINE, ".pio", "build", env)
+    res = construit(env) if build else {}
+    chemin_map = os.path.join(dossier, "firmware.map")
+    if os.path.exists(chemin_map):
+        res.update(repartition(chemin_map))
+    image = os.path.join(dossier, "firmware.bin")
+    if os.path.exists(image):
+        res["image"] = os.path.getsize(image)
+    return res
+
+
+def options_env(env):
+    """build_flags de l'environnement dans platformio.ini."""
+    ini = configparser.ConfigParser(inline_comment_prefixes=(";",), interpolation=None)
+    ini.read(os.path.join(RACINE, "platformio.ini"))
+    section = "env:" + env
+    if not ini.has_section(section):
+        raise SystemExit("environnement inconnu : %s" % env)
+    return shlex.split(ini.get(section, "build_flags", fallback="").replace("-D ", "-D"))
+
+
+def compile_hote(source, objet, options):
+    os.makedirs(os.path.dirname(objet), exist_ok=True)
+    c = source.endswith(".c")
+    cmd = (["gcc", "-w"] if c else ["g++", "-std=gnu++17", "-Wall", "-Wextra"]) + options + [
+        "-Os", "-ffunction-sections", "-fdata-sections", "-c", source, "-o", objet]
+    if subprocess.call(cmd, cwd=RACINE) != 0:
+        raise SystemExit("compilation : %s" % source)
+
+
+def mesure_hote(env, u8g2):
+    """Construit le profil pour l'hôte, tailles d'après la carte, boucle chronométrée."""
+    dossier = os.path.join(RACINE, ".pio", "hote")
+    lib = os.path.join(dossier, "U8g2", "libU8g2.a")
+    if not os.path.exists(lib):
+        objets = []
+        for c in sorted(glob.glob(os.path.join(u8g2, "clib", "*.c"))):
+            o = os.path.join(dossier, "U8g2", os.path.basename(c)[:-2] + ".o")
+            compile_hote(c, o, ["-I" + os.path.join(u8g2, "clib")])
+            objets.append(o)
+        subprocess.check_call(["ar", "rcs", lib] + objets)
+
+    options = options_env(env) + ["-Itools/banc_ecrans/hote", "-isystem", u8g2, "-Iinclude",
+                                  "-include", "Arduino.h"]
+    construit_dans = os.path.join(dossier, env)
+    # boucle.cpp inclut main.cpp : son objet est compté avec les sources du firmware
+    sources = [("tools/banc_ecrans/boucle.cpp", "src/main.o"),
+               ("tools/banc_ecrans/hote/hote.cpp", "hote/hote.o")]
+    for f in sorted(glob.glob(os.path.join(RACINE, "src", "*.cpp"))):
+        nom = os.path.basename(f)
+        if nom != "main.cpp":
+            sources.append(("src/" + nom, "src/" + nom[:-4] + ".o"))
+    objets = []
+    for source, objet in sources:
+        objets.append(os.path.join(construit_dans, objet))
+        compile_hote(source, objets[-1], options)
+    executable = os.path.join(construit_dans, "boucle")
+    chemin_map = os.path.join(construit_dans, "boucle.map")
+    subprocess.check_call(["g++", "-Wl,--gc-sections", "-Wl,-Map," + chemin_map, "-o", executable]
+                          + objets + [lib])
+
+    res = repartition(chemin_map)
+    # text/data/bss du binaire : flash = code et données initialisées, RAM = données
+    texte, donnees, bss = [int(x) for x in subprocess.check_output(
+        ["size", executable], universal_newlines=True).splitlines()[1].split()[:3]]
+    res.update(image=os.path.getsize(executable), flash=texte + donnees, ram=donnees + bss)
+    for ligne in subprocess.check_output([executable], universal_newlines=True).splitlines():
+        m = RE_BOUCLE.match(ligne)
+        if m:
+            res.update(boucle_moy_ns=int(m.group(2)), boucle_p99_ns=int(m.group(4)))
+    return res
+
+
+def ecart(valeur, reference):
+    if valeur is None or reference is None:
+        return ""
+    d = valeur - reference
+    return "%+d" % d if d else ""
+
+
+def affiche(tailles):
+    colonnes = ["image", "flash", "ram"] + CATEGORIES
+    if any("boucle_moy_ns" in t for _, t in tailles):
+        colonnes += ["boucle_moy_ns", "boucle_p99_ns"]
+    print("%-20s" % "profil" + "".join("%16s" % c for c in colonnes))
+    reference = tailles[0][1] if tailles else {}
+    for i, (env, t) in enumerate(tailles):
+        print("%-20s" % env + "".join(
+            "%16s" % ("%d" % t[c] if c in t else "-") for c in colonnes))
+        if i:
+            print("%-20s" % "" + "".join(
+                "%16s" % ecart(t.get(c), reference.get(c)) for c in colonnes))
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    p.add_argument("envs", nargs="*", default=PROFILS, help="environnements platformio.ini")
+    p.add_argument("--sans-build", action="store_true",
+                   help="lit les builds existants (.pio/build/ENV), sans flash/RAM de PlatformIO")
+    p.add_argument("--hote", action="store_true",
+                   help="construit pour l'hôte (sans PlatformIO) et chronomètre loop()")
+    p.add_argument("--json", help="écrit aussi les tailles dans ce fichier")
+    args = p.parse_args()
+
+    if args.hote:
+        u8g2 = os.environ.get("U8G2_SRC", ".pio/libdeps/seeed_xiao_esp32c3/U8g2/src")
+        if not os.path.exists(os.path.join(RACINE, u8g2, "clib", "u8g2.h")):
+            raise SystemExit("U8g2 introuvable dans %s (pio pkg install, ou U8G2_SRC=...)" % u8g2)
+        tailles = [(env, mesure_hote(env, u8g2)) for env in args.envs]
+    else:
+        tailles = [(env, mesure(env, not args.sans_build)) for env in args.envs]
+    affiche(tailles)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(dict(tailles), f, indent=2)
+
+
+if __name__ == "__main__":
+    main()